@@ -0,0 +1,186 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EDAMER_DETAIL_BUFFER_IMPL_HPP
+#define EDAMER_DETAIL_BUFFER_IMPL_HPP
+
+#include "fwd.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <cstdint>
+#include <El.hpp>
+#include <memory>
+#include <pybind11/pybind11.h>
+#include <type_traits>
+#include <vector>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace py = pybind11;
+EDAMER_NAMESPACE_BEGIN(detail)
+
+/* Describe the buffer of a matrix with the given shape and strides (in elements) for the Python buffer protocol */
+template<typename Ring>
+py::buffer_info
+make_buffer_info(El::Matrix<Ring> & matrix, std::vector<py::ssize_t> shape, std::vector<py::ssize_t> strides) {
+	for (auto & stride : strides) {
+		stride *= static_cast<py::ssize_t>(sizeof(Ring));
+	}
+	
+	void * buf_ptr = matrix.Locked()
+		? const_cast<void*>(static_cast<void const*>(matrix.LockedBuffer()))
+		  /* is safe because the buffer is marked as readonly */
+		: static_cast<void*>(matrix.Buffer());
+	
+	auto ndim = static_cast<py::ssize_t>(shape.size());
+	return py::buffer_info(
+		buf_ptr,                               /* Pointer to buffer */
+		sizeof(Ring),                          /* Size of one scalar */
+		py::format_descriptor<Ring>::format(), /* Python struct-style format descriptor */
+		ndim,                                  /* Number of dimensions */
+		std::move(shape),                      /* Buffer dimensions */
+		std::move(strides),                    /* Strides (in bytes) for each index */
+		matrix.Locked()                        /* Buffer is readonly */
+	);
+}
+
+/* ABI-compatible definitions of DLPack's DLDevice, DLDataType, DLTensor and DLManagedTensor (dlpack.h, v0.8). They are
+ * replicated here to avoid a dependency on the DLPack headers for a handful of plain structs.
+ *
+ * Ref.: https://github.com/dmlc/dlpack/blob/main/include/dlpack/dlpack.h
+ */
+struct dl_device {
+	std::int32_t device_type;
+	std::int32_t device_id;
+};
+
+struct dl_data_type {
+	std::uint8_t code;
+	std::uint8_t bits;
+	std::uint16_t lanes;
+};
+
+struct dl_tensor {
+	void * data;
+	dl_device device;
+	std::int32_t ndim;
+	dl_data_type dtype;
+	std::int64_t * shape;
+	std::int64_t * strides;
+	std::uint64_t byte_offset;
+};
+
+struct dl_managed_tensor {
+	detail::dl_tensor dl_tensor;
+	void * manager_ctx;
+	void (*deleter)(dl_managed_tensor * self);
+};
+
+constexpr std::int32_t dl_device_cpu = 1;
+
+template<typename Ring>
+constexpr dl_data_type
+make_dl_data_type() {
+	constexpr std::uint8_t dl_int = 0, dl_uint = 1, dl_float = 2, dl_complex = 5;
+	constexpr auto bits = static_cast<std::uint8_t>(sizeof(Ring) * 8);
+	
+	if constexpr (El::IsComplex<Ring>::value) {
+		return { dl_complex, bits, 1 };
+	} else if constexpr (std::is_floating_point_v<Ring>) {
+		return { dl_float, bits, 1 };
+	} else {
+		static_assert(std::is_integral_v<Ring>, "Only integral, floating point and complex rings are supported");
+		return { std::is_signed_v<Ring> ? dl_int : dl_uint, bits, 1 };
+	}
+}
+
+/* Owns the shape and strides of an exported tensor and keeps the exporting Python object alive until the consumer
+ * calls the deleter.
+ */
+struct dl_managed_context {
+	dl_managed_tensor tensor;
+	std::vector<std::int64_t> shape;
+	std::vector<std::int64_t> strides;
+	py::object owner;
+};
+
+inline void
+delete_dl_managed_tensor(dl_managed_tensor * self) {
+	// consumers may call the deleter without holding the GIL, but releasing owner requires it
+	py::gil_scoped_acquire gil;
+	delete static_cast<dl_managed_context*>(self->manager_ctx);
+}
+
+inline void
+delete_dlpack_capsule(PyObject * capsule) {
+	// a consumer renames the capsule to "used_dltensor" once it took ownership of the tensor
+	if (PyCapsule_IsValid(capsule, "dltensor")) {
+		auto tensor = static_cast<dl_managed_tensor*>(PyCapsule_GetPointer(capsule, "dltensor"));
+		tensor->deleter(tensor);
+	}
+}
+
+/* Export the buffer of a matrix with the given shape and strides (in elements) as DLPack capsule for __dlpack__().
+ * DLPack cannot signal readonly data, so locked matrices are rejected like NumPy does for readonly arrays.
+ */
+template<typename Ring>
+py::capsule
+make_dlpack_capsule(
+	El::Matrix<Ring> & matrix,
+	std::vector<py::ssize_t> const& shape,
+	std::vector<py::ssize_t> const& strides,
+	py::handle owner
+) {
+	if (matrix.Locked()) {
+		throw py::buffer_error{"Cannot export readonly matrix since DLPack does not support readonly tensors"};
+	}
+	
+	auto ctx = std::make_unique<dl_managed_context>();
+	ctx->shape.assign(shape.begin(), shape.end());
+	ctx->strides.assign(strides.begin(), strides.end());
+	ctx->owner = py::reinterpret_borrow<py::object>(owner);
+	
+	auto & tensor = ctx->tensor;
+	tensor.dl_tensor.data = static_cast<void*>(matrix.Buffer());
+	tensor.dl_tensor.device = { dl_device_cpu, 0 };
+	tensor.dl_tensor.ndim = static_cast<std::int32_t>(ctx->shape.size());
+	tensor.dl_tensor.dtype = make_dl_data_type<Ring>();
+	tensor.dl_tensor.shape = ctx->shape.data();
+	tensor.dl_tensor.strides = ctx->strides.data();
+	tensor.dl_tensor.byte_offset = 0;
+	tensor.manager_ctx = ctx.get();
+	tensor.deleter = &delete_dl_managed_tensor;
+	
+	PyObject * capsule = PyCapsule_New(&tensor, "dltensor", &delete_dlpack_capsule);
+	if (!capsule) {
+		throw py::error_already_set{};
+	}
+	
+	ctx.release();
+	return py::reinterpret_steal<py::capsule>(capsule);
+}
+
+/* Device tuple returned by __dlpack_device__(), i.e. (kDLCPU, 0) because Elemental matrices reside in host memory */
+inline py::tuple
+dlpack_device() {
+	return py::make_tuple(dl_device_cpu, 0);
+}
+
+EDAMER_NAMESPACE_END(detail)
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DETAIL_BUFFER_IMPL_HPP
@@ -0,0 +1,385 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EDAMER_DETAIL_ELEMENTAL_IMPL_HPP
+#define EDAMER_DETAIL_ELEMENTAL_IMPL_HPP
+
+#include "fwd.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <boost/hana/first.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/pair.hpp>
+#include <boost/hana/second.hpp>
+#include <boost/hana/tuple.hpp>
+#include <boost/throw_exception.hpp>
+#include <cmath>
+#include <cstddef>
+#include <edamer/detail/simd.hpp>
+#include <edamer/dt/exception.hpp>
+#include <El.hpp>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mpi.h>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace hana = boost::hana;
+EDAMER_NAMESPACE_BEGIN(detail)
+
+template<typename Ring>
+struct el_ring<El::Matrix<Ring>> {
+	using type = Ring;
+};
+
+template<typename Ring, El::Dist Columnwise, El::Dist Rowwise, El::DistWrap Wrapping>
+struct el_ring<El::DistMatrix<Ring, Columnwise, Rowwise, Wrapping>> {
+	using type = Ring;
+};
+
+template<typename Matrix>
+using el_ring_t = typename el_ring<std::decay_t<Matrix>>::type;
+
+/* Return an empty matrix of the same kind as the argument, i.e. a El::Matrix<> for non-distributed matrices and a
+ * El::DistMatrix<> with [MC,MR] distribution on the same grid for distributed matrices.
+ */
+template<typename Ring, typename T>
+El::Matrix<Ring>
+make_el_workspace(El::Matrix<T> const&) {
+	return El::Matrix<Ring>{};
+}
+
+template<typename Ring, typename T>
+El::DistMatrix<Ring>
+make_el_workspace(El::AbstractDistMatrix<T> const& a) {
+	return El::DistMatrix<Ring>{a.Grid()};
+}
+
+/* Column means as a column vector, i.e. a' * ones(m,1) / m */
+template<typename Matrix>
+auto
+column_means(Matrix const& a) {
+	using ring_t = el_ring_t<Matrix>;
+	
+	auto means = make_el_workspace<ring_t>(a);
+	El::Zeros(means, a.Width(), 1);
+	
+	if (a.Height() > 0) {
+		auto ones = make_el_workspace<ring_t>(a);
+		El::Ones(ones, a.Height(), 1);
+		El::Gemv(El::TRANSPOSE, ring_t(1) / ring_t(a.Height()), a, ones, ring_t(0), means);
+	}
+	return means;
+}
+
+/* Subtract column vector means from each row of a, i.e. a := a - ones(m,1) * means' */
+template<typename Ring>
+void
+center_columns(El::Matrix<Ring> & a, El::Matrix<Ring> const& means) {
+	El::Matrix<Ring> ones;
+	El::Ones(ones, a.Height(), 1);
+	El::Geru(Ring(-1), ones, means, a);
+}
+
+/* Like above, but the small vector means is replicated and each process updates its local entries, i.e. a is never
+ * redistributed, which El::Geru would do for other distributions than [MC,MR]
+ */
+template<typename Ring>
+void
+center_columns(El::AbstractDistMatrix<Ring> & a, El::AbstractDistMatrix<Ring> const& means) {
+	El::DistMatrix<Ring, El::STAR, El::STAR> all{means};
+	El::Matrix<Ring> & local = a.Matrix();
+	
+	for (El::Int j = 0; j < local.Width(); ++j) {
+		Ring const mean = all.GetLocal(a.GlobalCol(j), 0);
+		Ring * column = local.Buffer(0, j);
+		for (El::Int i = 0; i < local.Height(); ++i) {
+			column[i] -= mean;
+		}
+	}
+}
+
+/* Turn singular values s of a centered mxn matrix into principal component variances, i.e. s := s.^2/(m-1) */
+template<typename Vector>
+void
+singular_values_to_variances(Vector & s, El::Int m) {
+	using ring_t = el_ring_t<Vector>;
+	
+	ring_t const dof = ring_t(std::max<El::Int>(m - 1, 1));
+	El::EntrywiseMap(s, std::function<ring_t(ring_t const&)>(
+		[dof](ring_t const& v) { return v * v / dof; }));
+}
+
+/* Number of observations, mean and sum of squared deviations from the mean of a sequence of values. Values are added
+ * with Welford's update and partial moments are merged with the pairwise formula of Chan et al., hence the moments are
+ * computed in a single pass and without the cancellation of the textbook formula sum(x.^2)/n - mean(x)^2. All moments
+ * are accumulated in double precision regardless of the ring of the values.
+ *
+ * Ref.: T. F. Chan, G. H. Golub, R. J. LeVeque. Algorithms for Computing the Sample Variance: Analysis and
+ *       Recommendations. The American Statistician, 37(3), 1983.
+ */
+struct welford_moments {
+	double count = 0;
+	double mean = 0;
+	double m2 = 0;
+	
+	void
+	add(double x) {
+		count += 1;
+		double const delta = x - mean;
+		mean += delta / count;
+		m2 += delta * (x - mean);
+	}
+	
+	void
+	merge(welford_moments const& o) {
+		if (o.count == 0) {
+			return;
+		}
+		
+		double const total = count + o.count;
+		double const delta = o.mean - mean;
+		mean += delta * o.count / total;
+		m2 += o.m2 + delta * delta * count * o.count / total;
+		count = total;
+	}
+	
+	/* MATLAB's var(x,w), i.e. normalized by n-1 if w is 0 and by n if w is 1 */
+	double
+	variance(int w) const {
+		if (count == 0) {
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+		return w == 0 ? (count > 1 ? m2 / (count - 1) : 0.) : m2 / count;
+	}
+};
+
+// moments are exchanged with MPI as three consecutive doubles
+static_assert(sizeof(welford_moments) == 3 * sizeof(double));
+
+/* Add the entries of a local matrix to the moments of the columns (dim == 1) or rows (dim == 2) they belong to, i.e.
+ * moments has an entry for each local column or row. The matrix is traversed in memory order once.
+ */
+template<typename Ring>
+void
+accumulate_moments(El::Matrix<Ring> const& a, El::Int dim, std::vector<welford_moments> & moments) {
+	Ring const* buffer = a.LockedBuffer();
+	El::Int const ldim = a.LDim();
+	
+	for (El::Int j = 0; j < a.Width(); ++j) {
+		Ring const* column = buffer + j * ldim;
+		if (dim == 1) {
+			welford_moments & acc = moments[j];
+			if constexpr (is_simd_ring_v<Ring>) {
+				// moments of the local column in one vectorized pass, merged like partial moments of other processes
+				if (a.Height() > 0) {
+					welford_moments column_moments;
+					column_moments.count = static_cast<double>(a.Height());
+					simd_moments(a.Height(), column, column_moments.mean, column_moments.m2);
+					acc.merge(column_moments);
+				}
+			} else {
+				for (El::Int i = 0; i < a.Height(); ++i) {
+					acc.add(static_cast<double>(column[i]));
+				}
+			}
+		} else {
+			for (El::Int i = 0; i < a.Height(); ++i) {
+				moments[i].add(static_cast<double>(column[i]));
+			}
+		}
+	}
+}
+
+/* Moments of each column (dim == 1) or row (dim == 2) of a */
+template<typename Ring>
+std::vector<welford_moments>
+moments_along(El::Matrix<Ring> const& a, El::Int dim) {
+	std::vector<welford_moments> moments(dim == 1 ? a.Width() : a.Height());
+	accumulate_moments(a, dim, moments);
+	return moments;
+}
+
+template<El::Dist Distribution>
+using el_dist_c = std::integral_constant<El::Dist, Distribution>;
+
+/* Empty El::DistMatrix with scalar type Ring on the grid of a, whose matrix distribution is given at runtime, i.e. one
+ * of Elemental's element-wise distributions, unlike el_matrix_distributions which can be restricted at build time
+ */
+template<typename Ring, typename T>
+std::unique_ptr<El::AbstractDistMatrix<Ring>>
+make_el_dist_workspace_like(El::AbstractDistMatrix<T> const& a) {
+	std::unique_ptr<El::AbstractDistMatrix<Ring>> b;
+	
+	hana::for_each(
+		hana::make_tuple(
+			hana::make_pair(el_dist_c<El::CIRC>{}, el_dist_c<El::CIRC>{}),
+			hana::make_pair(el_dist_c<El::MC>{},   el_dist_c<El::MR>{}),
+			hana::make_pair(el_dist_c<El::MC>{},   el_dist_c<El::STAR>{}),
+			hana::make_pair(el_dist_c<El::MD>{},   el_dist_c<El::STAR>{}),
+			hana::make_pair(el_dist_c<El::MR>{},   el_dist_c<El::MC>{}),
+			hana::make_pair(el_dist_c<El::MR>{},   el_dist_c<El::STAR>{}),
+			hana::make_pair(el_dist_c<El::STAR>{}, el_dist_c<El::MC>{}),
+			hana::make_pair(el_dist_c<El::STAR>{}, el_dist_c<El::MD>{}),
+			hana::make_pair(el_dist_c<El::STAR>{}, el_dist_c<El::MR>{}),
+			hana::make_pair(el_dist_c<El::STAR>{}, el_dist_c<El::STAR>{}),
+			hana::make_pair(el_dist_c<El::STAR>{}, el_dist_c<El::VC>{}),
+			hana::make_pair(el_dist_c<El::STAR>{}, el_dist_c<El::VR>{}),
+			hana::make_pair(el_dist_c<El::VC>{},   el_dist_c<El::STAR>{}),
+			hana::make_pair(el_dist_c<El::VR>{},   el_dist_c<El::STAR>{})
+		),
+		[&](auto distribution) {
+			using columnwise_t = std::decay_t<decltype(hana::first(distribution))>;
+			using rowwise_t = std::decay_t<decltype(hana::second(distribution))>;
+			
+			if (!b && a.ColDist() == columnwise_t::value && a.RowDist() == rowwise_t::value) {
+				b = std::make_unique<El::DistMatrix<Ring, columnwise_t::value, rowwise_t::value>>(a.Grid(), a.Root());
+			}
+		}
+	);
+	
+	BOOST_ASSERT(b);
+	return b;
+}
+
+/* Moments of the columns (dim == 1) or rows (dim == 2) of a distributed matrix a which are stored on this process,
+ * see moments_along(). Their statistics are written to values, which is a 1xn or mx1 matrix whose entries are
+ * distributed like the columns or rows of a, before they are redistributed by assign_moments().
+ */
+struct el_dist_moments {
+	std::vector<welford_moments> local;
+	std::unique_ptr<El::AbstractDistMatrix<double>> values;
+};
+
+/* Convert counts of entries, e.g. sent to each process of comm, to the int counts of MPI. Counts and their sum, i.e.
+ * the largest displacement, must not exceed INT_MAX. This is checked collectively, i.e. all processes throw if the
+ * counts of any process are too large, hence no process is left waiting in a collective which the others never enter.
+ */
+inline std::vector<int>
+mpi_counts(std::vector<El::Int> const& counts, El::mpi::Comm const& comm) {
+	El::Int const total = std::accumulate(counts.begin(), counts.end(), El::Int{0});
+	El::Int const largest = El::mpi::AllReduce(total, El::mpi::MAX, comm);
+	if (largest > std::numeric_limits<int>::max()) {
+		BOOST_THROW_EXCEPTION((mpi_count_overflow_exception{} << errinfo_mpi_count{largest}));
+	}
+	return std::vector<int>(counts.begin(), counts.end());
+}
+
+/* Merge partial moments of all processes of comm in place, in chunks because MPI counts are ints */
+inline void
+allreduce_moments(std::vector<welford_moments> & moments, El::mpi::Comm const& comm) {
+	MPI_Datatype type;
+	MPI_Type_contiguous(3, MPI_DOUBLE, &type);
+	MPI_Type_commit(&type);
+	
+	MPI_Op op;
+	MPI_Op_create(
+		[](void * in, void * inout, int * len, MPI_Datatype *) {
+			auto const* from = static_cast<welford_moments const*>(in);
+			auto * to = static_cast<welford_moments *>(inout);
+			for (int i = 0; i < *len; ++i) {
+				to[i].merge(from[i]);
+			}
+		},
+		/* commute */ 1,
+		&op);
+	
+	std::size_t const chunk = static_cast<std::size_t>(std::numeric_limits<int>::max());
+	for (std::size_t i = 0; i < moments.size(); i += chunk) {
+		int const count = static_cast<int>(std::min(chunk, moments.size() - i));
+		MPI_Allreduce(MPI_IN_PLACE, moments.data() + i, count, type, op, comm.comm);
+	}
+	
+	MPI_Op_free(&op);
+	MPI_Type_free(&type);
+}
+
+/* Moments of each column (dim == 1) or row (dim == 2) of a distributed matrix. Each process accumulates its local
+ * entries and the partial moments of its local columns or rows are merged with an allreduce among the processes which
+ * share them, i.e. over ColComm or RowComm. Hence memory and communication are proportional to the local width or
+ * height instead of the global one. Redundant copies of a compute the same moments independently.
+ */
+template<typename Ring>
+el_dist_moments
+moments_along(El::AbstractDistMatrix<Ring> const& a, El::Int dim) {
+	el_dist_moments moments;
+	moments.local.resize(dim == 1 ? a.LocalWidth() : a.LocalHeight());
+	
+	moments.values = make_el_dist_workspace_like<double>(a);
+	if (dim == 1) {
+		moments.values->AlignRowsWith(a.DistData());
+		moments.values->Resize(1, a.Width());
+	} else {
+		moments.values->AlignColsWith(a.DistData());
+		moments.values->Resize(a.Height(), 1);
+	}
+	
+	if (a.Participating()) {
+		accumulate_moments(a.LockedMatrix(), dim, moments.local);
+		
+		if ((dim == 1 ? a.ColStride() : a.RowStride()) > 1) {
+			allreduce_moments(moments.local, dim == 1 ? a.ColComm() : a.RowComm());
+		}
+	}
+	return moments;
+}
+
+/* Set each entry of the preallocated vector v to f(moments[k]) where k is the global index of the entry */
+template<typename Ring, typename F>
+void
+assign_moments(El::Matrix<Ring> & v, std::vector<welford_moments> const& moments, F && f) {
+	for (El::Int j = 0; j < v.Width(); ++j) {
+		for (El::Int i = 0; i < v.Height(); ++i) {
+			v.Set(i, j, static_cast<Ring>(f(moments[i + j])));
+		}
+	}
+}
+
+/* Like above, but v is a distributed row or column vector whose entries are f(moments) of the columns or rows of the
+ * matrix which moments_along() has been called for. v is redistributed from the processes which store the moments.
+ */
+template<typename Ring, typename F>
+void
+assign_moments(El::AbstractDistMatrix<Ring> & v, el_dist_moments const& moments, F && f) {
+	El::AbstractDistMatrix<double> & values = *moments.values;
+	El::Matrix<double> & local = values.Matrix();
+	for (El::Int j = 0; j < local.Width(); ++j) {
+		for (El::Int i = 0; i < local.Height(); ++i) {
+			// either i or j is zero
+			local.Set(i, j, static_cast<double>(f(moments.local[i + j])));
+		}
+	}
+	
+	if (v.Height() == values.Height() && v.Width() == values.Width()) {
+		El::Copy(values, v);
+	} else {
+		El::DistMatrix<double> transposed{values.Grid()};
+		El::Transpose(values, transposed);
+		El::Copy(transposed, v);
+	}
+}
+
+EDAMER_NAMESPACE_END(detail)
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DETAIL_ELEMENTAL_IMPL_HPP
@@ -0,0 +1,48 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EDAMER_DETAIL_ELEMENTWISE_FWD_HPP
+#define EDAMER_DETAIL_ELEMENTWISE_FWD_HPP
+
+#include <edamer/config.hpp>
+#include <hbrs/mpl/config.hpp>
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+EDAMER_NAMESPACE_BEGIN(detail)
+
+/* Elementwise functions with MATLAB's implicit expansion, i.e. scalars, row and column vectors and expansions of
+ * distributed vectors are broadcast against matrices. Chains of elementwise functions are evaluated as a program in a
+ * single loop over the local matrix of each process without materializing any expanded operand or intermediate result.
+ */
+
+enum class elementwise_op { plus, minus, times, rdivide, power, eq, ne, lt, le, gt, ge };
+
+struct elementwise_instruction;
+
+template<typename Ring>
+struct elementwise_source;
+
+template<typename Ring>
+struct elementwise_operand;
+
+EDAMER_NAMESPACE_END(detail)
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DETAIL_ELEMENTWISE_FWD_HPP
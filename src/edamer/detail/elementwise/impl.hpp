@@ -0,0 +1,678 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EDAMER_DETAIL_ELEMENTWISE_IMPL_HPP
+#define EDAMER_DETAIL_ELEMENTWISE_IMPL_HPP
+
+#include "fwd.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <algorithm>
+#include <array>
+#include <boost/hana/at.hpp>
+#include <boost/hana/concat.hpp>
+#include <boost/hana/first.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/transform.hpp>
+#include <boost/hana/tuple.hpp>
+#include <boost/hana/type.hpp>
+#include <boost/throw_exception.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <edamer/detail/pybind11.hpp>
+#include <edamer/detail/scalar.hpp>
+#include <edamer/detail/simd.hpp>
+#include <edamer/dt/el_abstract_dist_matrix.hpp>
+#include <edamer/dt/el_complex.hpp>
+#include <edamer/dt/exception.hpp>
+#include <edamer/dt/matrix_distribution.hpp>
+#include <El.hpp>
+#include <functional>
+#include <hbrs/mpl/dt/el_dist_vector.hpp>
+#include <hbrs/mpl/dt/el_matrix.hpp>
+#include <hbrs/mpl/dt/el_vector.hpp>
+#include <hbrs/mpl/dt/exception.hpp>
+#include <hbrs/mpl/dt/expression.hpp>
+#include <hbrs/mpl/dt/matrix_size.hpp>
+#include <hbrs/mpl/fn/expand.hpp>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace hana = boost::hana;
+namespace mpl = hbrs::mpl;
+EDAMER_NAMESPACE_BEGIN(detail)
+
+/* Operand of an elementwise function before a result has been allocated, i.e. a scalar, a local matrix or vector, a
+ * distributed matrix or vector or an expansion of a distributed vector. height and width are the size of the operand
+ * after expansion, entries are broadcast along dimensions in which the data has a single row or column.
+ */
+template<typename Ring>
+struct elementwise_source {
+	Ring scalar{};
+	El::Matrix<Ring> const* local = nullptr;
+	El::AbstractDistMatrix<Ring> const* dist = nullptr;
+	std::optional<el_abstract_dist_matrix<Ring>> view; // keeps views of typed distributed matrices alive
+	El::Int height = 1;
+	El::Int width = 1;
+	bool expanded = false;
+	bool abstract = false;
+	
+	bool
+	is_scalar() const { return local == nullptr && dist == nullptr; }
+};
+
+/* Operand bound to the local matrix of a result, its entry for local index (i, j) of the result is
+ * buffer[i * row_stride + j * col_stride]. Strides are zero along broadcast dimensions.
+ */
+template<typename Ring>
+struct elementwise_operand {
+	Ring const* buffer;
+	El::Int row_stride;
+	El::Int col_stride;
+};
+
+/* Convert obj to an operand of ring Ring or return std::nullopt if obj is of another ring or type */
+template<typename Ring>
+std::optional<elementwise_source<Ring>>
+make_elementwise_source(py::handle obj) {
+	elementwise_source<Ring> s;
+	
+	if (py::isinstance<mpl::el_matrix<Ring>>(obj)) {
+		s.local = &py::cast<mpl::el_matrix<Ring> const&>(obj).data();
+	} else if (py::isinstance<mpl::el_row_vector<Ring>>(obj)) {
+		s.local = &py::cast<mpl::el_row_vector<Ring> const&>(obj).data();
+	} else if (py::isinstance<mpl::el_column_vector<Ring>>(obj)) {
+		s.local = &py::cast<mpl::el_column_vector<Ring> const&>(obj).data();
+	} else if (py::isinstance<el_abstract_dist_matrix<Ring>>(obj)) {
+		s.view = py::cast<el_abstract_dist_matrix<Ring>>(obj);
+		s.abstract = true;
+	} else if (py::hasattr(obj, "abstract")) {
+		py::object view = obj.attr("abstract")();
+		if (!py::isinstance<el_abstract_dist_matrix<Ring>>(view)) {
+			// e.g. typed matrices of other rings or lazy transposes
+			return std::nullopt;
+		}
+		s.view = py::cast<el_abstract_dist_matrix<Ring>>(view);
+	} else {
+		hana::for_each(el_matrix_distributions, [&obj, &s](auto distribution_tn) {
+			auto dist_ts = hana::transform(distribution_tn, hana::first);
+			
+			using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
+			using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
+			using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
+			
+			using row_vector_t = mpl::el_dist_row_vector<
+				Ring, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
+			using column_vector_t = mpl::el_dist_column_vector<
+				Ring, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
+			
+			auto from_vector = [&obj, &s](auto vector_c) {
+				using vector_t = typename decltype(vector_c)::type;
+				using expression_t = mpl::expression<
+					mpl::expand_t,
+					hana::tuple<vector_t const&, mpl::matrix_size<El::Int, El::Int> const&>
+				>;
+				
+				if (s.dist != nullptr) {
+					return;
+				} else if (py::isinstance<vector_t>(obj)) {
+					s.dist = &py::cast<vector_t const&>(obj).data();
+				} else if (py::isinstance<expression_t>(obj)) {
+					auto & expression = py::cast<expression_t &>(obj);
+					auto const& size = hana::at_c<1>(expression.operands());
+					s.dist = &hana::at_c<0>(expression.operands()).data();
+					s.height = size.m();
+					s.width = size.n();
+					s.expanded = true;
+				}
+			};
+			
+			from_vector(hana::type_c<row_vector_t>);
+			from_vector(hana::type_c<column_vector_t>);
+		});
+		
+		if (s.dist == nullptr) {
+			py::detail::make_caster<Ring> scalar;
+			if (!scalar.load(obj, /* convert */ true)) {
+				return std::nullopt;
+			}
+			s.scalar = py::detail::cast_op<Ring>(scalar);
+		}
+	}
+	
+	if (s.view) {
+		s.dist = &s.view->data();
+	}
+	
+	if (s.local != nullptr) {
+		s.height = s.local->Height();
+		s.width = s.local->Width();
+	} else if (s.dist != nullptr && !s.expanded) {
+		s.height = s.dist->Height();
+		s.width = s.dist->Width();
+	} else if (s.expanded) {
+		El::Int const height = s.dist->Height();
+		El::Int const width = s.dist->Width();
+		if ((height != 1 && height != s.height) || (width != 1 && width != s.width)) {
+			BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{}
+				<< mpl::errinfo_el_matrix_size{{height, width}}));
+		}
+	}
+	return s;
+}
+
+/* Instruction of a fused elementwise program. lhs and rhs index the operands of the program followed by the results of
+ * all preceding instructions, the result of the last instruction is the result of the program.
+ */
+struct elementwise_instruction {
+	elementwise_op op;
+	std::size_t lhs;
+	std::size_t rhs;
+};
+
+/* Like MATLAB's arithmetic on integers, sums, differences and products of integral rings saturate at the limits of the
+ * ring instead of overflowing, e.g. the largest integer plus 1 is the largest integer. Integers of at most 32 bits are
+ * computed exactly in 64 bits before saturating.
+ */
+template<typename F>
+struct elementwise_saturating {
+	template<typename T>
+	auto
+	operator()(T const& x, T const& y) const {
+		if constexpr (std::is_integral_v<T>) {
+			static_assert(sizeof(T) <= 4, "sums and products of wider integers do not fit into 64 bits");
+			using limits = std::numeric_limits<T>;
+			
+			std::int64_t const r = F{}(static_cast<std::int64_t>(x), static_cast<std::int64_t>(y));
+			return static_cast<T>(std::clamp<std::int64_t>(r, limits::min(), limits::max()));
+		} else {
+			return F{}(x, y);
+		}
+	}
+};
+
+using elementwise_plus = elementwise_saturating<std::plus<>>;
+using elementwise_minus = elementwise_saturating<std::minus<>>;
+using elementwise_times = elementwise_saturating<std::multiplies<>>;
+
+template<>
+struct simd_op_of<elementwise_plus> : std::integral_constant<simd_op, simd_op::plus> {};
+
+template<>
+struct simd_op_of<elementwise_minus> : std::integral_constant<simd_op, simd_op::minus> {};
+
+template<>
+struct simd_op_of<elementwise_times> : std::integral_constant<simd_op, simd_op::times> {};
+
+/* Like MATLAB's, powers of integral rings are computed in double, rounded to the nearest integer, ties away from zero,
+ * and saturate at the limits of the ring, e.g. 2^-1 is 1, 2^-2 is 0, 2^31 is the largest and 0^-1 the largest integer.
+ * Casting an out-of-range double to an integer would be undefined behaviour instead.
+ */
+struct elementwise_power {
+	template<typename T>
+	auto
+	operator()(T const& x, T const& y) const {
+		if constexpr (std::is_integral_v<T>) {
+			using limits = std::numeric_limits<T>;
+			
+			double const p = std::round(std::pow(static_cast<double>(x), static_cast<double>(y)));
+			double const lowest = static_cast<double>(limits::min());
+			double const highest = static_cast<double>(limits::max());
+			return static_cast<T>(std::clamp(p, lowest, highest));
+		} else {
+			return std::pow(x, y);
+		}
+	}
+};
+
+/* Like MATLAB's division of integers, quotients of integral rings are rounded to the nearest integer, ties away from
+ * zero, and saturate instead of trapping, i.e. x/0 is the largest or smallest integer depending on the sign of x, 0/0
+ * is 0 and the smallest integer divided by -1 is the largest integer. Integers of at most 32 bits and ties of their
+ * quotients are exact in double, hence rounding the correctly rounded double quotient gives the exact result.
+ */
+struct elementwise_rdivide {
+	template<typename T>
+	auto
+	operator()(T const& x, T const& y) const {
+		if constexpr (std::is_integral_v<T>) {
+			static_assert(sizeof(T) <= 4, "quotients of wider integers are not exact in double");
+			using limits = std::numeric_limits<T>;
+			
+			if (y == 0) {
+				return x == 0 ? T(0) : (x > 0 ? limits::max() : limits::min());
+			}
+			
+			double const q = std::round(static_cast<double>(x) / static_cast<double>(y));
+			double const lowest = static_cast<double>(limits::min());
+			double const highest = static_cast<double>(limits::max());
+			return static_cast<T>(std::clamp(q, lowest, highest));
+		} else {
+			return x / y;
+		}
+	}
+};
+
+template<>
+struct simd_op_of<elementwise_rdivide> : std::integral_constant<simd_op, simd_op::rdivide> {};
+
+/* Call v with the function object of op */
+template<typename Visitor>
+decltype(auto)
+visit_elementwise_op(elementwise_op op, Visitor && v) {
+	switch (op) {
+		case elementwise_op::plus:    return v(elementwise_plus{});
+		case elementwise_op::minus:   return v(elementwise_minus{});
+		case elementwise_op::times:   return v(elementwise_times{});
+		case elementwise_op::rdivide: return v(elementwise_rdivide{});
+		case elementwise_op::power:   return v(elementwise_power{});
+		case elementwise_op::eq:      return v(std::equal_to<>{});
+		case elementwise_op::ne:      return v(std::not_equal_to<>{});
+		case elementwise_op::lt:      return v(std::less<>{});
+		case elementwise_op::le:      return v(std::less_equal<>{});
+		case elementwise_op::gt:      return v(std::greater<>{});
+		case elementwise_op::ge:      return v(std::greater_equal<>{});
+	}
+	throw py::value_error{"unknown elementwise function"};
+}
+
+/* Parse the name of an elementwise function of edamer.fn, e.g. "plus" or "rdivide" */
+inline elementwise_op
+make_elementwise_op(std::string const& name) {
+	static std::array<std::pair<char const*, elementwise_op>, 11> const ops = {{
+		{ "plus", elementwise_op::plus }, { "minus", elementwise_op::minus }, { "times", elementwise_op::times },
+		{ "rdivide", elementwise_op::rdivide }, { "power", elementwise_op::power }, { "eq", elementwise_op::eq },
+		{ "ne", elementwise_op::ne }, { "lt", elementwise_op::lt }, { "le", elementwise_op::le },
+		{ "gt", elementwise_op::gt }, { "ge", elementwise_op::ge }
+	}};
+	
+	for (auto const& op : ops) {
+		if (name == op.first) {
+			return op.second;
+		}
+	}
+	throw py::value_error{"unknown elementwise function " + name};
+}
+
+/* Whether op is defined for ring Ring, e.g. orderings are undefined for complex rings */
+template<typename Ring>
+bool
+elementwise_op_supported(elementwise_op op) {
+	return visit_elementwise_op(op, [](auto f) {
+		return std::is_invocable_v<decltype(f) const&, Ring const&, Ring const&>;
+	});
+}
+
+inline void
+check_elementwise_program(std::vector<elementwise_instruction> const& program, std::size_t operands) {
+	if (program.empty()) {
+		throw py::value_error{"elementwise program must have at least one instruction"};
+	}
+	
+	for (std::size_t k = 0; k < program.size(); ++k) {
+		if (program[k].lhs >= operands + k || program[k].rhs >= operands + k) {
+			throw py::value_error{"elementwise instruction " + std::to_string(k) + " refers to an undefined value"};
+		}
+	}
+}
+
+/* Size of the result with MATLAB's implicit expansion, i.e. sizes of all operands must agree in each dimension unless
+ * they are 1 in this dimension
+ */
+template<typename Ring>
+std::pair<El::Int, El::Int>
+broadcast_size(std::vector<elementwise_source<Ring>> const& sources) {
+	El::Int height = 1;
+	El::Int width = 1;
+	
+	for (auto const& s : sources) {
+		if ((height != 1 && s.height != 1 && height != s.height) || (width != 1 && s.width != 1 && width != s.width)) {
+			BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{}
+				<< mpl::errinfo_el_matrix_size{{s.height, s.width}}));
+		}
+		height = height == 1 ? s.height : height;
+		width = width == 1 ? s.width : width;
+	}
+	return { height, width };
+}
+
+inline void
+check_elementwise_size(El::Int height, El::Int width, El::Int out_height, El::Int out_width) {
+	if (height != out_height || width != out_width) {
+		BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{}
+			<< mpl::errinfo_el_matrix_size{{out_height, out_width}}));
+	}
+}
+
+template<typename Ring>
+elementwise_operand<Ring>
+bind_elementwise_operand(elementwise_source<Ring> const& s) {
+	if (s.is_scalar()) {
+		return { &s.scalar, 0, 0 };
+	}
+	
+	El::Matrix<Ring> const& a = *s.local;
+	return { a.LockedBuffer(), a.Height() == 1 ? 0 : 1, a.Width() == 1 ? 0 : a.LDim() };
+}
+
+template<typename Ring>
+bool
+aligned_with(El::AbstractDistMatrix<Ring> const& x, El::AbstractDistMatrix<Ring> const& y) {
+	return x.Grid() == y.Grid() && x.ColDist() == y.ColDist() && x.RowDist() == y.RowDist() &&
+		x.Wrap() == y.Wrap() && x.ColAlign() == y.ColAlign() && x.RowAlign() == y.RowAlign() &&
+		x.Root() == y.Root();
+}
+
+/* Bind an operand to the local matrix of a distributed result. Operands of the same size and alignment as the result
+ * are read from their local matrices. Other operands of the same size are redistributed to the alignment of the result
+ * first, while broadcast operands, i.e. scalars and vectors, are replicated as [STAR,STAR] and indexed through the
+ * column and row shifts and strides of the result. Copies are stored in copy and must outlive the operand.
+ */
+template<typename Ring>
+elementwise_operand<Ring>
+bind_elementwise_operand(
+	elementwise_source<Ring> const& s,
+	El::AbstractDistMatrix<Ring> const& out,
+	std::unique_ptr<El::AbstractDistMatrix<Ring>> & copy
+) {
+	if (s.is_scalar()) {
+		return { &s.scalar, 0, 0 };
+	}
+	
+	El::AbstractDistMatrix<Ring> const& a = *s.dist;
+	El::Int const height = a.Height();
+	El::Int const width = a.Width();
+	
+	if (height == out.Height() && width == out.Width()) {
+		if (aligned_with(a, out)) {
+			return { a.LockedBuffer(), 1, a.LDim() };
+		}
+		
+		copy.reset(out.Construct(out.Grid(), out.Root()));
+		copy->AlignWith(out.DistData());
+		El::Copy(a, *copy);
+		return { copy->LockedBuffer(), 1, copy->LDim() };
+	}
+	
+	copy = std::make_unique<El::DistMatrix<Ring, El::STAR, El::STAR>>(a.Grid());
+	El::Copy(a, *copy);
+	if (!out.Participating()) {
+		return { copy->LockedBuffer(), 0, 0 };
+	}
+	
+	El::Int const ldim = copy->LDim();
+	El::Int const row_offset = height == 1 ? 0 : out.ColShift();
+	El::Int const col_offset = width == 1 ? 0 : out.RowShift() * ldim;
+	return {
+		copy->LockedBuffer() + row_offset + col_offset,
+		height == 1 ? 0 : out.ColStride(),
+		width == 1 ? 0 : out.RowStride() * ldim
+	};
+}
+
+/* Compute out[i] = op(a[i * a_stride], b[i * b_stride]) for 0 <= i < n */
+template<typename Ring>
+void
+elementwise_kernel(
+	elementwise_op op,
+	El::Int n,
+	Ring const* a,
+	El::Int a_stride,
+	Ring const* b,
+	El::Int b_stride,
+	Ring * out
+) {
+	visit_elementwise_op(op, [&](auto f) {
+		using f_t = decltype(f);
+		
+		if constexpr (std::is_invocable_v<f_t const&, Ring const&, Ring const&>) {
+			if constexpr (has_simd_binary<Ring, f_t>::value) {
+				// contiguous and broadcast columns, e.g. of aligned operands, scalars and expanded row vectors
+				if (a_stride <= 1 && b_stride <= 1) {
+					simd_binary(simd_op_of<f_t>::value, n, a, a_stride, b, b_stride, out);
+					return;
+				}
+			}
+			
+			for (El::Int i = 0; i < n; ++i) {
+				out[i] = static_cast<Ring>(f(a[i * a_stride], b[i * b_stride]));
+			}
+		}
+	});
+}
+
+/* Evaluate program for all entries of local matrix out in a single pass. Columns are processed in tiles of rows, hence
+ * intermediate results of the program stay in cache and only the last instruction writes to out. Because each entry
+ * of out depends on entries at the same or broadcast positions only, out may be one of the operands.
+ */
+template<typename Ring>
+void
+elementwise_local(
+	std::vector<elementwise_operand<Ring>> const& operands,
+	std::vector<elementwise_instruction> const& program,
+	El::Matrix<Ring> & out
+) {
+	constexpr El::Int tile = 512;
+	El::Int const height = out.Height();
+	El::Int const width = out.Width();
+	std::size_t const n_operands = operands.size();
+	std::vector<Ring> intermediates((program.size() - 1) * tile);
+	
+	for (El::Int j = 0; j < width; ++j) {
+		for (El::Int i = 0; i < height; i += tile) {
+			El::Int const n = std::min(tile, height - i);
+			
+			auto value = [&](std::size_t k) -> std::pair<Ring const*, El::Int> {
+				if (k < n_operands) {
+					auto const& x = operands[k];
+					return { x.buffer + i * x.row_stride + j * x.col_stride, x.row_stride };
+				}
+				return { intermediates.data() + (k - n_operands) * tile, 1 };
+			};
+			
+			for (std::size_t k = 0; k < program.size(); ++k) {
+				auto const a = value(program[k].lhs);
+				auto const b = value(program[k].rhs);
+				Ring * c = k + 1 == program.size() ? out.Buffer(i, j) : intermediates.data() + k * tile;
+				elementwise_kernel(program[k].op, n, a.first, a.second, b.first, b.second, c);
+			}
+		}
+	}
+}
+
+/* Allocate the distributed result of an elementwise function. It shares matrix distribution and alignments with the
+ * first operand of the same size, hence this operand is read without any communication. Else, e.g. if a row and a
+ * column vector are expanded, the result is a [MC,MR] matrix.
+ */
+template<typename Ring>
+el_abstract_dist_matrix<Ring>
+make_elementwise_result(std::vector<elementwise_source<Ring>> const& sources, El::Int height, El::Int width) {
+	El::AbstractDistMatrix<Ring> const* grid_source = nullptr;
+	
+	for (auto const& s : sources) {
+		El::AbstractDistMatrix<Ring> const* x = s.dist;
+		if (x != nullptr && x->Height() == height && x->Width() == width && x->Wrap() == El::ELEMENT) {
+			std::shared_ptr<El::AbstractDistMatrix<Ring>> c{x->Construct(x->Grid(), x->Root())};
+			c->AlignWith(x->DistData());
+			c->Resize(height, width);
+			return el_abstract_dist_matrix<Ring>{std::move(c)};
+		}
+		
+		if (grid_source == nullptr) {
+			grid_source = x;
+		}
+	}
+	
+	El::Grid const& grid = grid_source->Grid();
+	return el_abstract_dist_matrix<Ring>{std::make_shared<El::DistMatrix<Ring>>(height, width, grid)};
+}
+
+/* Evaluate program on operands of ring Ring and return the result or out, or return an empty py::object if operands or
+ * out are not of ring Ring
+ */
+template<typename Ring>
+py::object
+elementwise_of_ring(
+	std::vector<py::handle> const& operands,
+	std::vector<elementwise_instruction> const& program,
+	py::handle out
+) {
+	std::vector<elementwise_source<Ring>> sources;
+	sources.reserve(operands.size());
+	for (py::handle x : operands) {
+		auto s = make_elementwise_source<Ring>(x);
+		if (!s) {
+			return {};
+		}
+		sources.push_back(std::move(*s));
+	}
+	
+	auto any_of = [&sources](auto pred) { return std::any_of(sources.begin(), sources.end(), pred); };
+	bool const distributed = any_of([](auto const& s) { return s.dist != nullptr; });
+	bool const local = any_of([](auto const& s) { return s.local != nullptr; });
+	bool const abstract = any_of([](auto const& s) { return s.abstract; });
+	
+	if (!distributed && !local) {
+		return {};
+	}
+	
+	if (distributed && local) {
+		// local matrices are not replicated implicitly, use ElDistMatrix.make_view() instead
+		return {};
+	}
+	
+	auto const size = broadcast_size(sources);
+	El::Int const height = size.first;
+	El::Int const width = size.second;
+	
+	if (!distributed) {
+		auto evaluate = [&sources, &program](El::Matrix<Ring> & c) {
+			std::vector<elementwise_operand<Ring>> ops;
+			ops.reserve(sources.size());
+			for (auto const& s : sources) {
+				ops.push_back(bind_elementwise_operand(s));
+			}
+			elementwise_local(ops, program, c);
+		};
+		
+		if (out.is_none()) {
+			El::Matrix<Ring> c;
+			without_gil([&]() {
+				c.Resize(height, width);
+				evaluate(c);
+			});
+			return py::cast(mpl::el_matrix<Ring>{std::move(c)});
+		}
+		
+		if (!py::isinstance<mpl::el_matrix<Ring>>(out)) {
+			return {};
+		}
+		
+		El::Matrix<Ring> & c = py::cast<mpl::el_matrix<Ring> &>(out).data();
+		check_elementwise_size(height, width, c.Height(), c.Width());
+		without_gil([&]() { evaluate(c); });
+		return py::reinterpret_borrow<py::object>(out);
+	}
+	
+	std::optional<el_abstract_dist_matrix<Ring>> c;
+	if (out.is_none()) {
+		c = without_gil([&]() { return make_elementwise_result(sources, height, width); });
+	} else {
+		py::object view = as_el_abstract_dist_matrix(py::reinterpret_borrow<py::object>(out));
+		if (!py::isinstance<el_abstract_dist_matrix<Ring>>(view)) {
+			return {};
+		}
+		c = py::cast<el_abstract_dist_matrix<Ring>>(view);
+		check_elementwise_size(height, width, c->data().Height(), c->data().Width());
+	}
+	
+	El::AbstractDistMatrix<Ring> & c_data = c->data();
+	if (c_data.Wrap() != El::ELEMENT) {
+		BOOST_THROW_EXCEPTION((matrix_distribution_not_supported_exception{}
+			<< errinfo_el_matrix_distribution{std::make_tuple(c_data.ColDist(), c_data.RowDist(), c_data.Wrap())}));
+	}
+	
+	without_gil([&]() {
+		// each operand is redistributed at most once, even if the program reads it several times
+		std::vector<std::unique_ptr<El::AbstractDistMatrix<Ring>>> copies(sources.size());
+		std::vector<elementwise_operand<Ring>> ops;
+		ops.reserve(sources.size());
+		for (std::size_t k = 0; k < sources.size(); ++k) {
+			ops.push_back(bind_elementwise_operand(sources[k], c_data, copies[k]));
+		}
+		elementwise_local(ops, program, c_data.Matrix());
+	});
+	
+	if (!out.is_none()) {
+		return py::reinterpret_borrow<py::object>(out);
+	}
+	
+	py::object result = py::cast(std::move(*c));
+	// Results are typed like their operands unless an operand is an ElAbstractDistMatrix
+	return abstract ? result : result.attr("typed")();
+}
+
+/* Evaluate program on operands for the first ring which all operands have in common and for which all functions of the
+ * program are defined. If out is not None, then the result is written into out which is returned.
+ */
+inline py::object
+elementwise(
+	std::vector<py::handle> const& operands,
+	std::vector<elementwise_instruction> const& program,
+	py::handle out,
+	std::string const& name
+) {
+	check_elementwise_program(program, operands.size());
+	
+	py::object result;
+	hana::for_each(hana::concat(scalars, complex_scalars), [&](auto ring_tn) {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		
+		bool const supported = std::all_of(program.begin(), program.end(), [](auto const& instruction) {
+			return elementwise_op_supported<ring_t>(instruction.op);
+		});
+		
+		if (!result && supported) {
+			result = elementwise_of_ring<ring_t>(operands, program, out);
+		}
+	});
+	
+	if (!result) {
+		throw py::type_error{name + "(): incompatible function arguments"};
+	}
+	return result;
+}
+
+/* Apply op to a and b entrywise, see above */
+inline py::object
+elementwise(py::handle a, py::handle b, py::handle out, elementwise_op op, std::string const& name) {
+	return elementwise({ a, b }, { { op, 0, 1 } }, out, name);
+}
+
+EDAMER_NAMESPACE_END(detail)
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DETAIL_ELEMENTWISE_IMPL_HPP
@@ -0,0 +1,37 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EDAMER_DETAIL_GATHER_FWD_HPP
+#define EDAMER_DETAIL_GATHER_FWD_HPP
+
+#include <edamer/config.hpp>
+#include <hbrs/mpl/config.hpp>
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+EDAMER_NAMESPACE_BEGIN(detail)
+
+/* Gathering distributed matrices into and scattering them from a single array on a root process. Entries are sent
+ * straight from local matrices into the array of the root process and vice versa with MPI derived datatypes, hence
+ * neither a [STAR,STAR] or [CIRC,CIRC] copy nor any other temporary matrix is allocated.
+ */
+
+EDAMER_NAMESPACE_END(detail)
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DETAIL_GATHER_FWD_HPP
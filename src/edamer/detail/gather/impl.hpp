@@ -0,0 +1,222 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EDAMER_DETAIL_GATHER_IMPL_HPP
+#define EDAMER_DETAIL_GATHER_IMPL_HPP
+
+#include "fwd.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <algorithm>
+#include <boost/throw_exception.hpp>
+#include <cstddef>
+#include <edamer/dt/exception.hpp>
+#include <El.hpp>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace py = pybind11;
+EDAMER_NAMESPACE_BEGIN(detail)
+
+/* Leading dimension (in elements) of a height x width array of Ring whose columns are contiguous, e.g. a Fortran-ordered
+ * array or a column slice of it, or -1 if obj is no such array
+ */
+template<typename Ring>
+El::Int
+column_major_ldim(py::handle obj, El::Int height, El::Int width, bool writeable) {
+	if (!py::isinstance<py::array>(obj)) {
+		return -1;
+	}
+	
+	auto array = py::reinterpret_borrow<py::array>(obj);
+	auto const itemsize = static_cast<py::ssize_t>(sizeof(Ring));
+	if (array.ndim() != 2 || array.shape(0) != height || array.shape(1) != width ||
+		!array.dtype().equal(py::dtype::of<Ring>()) || (writeable && !array.writeable()) ||
+		(height > 1 && array.strides(0) != itemsize) || array.strides(1) % itemsize != 0) {
+		return -1;
+	}
+	
+	El::Int const ldim = width > 1 ? array.strides(1) / itemsize : height;
+	return ldim >= std::max<El::Int>(height, 1) ? std::max<El::Int>(ldim, 1) : -1;
+}
+
+/* Datatype of the entries of a local matrix inside a column-major array with leading dimension ldim, i.e. local columns
+ * of entries which are col_stride apart, which again are row_stride columns apart
+ */
+inline MPI_Datatype
+make_local_entries_type(
+	MPI_Datatype etype,
+	std::size_t size,
+	El::Int local_height,
+	El::Int local_width,
+	El::Int col_stride,
+	El::Int row_stride,
+	El::Int ldim
+) {
+	MPI_Datatype column, type;
+	MPI_Type_vector(local_height, 1, col_stride, etype, &column);
+	MPI_Type_create_hvector(local_width, 1, static_cast<MPI_Aint>(row_stride) * ldim * size, column, &type);
+	MPI_Type_commit(&type);
+	MPI_Type_free(&column);
+	return type;
+}
+
+/* Exchange entries between the column-major array of the root process and the local matrices of all involved
+ * processes. Each message is described by derived datatypes on both sides, hence entries are sent from and received
+ * into their final location without packing them into buffers first.
+ */
+template<bool ToRoot, typename Ring>
+void
+exchange_with_root(
+	El::AbstractDistMatrix<Ring> const& a,
+	std::conditional_t<ToRoot, Ring, Ring const> * array,
+	El::Int ldim,
+	std::conditional_t<ToRoot, Ring const, Ring> * local,
+	El::Int local_ldim,
+	bool involved,
+	int root
+) {
+	if (a.Wrap() != El::ELEMENT) {
+		BOOST_THROW_EXCEPTION((matrix_distribution_not_supported_exception{}
+			<< errinfo_el_matrix_distribution{std::make_tuple(a.ColDist(), a.RowDist(), a.Wrap())}));
+	}
+	
+	El::mpi::Comm comm = a.Grid().ViewingComm();
+	MPI_Datatype const etype = El::mpi::TypeMap<Ring>();
+	MPI_Datatype const itype = El::mpi::TypeMap<El::Int>();
+	int const tag = 0;
+	
+	// the root process has to know where the entries of each process are located in its array
+	El::Int const layout[4] = {
+		a.ColShift(),
+		a.RowShift(),
+		involved ? a.LocalHeight() : 0,
+		involved ? a.LocalWidth() : 0
+	};
+	std::vector<El::Int> layouts(El::mpi::Rank(comm) == root ? 4 * El::mpi::Size(comm) : 0);
+	MPI_Gather(layout, 4, itype, layouts.data(), 4, itype, root, comm.comm);
+	
+	std::vector<MPI_Request> requests;
+	for (int p = 0; p < static_cast<int>(layouts.size() / 4); ++p) {
+		El::Int const * l = layouts.data() + 4 * p;
+		if (l[2] == 0 || l[3] == 0) {
+			continue;
+		}
+		
+		MPI_Datatype type = make_local_entries_type(
+			etype, sizeof(Ring), l[2], l[3], a.ColStride(), a.RowStride(), ldim);
+		requests.emplace_back();
+		if constexpr (ToRoot) {
+			MPI_Irecv(array + l[0] + l[1] * ldim, 1, type, p, tag, comm.comm, &requests.back());
+		} else {
+			MPI_Isend(array + l[0] + l[1] * ldim, 1, type, p, tag, comm.comm, &requests.back());
+		}
+		// freed datatypes stay valid for pending requests
+		MPI_Type_free(&type);
+	}
+	
+	if (involved) {
+		MPI_Datatype type = make_local_entries_type(
+			etype, sizeof(Ring), a.LocalHeight(), a.LocalWidth(), 1, 1, local_ldim);
+		requests.emplace_back();
+		if constexpr (ToRoot) {
+			MPI_Isend(local, 1, type, root, tag, comm.comm, &requests.back());
+		} else {
+			MPI_Irecv(local, 1, type, root, tag, comm.comm, &requests.back());
+		}
+		MPI_Type_free(&type);
+	}
+	
+	MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+}
+
+/* Gather a distributed matrix collectively into a caller-owned array on the root process of the viewing communicator.
+ * The array must have the shape and ring of a and contiguous columns, it is ignored on all other processes. Entries
+ * which are stored on several processes, e.g. in [STAR,STAR] matrices, are sent by one of them only.
+ */
+template<typename Ring>
+void
+gather_into(El::AbstractDistMatrix<Ring> const& a, py::object const& out, int root) {
+	El::mpi::Comm comm = a.Grid().ViewingComm();
+	
+	El::Int ldim = 0;
+	Ring * data = nullptr;
+	if (El::mpi::Rank(comm) == root) {
+		ldim = column_major_ldim<Ring>(out, a.Height(), a.Width(), true);
+		if (ldim > 0) {
+			data = static_cast<Ring*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+		}
+	}
+	
+	py::gil_scoped_release release;
+	// all processes have to fail if the array of the root process is not suitable
+	MPI_Bcast(&ldim, 1, El::mpi::TypeMap<El::Int>(), root, comm.comm);
+	if (ldim < 0) {
+		BOOST_THROW_EXCEPTION(incompatible_ndarray_exception{});
+	}
+	
+	bool const involved = a.Participating() && a.RedundantRank() == 0 && a.LocalHeight() > 0 && a.LocalWidth() > 0;
+	auto const& local = a.LockedMatrix();
+	exchange_with_root<true>(a, data, ldim, local.LockedBuffer(), local.LDim(), involved, root);
+}
+
+/* Scatter a caller-owned array on the root process of the viewing communicator collectively into a distributed matrix,
+ * which is resized to the shape of the array. The array must have contiguous columns and is ignored on all other
+ * processes.
+ */
+template<typename Ring>
+void
+scatter_from(py::object const& in, int root, El::AbstractDistMatrix<Ring> & a) {
+	El::mpi::Comm comm = a.Grid().ViewingComm();
+	
+	// height, width and leading dimension of the array
+	El::Int shape[3] = { 0, 0, 0 };
+	Ring const* data = nullptr;
+	if (El::mpi::Rank(comm) == root) {
+		shape[2] = -1;
+		if (py::isinstance<py::array>(in)) {
+			auto array = py::reinterpret_borrow<py::array>(in);
+			if (array.ndim() == 2) {
+				shape[0] = array.shape(0);
+				shape[1] = array.shape(1);
+				shape[2] = column_major_ldim<Ring>(array, shape[0], shape[1], false);
+				data = static_cast<Ring const*>(array.data());
+			}
+		}
+	}
+	
+	py::gil_scoped_release release;
+	MPI_Bcast(shape, 3, El::mpi::TypeMap<El::Int>(), root, comm.comm);
+	if (shape[2] < 0) {
+		BOOST_THROW_EXCEPTION(incompatible_ndarray_exception{});
+	}
+	
+	a.Resize(shape[0], shape[1]);
+	bool const involved = a.Participating() && a.LocalHeight() > 0 && a.LocalWidth() > 0;
+	auto & local = a.Matrix();
+	exchange_with_root<false>(a, data, shape[2], local.Buffer(), local.LDim(), involved, root);
+}
+
+EDAMER_NAMESPACE_END(detail)
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DETAIL_GATHER_IMPL_HPP
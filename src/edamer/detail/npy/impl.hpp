@@ -0,0 +1,398 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EDAMER_DETAIL_NPY_IMPL_HPP
+#define EDAMER_DETAIL_NPY_IMPL_HPP
+
+#include "fwd.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <algorithm>
+#include <boost/hana/concat.hpp>
+#include <boost/hana/first.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/front.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstdint>
+#include <edamer/detail/scalar.hpp>
+#include <edamer/dt/exception.hpp>
+#include <El.hpp>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <regex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+EDAMER_NAMESPACE_BEGIN(detail)
+namespace hana = boost::hana;
+
+struct npy_header {
+	std::string descr;
+	El::Int height;
+	El::Int width;
+	// offset of the first matrix entry in bytes
+	MPI_Offset size;
+};
+
+/* NumPy type descriptor of a ring, e.g. '<f8' for double on little-endian machines */
+template<typename Ring>
+std::string
+npy_descr() {
+	std::uint16_t const one = 1;
+	std::string descr{*reinterpret_cast<char const*>(&one) == 1 ? '<' : '>'};
+	
+	if constexpr (std::is_integral_v<Ring>) {
+		descr += 'i';
+	} else if constexpr (std::is_floating_point_v<Ring>) {
+		descr += 'f';
+	} else {
+		descr += 'c';
+	}
+	return descr + std::to_string(sizeof(Ring));
+}
+
+/* Header of a .npy file (format version 1.0) for a matrix in column-major order, padded to a multiple of 64 bytes */
+inline std::string
+make_npy_header(std::string const& descr, El::Int height, El::Int width) {
+	std::string dict = "{'descr': '" + descr + "', 'fortran_order': True, 'shape': (" +
+		std::to_string(height) + ", " + std::to_string(width) + "), }";
+	
+	std::size_t const prefix = 10;
+	dict.append(63 - (prefix + dict.size()) % 64, ' ');
+	dict += '\n';
+	
+	std::string header{"\x93NUMPY\x01\x00", 8};
+	header += static_cast<char>(dict.size() & 0xff);
+	header += static_cast<char>(dict.size() >> 8);
+	return header + dict;
+}
+
+inline void
+check_mpi_io(int error, std::string const& path) {
+	if (error != MPI_SUCCESS) {
+		BOOST_THROW_EXCEPTION((file_access_failed_exception{} << errinfo_file_path{path}));
+	}
+}
+
+/* Call f on all processes of comm and agree on whether it failed before returning. Errors might be detected by some
+ * processes only, e.g. if MPI-IO failed on a single process or if only rank 0 wrote the header, but throwing on those
+ * alone would leave all other processes blocked in the next collective call. Instead, all processes throw, either the
+ * exception of f or file_access_failed_exception where f succeeded. f must not call collective functions.
+ */
+template<typename F>
+void
+collectively(El::mpi::Comm comm, std::string const& path, F && f) {
+	std::exception_ptr error;
+	try {
+		f();
+	} catch (...) {
+		error = std::current_exception();
+	}
+	
+	int failed = error ? 1 : 0;
+	MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, comm.comm);
+	
+	if (error) {
+		std::rethrow_exception(error);
+	}
+	if (failed) {
+		BOOST_THROW_EXCEPTION((file_access_failed_exception{} << errinfo_file_path{path}));
+	}
+}
+
+inline void
+check_mpi_io(El::mpi::Comm comm, int error, std::string const& path) {
+	collectively(comm, path, [error, &path]() { check_mpi_io(error, path); });
+}
+
+/* File which is opened collectively and closed collectively when leaving scope. Errors are agreed on collectively
+ * before throwing, hence all processes leave the scope on the same path and the file is closed on every path.
+ */
+class npy_file {
+public:
+	/* If opening failed on any process, the file is not closed on any process, not even where opening succeeded,
+	 * because closing is collective, too.
+	 */
+	npy_file(El::mpi::Comm comm, std::string const& path, int amode) : comm_{comm}, path_{path}, file_{MPI_FILE_NULL} {
+		check_mpi_io(comm, MPI_File_open(comm.comm, path.c_str(), amode, MPI_INFO_NULL, &file_), path);
+	}
+	
+	npy_file(npy_file const&) = delete;
+	npy_file & operator=(npy_file const&) = delete;
+	
+	~npy_file() {
+		if (file_ != MPI_FILE_NULL) {
+			MPI_File_close(&file_);
+		}
+	}
+	
+	MPI_File
+	get() const { return file_; }
+	
+	// Close the file explicitly to detect errors, e.g. when flushing written data
+	void
+	close() {
+		int const error = MPI_File_close(&file_);
+		file_ = MPI_FILE_NULL;
+		check_mpi_io(comm_, error, path_);
+	}
+	
+private:
+	El::mpi::Comm comm_;
+	std::string path_;
+	MPI_File file_;
+};
+
+/* Read the header of a .npy file collectively. Two-dimensional arrays must be stored in column-major order, while
+ * one-dimensional arrays are read as column vectors.
+ */
+inline npy_header
+read_npy_header(El::mpi::Comm comm, MPI_File file, std::string const& path) {
+	unsigned char prefix[12];
+	int error = MPI_File_read_at_all(file, 0, prefix, 12, MPI_BYTE, MPI_STATUS_IGNORE);
+	
+	MPI_Offset begin = 0;
+	MPI_Offset length = 0;
+	collectively(comm, path, [&]() {
+		check_mpi_io(error, path);
+		if (std::string{reinterpret_cast<char const*>(prefix), 6} != "\x93NUMPY" || prefix[6] < 1 || prefix[6] > 3) {
+			BOOST_THROW_EXCEPTION((file_format_not_supported_exception{} << errinfo_file_path{path}));
+		}
+		
+		// version 1.0 stores the header length in two bytes, later versions in four bytes
+		begin = prefix[6] == 1 ? 10 : 12;
+		length = prefix[8] | (prefix[9] << 8);
+		if (prefix[6] != 1) {
+			length |= (MPI_Offset{prefix[10]} << 16) | (MPI_Offset{prefix[11]} << 24);
+		}
+	});
+	
+	std::string dict(length, ' ');
+	error = MPI_File_read_at_all(file, begin, dict.data(), length, MPI_BYTE, MPI_STATUS_IGNORE);
+	
+	npy_header header;
+	collectively(comm, path, [&]() {
+		check_mpi_io(error, path);
+		
+		std::smatch descr, order, shape;
+		std::regex_search(dict, descr, std::regex{R"('descr'\s*:\s*'([^']*)')"});
+		std::regex_search(dict, order, std::regex{R"('fortran_order'\s*:\s*(True|False))"});
+		std::regex_search(dict, shape, std::regex{R"('shape'\s*:\s*\(\s*(\d+)\s*(?:,\s*(\d+)\s*)?,?\s*\))"});
+		
+		if (descr.empty() || order.empty() || shape.empty() ||
+			(order[1] == "False" && shape[2].matched && std::stol(shape[1]) > 1 && std::stol(shape[2]) > 1)) {
+			BOOST_THROW_EXCEPTION((file_format_not_supported_exception{}
+				<< errinfo_file_path{path} << errinfo_file_header{dict}));
+		}
+		
+		header = {
+			descr[1],
+			std::stol(shape[1]),
+			shape[2].matched ? std::stol(shape[2]) : 1,
+			begin + length
+		};
+	});
+	return header;
+}
+
+inline npy_header
+read_npy_header(El::mpi::Comm comm, std::string const& path) {
+	npy_file file{comm, path, MPI_MODE_RDONLY};
+	auto header = read_npy_header(comm, file.get(), path);
+	file.close();
+	return header;
+}
+
+/* MPI counts are ints, hence local matrices must neither be higher nor wider than INT_MAX entries. The number of local
+ * entries may exceed INT_MAX though, because file views and transfers count columns, see set_npy_view() and
+ * transfer_npy(). Call within collectively() to throw on all processes.
+ */
+template<typename Ring>
+void
+check_npy_counts(El::AbstractDistMatrix<Ring> const& a) {
+	El::Int const largest = std::max(a.LocalHeight(), a.LocalWidth());
+	if (largest > std::numeric_limits<int>::max()) {
+		BOOST_THROW_EXCEPTION((mpi_count_overflow_exception{} << errinfo_mpi_count{largest}));
+	}
+}
+
+/* Restrict the file view to the entries of the local matrix of a, i.e. to local column vectors of entries which are
+ * ColStride() apart, which again are RowStride() columns apart. All processes set the same elementary type, as MPI
+ * requires, but processes without entries do not access the file. Returns the error code of MPI_File_set_view(), which
+ * is collective.
+ */
+template<typename Ring>
+int
+set_npy_view(MPI_File file, npy_header const& header, El::AbstractDistMatrix<Ring> const& a, bool access) {
+	MPI_Datatype const etype = El::mpi::TypeMap<Ring>();
+	if (!access) {
+		return MPI_File_set_view(file, header.size, etype, etype, "native", MPI_INFO_NULL);
+	}
+	
+	MPI_Datatype column, filetype;
+	MPI_Type_vector(static_cast<int>(a.LocalHeight()), 1, a.ColStride(), etype, &column);
+	MPI_Aint const stride = static_cast<MPI_Aint>(a.RowStride()) * a.Height() * sizeof(Ring);
+	MPI_Type_create_hvector(static_cast<int>(a.LocalWidth()), 1, stride, column, &filetype);
+	MPI_Type_commit(&filetype);
+	
+	MPI_Offset const disp = header.size + (a.ColShift() + MPI_Offset{a.RowShift()} * a.Height()) * sizeof(Ring);
+	int const error = MPI_File_set_view(file, disp, etype, filetype, "native", MPI_INFO_NULL);
+	
+	MPI_Type_free(&filetype);
+	MPI_Type_free(&column);
+	return error;
+}
+
+/* Call a collective MPI-IO function f(count, datatype) such as MPI_File_write_all() on the packed entries of a local
+ * matrix. Entries are passed as Width() columns of Height() contiguous entries, hence count fits into an int even if
+ * the local matrix holds more than INT_MAX entries. Returns the error code of f.
+ */
+template<typename Ring, typename F>
+int
+transfer_npy(El::Matrix<Ring> const& local, bool access, F && f) {
+	MPI_Datatype const etype = El::mpi::TypeMap<Ring>();
+	if (!access) {
+		return f(0, etype);
+	}
+	
+	MPI_Datatype column;
+	MPI_Type_contiguous(static_cast<int>(local.Height()), etype, &column);
+	MPI_Type_commit(&column);
+	int const error = f(static_cast<int>(local.Width()), column);
+	MPI_Type_free(&column);
+	return error;
+}
+
+/* Write a distributed matrix collectively to a .npy file. Entries which are stored on several processes, e.g. in
+ * [STAR,STAR] matrices, are written by one of them only.
+ */
+template<typename Ring>
+void
+write_npy(El::AbstractDistMatrix<Ring> const& a, std::string const& path) {
+	El::mpi::Comm comm = a.Grid().ViewingComm();
+	npy_file file{comm, path, MPI_MODE_CREATE | MPI_MODE_WRONLY};
+	
+	std::string const bytes = make_npy_header(npy_descr<Ring>(), a.Height(), a.Width());
+	npy_header const header{npy_descr<Ring>(), a.Height(), a.Width(), static_cast<MPI_Offset>(bytes.size())};
+	
+	// truncate existing files
+	check_mpi_io(comm,
+		MPI_File_set_size(file.get(), header.size + MPI_Offset{a.Height()} * a.Width() * sizeof(Ring)), path);
+	
+	int error = MPI_SUCCESS;
+	if (El::mpi::Rank(comm) == 0) {
+		error = MPI_File_write_at(file.get(), 0, bytes.data(), bytes.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+	}
+	check_mpi_io(comm, error, path);
+	
+	bool const access = a.Participating() && a.RedundantRank() == 0 && a.LocalHeight() > 0 && a.LocalWidth() > 0;
+	auto const& local = a.LockedMatrix();
+	std::vector<Ring> buf;
+	Ring const* data = local.LockedBuffer();
+	collectively(comm, path, [&]() {
+		check_npy_counts(a);
+		if (access && local.LDim() != local.Height()) {
+			// local matrix is a view with a leading dimension larger than its height
+			buf.reserve(local.Height() * local.Width());
+			for (El::Int j = 0; j < local.Width(); ++j) {
+				buf.insert(buf.end(), local.LockedBuffer(0, j), local.LockedBuffer(0, j) + local.Height());
+			}
+			data = buf.data();
+		}
+	});
+	
+	check_mpi_io(comm, set_npy_view(file.get(), header, a, access), path);
+	check_mpi_io(comm, transfer_npy(local, access, [&](int count, MPI_Datatype type) {
+		return MPI_File_write_all(file.get(), data, count, type, MPI_STATUS_IGNORE);
+	}), path);
+	file.close();
+}
+
+/* Read a distributed matrix collectively from a .npy file, a is resized to the shape stored in the file */
+template<typename Ring>
+void
+read_npy(std::string const& path, El::AbstractDistMatrix<Ring> & a) {
+	El::mpi::Comm comm = a.Grid().ViewingComm();
+	npy_file file{comm, path, MPI_MODE_RDONLY};
+	auto header = read_npy_header(comm, file.get(), path);
+	
+	auto & local = a.Matrix();
+	std::vector<Ring> buf;
+	bool access = false;
+	bool contiguous = true;
+	collectively(comm, path, [&]() {
+		if (header.descr != npy_descr<Ring>()) {
+			BOOST_THROW_EXCEPTION((file_format_not_supported_exception{}
+				<< errinfo_file_path{path} << errinfo_file_header{header.descr}));
+		}
+		
+		a.Resize(header.height, header.width);
+		check_npy_counts(a);
+		access = a.Participating() && a.LocalHeight() > 0 && a.LocalWidth() > 0;
+		contiguous = local.LDim() == local.Height();
+		if (access && !contiguous) {
+			buf.resize(local.Height() * local.Width());
+		}
+	});
+	
+	check_mpi_io(comm, set_npy_view(file.get(), header, a, access), path);
+	
+	Ring * data = contiguous ? local.Buffer() : buf.data();
+	check_mpi_io(comm, transfer_npy(local, access, [&](int count, MPI_Datatype type) {
+		return MPI_File_read_all(file.get(), data, count, type, MPI_STATUS_IGNORE);
+	}), path);
+	file.close();
+	
+	if (access && !contiguous) {
+		for (El::Int j = 0; j < local.Width(); ++j) {
+			std::copy(buf.begin() + j * local.Height(), buf.begin() + (j + 1) * local.Height(), local.Buffer(0, j));
+		}
+	}
+}
+
+/* Call f(hana::type_c<Ring>) for the ring which matches a NumPy type descriptor given at runtime. f has to return the
+ * same type for all rings.
+ */
+template<typename F>
+auto
+with_npy_ring(std::string const& descr, F && f) {
+	auto ring_tns = hana::concat(scalars, complex_scalars);
+	using result_t = decltype(f(hana::first(hana::front(ring_tns))));
+	
+	std::optional<result_t> result;
+	hana::for_each(ring_tns, [&](auto ring_tn) {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		if (!result && descr == npy_descr<ring_t>()) {
+			result.emplace(f(hana::type_c<ring_t>));
+		}
+	});
+	
+	if (!result) {
+		BOOST_THROW_EXCEPTION((file_format_not_supported_exception{} << errinfo_file_header{descr}));
+	}
+	return std::move(*result);
+}
+
+EDAMER_NAMESPACE_END(detail)
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DETAIL_NPY_IMPL_HPP
@@ -26,8 +26,12 @@
 #include <boost/preprocessor/variadic/to_seq.hpp>
 #include <boost/preprocessor/stringize.hpp>
 #include <edamer/config.hpp>
+#include <functional>
 #include <pybind11/pybind11.h>
 #include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 namespace py = pybind11;
@@ -48,6 +52,37 @@ EDAMER_API
 std::string
 regex_replace(std::string const& s, std::string const& re, std::string const& fmt);
 
+EDAMER_NAMESPACE_BEGIN(detail)
+/* Registrations of classes and overloads for distributed matrices multiply with the number of scalar types and matrix
+ * distributions and dominate the import time of edamer. Hence they are deferred per scalar type (ring) and executed
+ * when the ring is used for the first time, e.g. when a distributed matrix view is made from a local matrix or when a
+ * class of that ring is looked up in edamer.cpp.dt or edamer.cpp.fn. Deferred registrations of a ring are executed in
+ * the order they were deferred, so the order of pydefs in main.cpp still holds.
+ */
+EDAMER_API
+void
+defer_pydef(std::type_index ring, std::function<void()> f);
+
+EDAMER_API
+void
+require_pydefs(std::type_index ring);
+
+template<typename Ring>
+void
+require_pydefs() {
+	require_pydefs(std::type_index{typeid(std::remove_cv_t<Ring>)});
+}
+
+EDAMER_API
+void
+require_all_pydefs();
+
+/* Resolve missing attributes of module m by executing deferred registrations ring by ring until the attribute exists */
+EDAMER_API
+void
+def_lazy_getattr(py::module & m);
+EDAMER_NAMESPACE_END(detail)
+
 EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
 
 #define EDAMER_INTEGRAL_NAME_PAIR(integral)                                                                            \
@@ -16,7 +16,11 @@
 
 #include "impl.hpp"
 
+#include <algorithm>
 #include <boost/regex.hpp>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 
@@ -69,10 +73,82 @@ regex_replace(std::string const& s, std::string const& re, std::string const& fm
 	return boost::regex_replace(s, boost::regex(re), fmt);
 }
 
+EDAMER_NAMESPACE_BEGIN(detail)
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+/* Pending registrations per ring, ordered by the first deferral of each ring, i.e. by the order of scalars */
+std::vector<std::pair<std::type_index, std::vector<std::function<void()>>>> &
+deferred_pydefs() {
+	static std::vector<std::pair<std::type_index, std::vector<std::function<void()>>>> pydefs;
+	return pydefs;
+}
+EDAMER_NAMESPACE_END(/* unnamed */)
+
+EDAMER_API
+void
+defer_pydef(std::type_index ring, std::function<void()> f) {
+	auto & pydefs = deferred_pydefs();
+	auto it = std::find_if(pydefs.begin(), pydefs.end(), [&ring](auto const& p) { return p.first == ring; });
+	if (it == pydefs.end()) {
+		pydefs.emplace_back(ring, std::vector<std::function<void()>>{});
+		it = std::prev(pydefs.end());
+	}
+	it->second.push_back(std::move(f));
+}
+
+EDAMER_API
+void
+require_pydefs(std::type_index ring) {
+	auto & pydefs = deferred_pydefs();
+	auto it = std::find_if(pydefs.begin(), pydefs.end(), [&ring](auto const& p) { return p.first == ring; });
+	if (it == pydefs.end()) {
+		return;
+	}
+	
+	// remove before executing to allow registrations to require other rings
+	auto fs = std::move(it->second);
+	pydefs.erase(it);
+	for (auto & f : fs) {
+		f();
+	}
+}
+
+EDAMER_API
+void
+require_all_pydefs() {
+	while (!deferred_pydefs().empty()) {
+		require_pydefs(deferred_pydefs().front().first);
+	}
+}
+
+EDAMER_API
+void
+def_lazy_getattr(py::module & m) {
+	m.def("__getattr__",
+		[m = py::handle{m}](std::string const& name) -> py::object {
+			auto dict = py::reinterpret_borrow<py::dict>(PyModule_GetDict(m.ptr()));
+			while (!dict.contains(name) && !deferred_pydefs().empty()) {
+				require_pydefs(deferred_pydefs().front().first);
+			}
+			
+			if (!dict.contains(name)) {
+				throw py::attribute_error{"module '" + m.attr("__name__").cast<std::string>()
+					+ "' has no attribute '" + name + "'"};
+			}
+			return dict[name.c_str()];
+		}
+	);
+}
+EDAMER_NAMESPACE_END(detail)
+
 py::module &
 pydef_impl<pybind11_tag>::apply(py::module & m, py::module & base) {
 	m.def("pystrip", &pystrip, "convert C++ class names or C++ type names to valid Python names");
 	m.def("regex_replace", &regex_replace, "Use regular expressions to perform substitutions on strings");
+	m.def("require_all_pydefs", &detail::require_all_pydefs,
+		"Register all classes and overloads which are deferred until first use of their scalar type");
+	
+	// deferred registrations hold Python objects which must be released before the interpreter shuts down
+	py::module::import("atexit").attr("register")(py::cpp_function([]() { detail::deferred_pydefs().clear(); }));
 	return m;
 }
 
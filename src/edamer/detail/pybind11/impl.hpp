@@ -20,6 +20,8 @@
 #include "fwd.hpp"
 
 #include <boost/format.hpp>
+#include <boost/hana/first.hpp>
+#include <boost/hana/for_each.hpp>
 #include <boost/hana/tuple.hpp>
 #include <edamer/dt/expression.hpp>
 #include <hbrs/mpl/dt/expression.hpp>
@@ -46,6 +48,26 @@ struct EDAMER_API pydef_impl<pybind11_tag> {
 	apply(py::module & m, py::module & base);
 };
 
+EDAMER_NAMESPACE_BEGIN(detail)
+/* Call f(ring_tn) for each pair of ring type and name in ring_tns on first use of the ring, see defer_pydef() */
+template <typename RingTypeNames, typename F>
+void
+for_each_deferred(RingTypeNames const& ring_tns, F const& f) {
+	hana::for_each(ring_tns, [&f](auto ring_tn) {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		defer_pydef(typeid(ring_t), [f, ring_tn]() mutable { f(ring_tn); });
+	});
+}
+
+/* Call f without holding the GIL, e.g. for computations which take long and do not touch Python objects */
+template <typename F>
+decltype(auto)
+without_gil(F && f) {
+	py::gil_scoped_release release;
+	return f();
+}
+EDAMER_NAMESPACE_END(detail)
+
 template <typename Operation, typename... Operands>
 EDAMER_API
 py::module &
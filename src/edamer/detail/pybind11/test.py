@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+from edamer import detail
+import logging
+
+
+def import_time(eager):
+    code = 'import time; t = time.perf_counter(); import edamer; print(time.perf_counter() - t)'
+    return float(detail.test.run(code, eager))
+
+
+def registered_overloads(eager):
+    # pybind11 lists overloads as '1. name(...)', '2. name(...)', ... in the docstring of a function
+    code = '\n'.join([
+        'import re',
+        'import edamer.cpp.fn as fn',
+        'functions = [f for f in vars(fn).values() if type(f).__name__ == "builtin_function_or_method"]',
+        'print(sum(max(1, len(re.findall(r"^\\d+\\. ", f.__doc__ or "", re.M))) for f in functions))'
+    ])
+    return int(detail.test.run(code, eager))
+
+
+def test_lazy_pydefs():
+    lazy = registered_overloads(eager=False)
+    eager = registered_overloads(eager=True)
+    logging.info('overloads of edamer.cpp.fn after import: %d (lazy), %d (eager)', lazy, eager)
+    # overloads for distributed matrices are registered on first use of their ring
+    assert lazy < eager
+
+
+# Imports edamer six times, hence it runs with EDAMER_BENCHMARKS=1 only, e.g.
+#   EDAMER_BENCHMARKS=1 python3 -m pytest --log-cli-level=INFO detail/pybind11/test.py
+@detail.test.benchmark
+def test_lazy_pydefs_import_time():
+    # wall-clock times depend on the machine and its load, hence they are logged only
+    lazy_time = min(import_time(eager=False) for _ in range(3))
+    eager_time = min(import_time(eager=True) for _ in range(3))
+    logging.info('import edamer: %.3fs (lazy), %.3fs (eager)', lazy_time, eager_time)
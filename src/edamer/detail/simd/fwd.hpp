@@ -0,0 +1,46 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EDAMER_DETAIL_SIMD_FWD_HPP
+#define EDAMER_DETAIL_SIMD_FWD_HPP
+
+#include <edamer/config.hpp>
+#include <hbrs/mpl/config.hpp>
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+EDAMER_NAMESPACE_BEGIN(detail)
+
+/* Vectorized kernels for columns of local matrices of ring float and double. Each kernel is compiled for AVX-512, AVX2
+ * and the baseline instruction set of the target and the variant for the CPU at hand is selected when the library is
+ * loaded. Callers fall back to scalar loops for other rings and for strided columns.
+ *
+ * Kernels cover elementwise functions, broadcasting of scalars and column sums and moments. Column norms are not
+ * vectorized here, edamer has no function for them and relies on Elemental, e.g. for normalizing principal components.
+ */
+
+enum class simd_op { plus, minus, times, rdivide };
+
+template<typename F>
+struct simd_op_of;
+
+EDAMER_NAMESPACE_END(detail)
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DETAIL_SIMD_FWD_HPP
@@ -0,0 +1,194 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "impl.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+EDAMER_NAMESPACE_BEGIN(detail)
+
+/* Kernels are written as plain loops which are vectorized by the compiler for each variant. The variants are created
+ * with GCC's and Clang's target_clones attribute, hence a variant is picked at load time of the library with an ifunc
+ * resolver based on the features of the CPU. Helpers are inlined into each variant so that they are compiled for its
+ * instruction set, too.
+ */
+#if defined(EDAMER_ENABLE_SIMD) && defined(__x86_64__) && defined(__has_attribute)
+	#if __has_attribute(target_clones)
+		#define EDAMER_SIMD_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+	#endif
+#endif
+#ifndef EDAMER_SIMD_CLONES
+	#define EDAMER_SIMD_CLONES
+#endif
+
+#if defined(__GNUC__)
+	#define EDAMER_SIMD_INLINE inline __attribute__((always_inline))
+#else
+	#define EDAMER_SIMD_INLINE inline
+#endif
+
+/* Loops are annotated with OpenMP's simd construct which allows reordering floating-point reductions. Only the
+ * compiler support of -fopenmp-simd is required, not an OpenMP runtime.
+ */
+#define EDAMER_SIMD_PRAGMA(x) _Pragma(#x)
+#ifdef EDAMER_HAS_CXX_FOPENMP_SIMD
+	#define EDAMER_SIMD_LOOP(clauses) EDAMER_SIMD_PRAGMA(omp simd clauses)
+#else
+	#define EDAMER_SIMD_LOOP(clauses)
+#endif
+
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+template<typename Ring, typename F>
+EDAMER_SIMD_INLINE void
+binary(El::Int n, Ring const* a, El::Int a_stride, Ring const* b, El::Int b_stride, Ring * out, F f) {
+	if (a_stride != 0 && b_stride != 0) {
+		EDAMER_SIMD_LOOP()
+		for (El::Int i = 0; i < n; ++i) {
+			out[i] = f(a[i], b[i]);
+		}
+	} else if (a_stride != 0) {
+		Ring const y = *b;
+		EDAMER_SIMD_LOOP()
+		for (El::Int i = 0; i < n; ++i) {
+			out[i] = f(a[i], y);
+		}
+	} else if (b_stride != 0) {
+		Ring const x = *a;
+		EDAMER_SIMD_LOOP()
+		for (El::Int i = 0; i < n; ++i) {
+			out[i] = f(x, b[i]);
+		}
+	} else {
+		Ring const z = n > 0 ? f(*a, *b) : Ring{};
+		EDAMER_SIMD_LOOP()
+		for (El::Int i = 0; i < n; ++i) {
+			out[i] = z;
+		}
+	}
+}
+
+template<typename Ring>
+EDAMER_SIMD_INLINE void
+binary(simd_op op, El::Int n, Ring const* a, El::Int a_stride, Ring const* b, El::Int b_stride, Ring * out) {
+	switch (op) {
+		case simd_op::plus:
+			binary(n, a, a_stride, b, b_stride, out, std::plus<>{});
+			break;
+		case simd_op::minus:
+			binary(n, a, a_stride, b, b_stride, out, std::minus<>{});
+			break;
+		case simd_op::times:
+			binary(n, a, a_stride, b, b_stride, out, std::multiplies<>{});
+			break;
+		case simd_op::rdivide:
+			binary(n, a, a_stride, b, b_stride, out, std::divides<>{});
+			break;
+	}
+}
+
+/* Merge the mean and sum of squared deviations of count_b values into those of count_a values like Chan et al. */
+EDAMER_SIMD_INLINE void
+merge_moments(double count_a, double & mean_a, double & m2_a, double count_b, double mean_b, double m2_b) {
+	double const total = count_a + count_b;
+	double const delta = mean_b - mean_a;
+	mean_a += delta * count_b / total;
+	m2_a += m2_b + delta * delta * count_a * count_b / total;
+}
+
+/* Welford's update of the mean and the sum of squared deviations in a single pass over x. Entries are spread over
+ * lanes, i.e. lane k adds x[k], x[k+lanes], x[k+2*lanes], ..., so the updates of all lanes are independent of each
+ * other and compiled to vector instructions. All lanes have seen the same number of values, hence a single reciprocal
+ * per block of lanes suffices. Afterwards lanes are merged pairwise and the remaining entries, fewer than lanes, are
+ * added one by one.
+ */
+template<typename Ring>
+EDAMER_SIMD_INLINE void
+moments(El::Int n, Ring const* x, double & mean, double & m2) {
+	constexpr El::Int lanes = 16;
+	El::Int const blocks = n / lanes;
+	
+	alignas(64) double lane_mean[lanes] = {};
+	alignas(64) double lane_m2[lanes] = {};
+	for (El::Int t = 0; t < blocks; ++t) {
+		double const inverse = 1. / static_cast<double>(t + 1);
+		Ring const* block = x + t * lanes;
+		EDAMER_SIMD_LOOP()
+		for (El::Int k = 0; k < lanes; ++k) {
+			double const value = static_cast<double>(block[k]);
+			double const delta = value - lane_mean[k];
+			lane_mean[k] += delta * inverse;
+			lane_m2[k] += delta * (value - lane_mean[k]);
+		}
+	}
+	
+	mean = 0;
+	m2 = 0;
+	double count = 0;
+	if (blocks > 0) {
+		// lanes of equal counts are merged as a balanced tree
+		for (El::Int width = lanes / 2; width > 0; width /= 2) {
+			double const lane_count = static_cast<double>(blocks * (lanes / width / 2));
+			for (El::Int k = 0; k < width; ++k) {
+				merge_moments(
+					lane_count, lane_mean[k], lane_m2[k], lane_count, lane_mean[k + width], lane_m2[k + width]);
+			}
+		}
+		count = static_cast<double>(blocks * lanes);
+		mean = lane_mean[0];
+		m2 = lane_m2[0];
+	}
+	
+	for (El::Int i = blocks * lanes; i < n; ++i) {
+		double const value = static_cast<double>(x[i]);
+		count += 1;
+		double const delta = value - mean;
+		mean += delta / count;
+		m2 += delta * (value - mean);
+	}
+}
+EDAMER_NAMESPACE_END(/* unnamed */)
+
+EDAMER_SIMD_CLONES void
+simd_binary(simd_op op, El::Int n, float const* a, El::Int a_stride, float const* b, El::Int b_stride, float * out) {
+	binary(op, n, a, a_stride, b, b_stride, out);
+}
+
+EDAMER_SIMD_CLONES void
+simd_binary(simd_op op, El::Int n, double const* a, El::Int a_stride, double const* b, El::Int b_stride, double * out) {
+	binary(op, n, a, a_stride, b, b_stride, out);
+}
+
+EDAMER_SIMD_CLONES void
+simd_moments(El::Int n, float const* x, double & mean, double & m2) {
+	moments(n, x, mean, m2);
+}
+
+EDAMER_SIMD_CLONES void
+simd_moments(El::Int n, double const* x, double & mean, double & m2) {
+	moments(n, x, mean, m2);
+}
+
+#undef EDAMER_SIMD_LOOP
+#undef EDAMER_SIMD_PRAGMA
+#undef EDAMER_SIMD_INLINE
+#undef EDAMER_SIMD_CLONES
+
+EDAMER_NAMESPACE_END(detail)
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
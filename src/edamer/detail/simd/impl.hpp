@@ -0,0 +1,68 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EDAMER_DETAIL_SIMD_IMPL_HPP
+#define EDAMER_DETAIL_SIMD_IMPL_HPP
+
+#include "fwd.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <El.hpp>
+#include <functional>
+#include <type_traits>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+EDAMER_NAMESPACE_BEGIN(detail)
+
+/* Compute out[i] = a[i * a_stride] op b[i * b_stride] for 0 <= i < n. Strides must be 0 or 1, i.e. a and b are either
+ * contiguous columns or broadcast scalars. out may be a or b.
+ */
+void
+simd_binary(simd_op op, El::Int n, float const* a, El::Int a_stride, float const* b, El::Int b_stride, float * out);
+
+void
+simd_binary(simd_op op, El::Int n, double const* a, El::Int a_stride, double const* b, El::Int b_stride, double * out);
+
+/* Mean and sum of squared deviations from the mean of x[0], ..., x[n-1] in a single pass, accumulated in double
+ * precision with Welford's update per vector lane. Both are zero if n is zero.
+ */
+void
+simd_moments(El::Int n, float const* x, double & mean, double & m2);
+
+void
+simd_moments(El::Int n, double const* x, double & mean, double & m2);
+
+template<typename F>
+struct simd_op_of {};
+
+template<typename Ring>
+constexpr bool is_simd_ring_v = std::is_same_v<Ring, float> || std::is_same_v<Ring, double>;
+
+/* Whether elementwise function F on ring Ring has a vectorized kernel */
+template<typename Ring, typename F, typename = void>
+struct has_simd_binary : std::false_type {};
+
+template<typename Ring, typename F>
+struct has_simd_binary<Ring, F, std::void_t<decltype(simd_op_of<F>::value)>>
+: std::bool_constant<is_simd_ring_v<Ring>> {};
+
+EDAMER_NAMESPACE_END(detail)
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DETAIL_SIMD_IMPL_HPP
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+from edamer import detail, dt, fn
+import logging
+import numpy as np
+import pytest
+
+Functions = [
+    (fn.plus, np.add),
+    (fn.minus, np.subtract),
+    (fn.times, np.multiply),
+    (fn.rdivide, np.divide)
+]
+
+
+# Lengths of columns which are not a multiple of any vector width, hence the kernels process remaining entries one by one
+@pytest.mark.parametrize("dtype", [np.float32, np.float64])
+@pytest.mark.parametrize("m", [1, 3, 15, 17, 33, 1001])
+def test_simd_tail_lengths(dtype, m):
+    rng = np.random.default_rng(0)
+    # large offsets would cancel in the textbook formula of the variance
+    a_np = np.asarray(1e3 + rng.standard_normal((m, 3)), dtype=dtype, order='F')
+    b_np = np.asarray(rng.uniform(1, 2, (m, 3)), dtype=dtype, order='F')
+    a = dt.ElMatrix.view_from_numpy(a_np)
+    b = dt.ElMatrix.view_from_numpy(b_np)
+
+    # moments are accumulated in double precision for both rings
+    x_np = np.asarray(a_np, dtype=np.float64)
+    assert np.allclose(detail.test.to_numpy_1d(fn.mean(a, dim=1)), x_np.mean(axis=0), rtol=1e-12)
+    if m > 1:
+        assert np.allclose(detail.test.to_numpy_1d(fn.var(a, 0, 1)), x_np.var(axis=0, ddof=1), rtol=1e-9)
+
+    rtol = 1e-6 if dtype == np.float32 else 1e-12
+    for f, f_np in Functions:
+        logging.debug('f: %r' % f)
+        c = f(a, b).view_to_numpy()
+        assert c.dtype == dtype
+        assert np.allclose(c, f_np(a_np, b_np), rtol=rtol)
+        assert np.allclose(f(a, 1.5).view_to_numpy(), f_np(a_np, dtype(1.5)), rtol=rtol)
+        assert np.allclose(f(1.5, b).view_to_numpy(), f_np(dtype(1.5), b_np), rtol=rtol)
+
+
+# Bytes read and written per second by the vectorized kernels, timed in a fresh interpreter like the import time
+def throughput(dtype):
+    code = '\n'.join([
+        'import numpy as np',
+        'import time',
+        'from edamer import dt, fn',
+        'a_np = np.asarray(np.random.default_rng(0).uniform(1, 2, (1 << 22, 4)), dtype=np.%s, order="F")' % dtype,
+        'b_np = np.empty_like(a_np, order="F")',
+        'a = dt.ElMatrix.view_from_numpy(a_np)',
+        'b = dt.ElMatrix.view_from_numpy(b_np)',
+        'def best(f):',
+        '    f()',
+        '    times = []',
+        '    for _ in range(5):',
+        '        t = time.perf_counter()',
+        '        f()',
+        '        times.append(time.perf_counter() - t)',
+        '    return min(times)',
+        # moments read a once, scaling reads a and writes b
+        'moments = a_np.nbytes / best(lambda: fn.var(a, 0, 1)) / 1e9',
+        'binary = 2 * a_np.nbytes / best(lambda: fn.times(a, 1.5, out=b)) / 1e9',
+        'print(moments, binary)'
+    ])
+    return [float(x) for x in detail.test.run(code).split()]
+
+
+# Allocates two matrices of up to 128MB each, hence it runs with EDAMER_BENCHMARKS=1 only, e.g.
+#   EDAMER_BENCHMARKS=1 python3 -m pytest --log-cli-level=INFO detail/simd/test.py -k throughput
+@detail.test.benchmark
+@pytest.mark.parametrize("dtype", ["float32", "float64"])
+def test_simd_throughput(dtype):
+    moments, binary = throughput(dtype)
+    # wall-clock times depend on the machine and its load, hence they are logged only
+    logging.info('%s: moments %.2f GB/s, binary %.2f GB/s', dtype, moments, binary)
+    assert moments > 0 and binary > 0
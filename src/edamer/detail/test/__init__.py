@@ -8,6 +8,24 @@
 from edamer import dt
 import numpy as np
 import logging
+import os
+import pytest
+import subprocess
+import sys
+
+# Benchmarks allocate large matrices and their timings are only logged, hence they run if EDAMER_BENCHMARKS is set only
+benchmark = pytest.mark.skipif(not os.environ.get('EDAMER_BENCHMARKS'), reason="set EDAMER_BENCHMARKS=1 to run")
+
+
+# Run Python code in a fresh interpreter, with all pydefs registered at import if eager, and return its output
+def run(code, eager=False):
+    env = dict(os.environ)
+    env.pop('EDAMER_EAGER_PYDEFS', None)
+    if eager:
+        env['EDAMER_EAGER_PYDEFS'] = '1'
+
+    out = subprocess.run([sys.executable, '-c', code], env=env, check=True, stdout=subprocess.PIPE)
+    return out.stdout.decode().strip()
 
 
 def to_numpy_1d(a):
@@ -18,6 +36,8 @@ def to_numpy_1d(a):
     elif isinstance(a, dt.ElDistColumnVector) or isinstance(a, dt.ElDistRowVector):
         dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
         return a.copy(dist_star_star_el).local().view_to_numpy()
+    elif isinstance(a, dt.ElAbstractDistMatrix):
+        return to_numpy_2d(a.typed())
     else:
         raise NotImplementedError("%s is not supported" % type(a))
 
@@ -30,6 +50,8 @@ def to_numpy_2d(a):
     elif isinstance(a, dt.ElDistMatrix):
         dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
         return a.copy(dist_star_star_el).local().view_to_numpy()
+    elif isinstance(a, dt.ElAbstractDistMatrix):
+        return to_numpy_2d(a.typed())
     else:
         raise NotImplementedError("%s is not supported" % type(a))
 
@@ -0,0 +1,224 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "impl.hpp"
+
+#include <boost/throw_exception.hpp>
+#include <condition_variable>
+#include <deque>
+#include <edamer/dt/exception.hpp>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+	#include <El.hpp>
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+
+/* Executes tasks in a single C++ thread in order of submission. One thread only, because tasks might call MPI
+ * collectives which have to be issued in the same order on all processes.
+ */
+class worker {
+public:
+	static worker &
+	instance() {
+		static worker w;
+		return w;
+	}
+	
+	void
+	submit(std::function<void()> task) {
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			if (!thread_.joinable()) {
+				stop_ = false;
+				thread_ = std::thread{[this]() { run(); }};
+			}
+			tasks_.push_back(std::move(task));
+		}
+		cv_.notify_one();
+	}
+	
+	// Wait until all submitted tasks have finished and stop the thread
+	void
+	join() {
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			stop_ = true;
+		}
+		cv_.notify_one();
+		
+		if (thread_.joinable()) {
+			thread_.join();
+		}
+	}
+	
+private:
+	void
+	run() {
+		for (;;) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock{mutex_};
+				cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+				if (tasks_.empty()) {
+					return;
+				}
+				task = std::move(tasks_.front());
+				tasks_.pop_front();
+			}
+			task();
+		}
+	}
+	
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::deque<std::function<void()>> tasks_;
+	bool stop_ = false;
+	std::thread thread_;
+};
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+/* Whether obj is or refers to distributed matrices or vectors, i.e. whether functions of edamer.fn issue MPI calls on
+ * it. Sequences, mappings, expression graph nodes and PCA results are searched for them too.
+ */
+bool
+distributed(py::handle obj) {
+	auto dt = py::module::import("edamer.cpp.dt");
+	for (char const* name : { "ElAbstractDistMatrix", "ElDistMatrix", "ElDistColumnVector", "ElDistRowVector" }) {
+		if (py::isinstance(obj, dt.attr(name))) {
+			return true;
+		}
+	}
+	
+	if (py::isinstance(obj, dt.attr("PcaResult"))) {
+		return distributed(obj.attr("coeff"));
+	}
+	
+	if (py::isinstance(obj, py::module::import("edamer.fn.graph").attr("Node"))) {
+		return distributed(obj.attr("args"));
+	}
+	
+	if (py::isinstance<py::dict>(obj)) {
+		for (auto item : obj.cast<py::dict>()) {
+			if (distributed(item.second)) {
+				return true;
+			}
+		}
+	}
+	
+	if (py::isinstance<py::tuple>(obj) || py::isinstance<py::list>(obj)) {
+		for (auto o : obj) {
+			if (distributed(o)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* The worker thread issues MPI calls for distributed operands while the main thread might issue MPI calls as well,
+ * e.g. by mpi4py. MPI permits calls from threads other than the main thread for MPI_THREAD_SERIALIZED and higher
+ * only, hence distributed operands are rejected below.
+ */
+void
+check_mpi_thread_level(py::args const& args, py::kwargs const& kwargs) {
+	int initialized = 0;
+	MPI_Initialized(&initialized);
+	if (!initialized) {
+		return;
+	}
+	
+	int provided = MPI_THREAD_SINGLE;
+	MPI_Query_thread(&provided);
+	if (provided < MPI_THREAD_SERIALIZED && (distributed(args) || distributed(kwargs))) {
+		BOOST_THROW_EXCEPTION((mpi_thread_level_not_supported_exception{} << errinfo_mpi_thread_level{provided}));
+	}
+}
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+
+py::object
+submit(py::function f, py::args args, py::kwargs kwargs) {
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+	check_mpi_thread_level(args, kwargs);
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+	
+	auto future = py::module::import("concurrent.futures").attr("Future")();
+	
+	/* Python objects may only be touched while holding the GIL, including their destruction, hence the task releases
+	 * them before returning to the worker thread.
+	 */
+	using state_t = std::optional<std::tuple<py::object, py::function, py::args, py::kwargs>>;
+	auto state = std::make_shared<state_t>(std::in_place, future, std::move(f), std::move(args), std::move(kwargs));
+	
+	worker::instance().submit([state]() {
+		py::gil_scoped_acquire gil;
+		auto & [future, f, args, kwargs] = **state;
+		
+		/* Exceptions must not escape the task, else the worker thread would call std::terminate(). Those which cannot
+		 * be passed to the future, e.g. because it is in an unexpected state, are reported as unraisable instead.
+		 */
+		try {
+			if (future.attr("set_running_or_notify_cancel")().cast<bool>()) {
+				try {
+					future.attr("set_result")(f(*args, **kwargs));
+				} catch (py::error_already_set & e) {
+					future.attr("set_exception")(e.value());
+				} catch (std::exception & e) {
+					future.attr("set_exception")(py::module::import("builtins").attr("RuntimeError")(e.what()));
+				}
+			}
+		} catch (py::error_already_set & e) {
+			e.discard_as_unraisable(future);
+		} catch (std::exception & e) {
+			PyErr_SetString(PyExc_RuntimeError, e.what());
+			PyErr_WriteUnraisable(future.ptr());
+		}
+		state->reset();
+	});
+	return future;
+}
+
+EDAMER_NAMESPACE_END(/* unnamed */)
+
+py::module &
+pydef_impl<worker_tag>::apply(py::module & m, py::module & base) {
+	m.def("submit", &submit,
+		py::arg("f"),
+		"Call f(*args, **kwargs) in a C++ worker thread and return a concurrent.futures.Future for its result. Calls "
+		"are executed one after another in order of submission. Functions in edamer.fn release the GIL while computing, "
+		"so other Python threads continue meanwhile. Distributed matrices and vectors in args or kwargs require MPI "
+		"to be initialized with MPI_THREAD_SERIALIZED or higher, else MpiThreadLevelNotSupportedException is raised. "
+		"If other threads issue MPI calls while the worker computes, MPI_THREAD_MULTIPLE is required.");
+	
+	// the worker thread must have finished before the interpreter and MPI shut down
+	py::module::import("atexit").attr("register")(py::cpp_function([]() {
+		py::gil_scoped_release release;
+		worker::instance().join();
+	}));
+	return m;
+}
+
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+from edamer import detail, dt, fn
+from mpi4py import MPI
+import concurrent.futures
+import numpy as np
+import pytest
+import threading
+
+
+def test_submit():
+    future = detail.submit(lambda a, b=0: a + b, 1, b=2)
+    assert isinstance(future, concurrent.futures.Future)
+    assert future.result() == 3
+
+
+def test_submit_order():
+    results = []
+    futures = [detail.submit(results.append, i) for i in range(100)]
+    concurrent.futures.wait(futures)
+    assert results == list(range(100))
+
+
+def test_submit_exception():
+    def fail():
+        raise ValueError("fail")
+
+    with pytest.raises(ValueError):
+        detail.submit(fail).result()
+
+
+def test_submit_unexpected_state():
+    started = threading.Event()
+    release = threading.Event()
+    calls = []
+
+    def block():
+        started.set()
+        release.wait()
+
+    blocking = detail.submit(block)
+    started.wait()
+    # finish the future before the worker starts it, set_running_or_notify_cancel() will raise then
+    future = detail.submit(calls.append, 1)
+    future.set_result(None)
+    cancelled = detail.submit(calls.append, 2)
+    assert cancelled.cancel()
+    release.set()
+
+    # the worker thread survives both and continues with subsequent tasks
+    assert detail.submit(lambda: 3).result() == 3
+    assert blocking.done() and calls == []
+
+
+def test_fn_async():
+    for dtype in detail.scalars():
+        a_np = np.asarray(np.arange(6).reshape(2, 3), order='F', dtype=dtype)
+        b_np = np.asarray(np.arange(6).reshape(3, 2), order='F', dtype=dtype)
+
+        future = fn.multiply_async(dt.ElMatrix.view_from_numpy(a_np), dt.ElMatrix.view_from_numpy(b_np))
+        assert isinstance(future, concurrent.futures.Future)
+        assert np.allclose(future.result().view_to_numpy(), a_np @ b_np)
+
+    with pytest.raises(TypeError):
+        fn.multiply_async(None, None).result()
+
+
+def test_fn_async_distributed():
+    comm = MPI.COMM_WORLD
+    grid = dt.ElGrid(comm)
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+
+    a_np = np.asarray(np.arange(6).reshape(2, 3), order='F', dtype=np.float64)
+    b_np = np.asarray(np.arange(6).reshape(3, 2), order='F', dtype=np.float64)
+    a_dist = dt.ElDistMatrix.make_view(grid, dt.ElMatrix.view_from_numpy(a_np), dist_star_star_el).copy(dist_mc_mr_el)
+    b_dist = dt.ElDistMatrix.make_view(grid, dt.ElMatrix.view_from_numpy(b_np), dist_star_star_el).copy(dist_mc_mr_el)
+
+    # the worker thread issues MPI calls for distributed operands, which MPI permits from MPI_THREAD_SERIALIZED on
+    if MPI.Query_thread() < MPI.THREAD_SERIALIZED:
+        with pytest.raises(dt.MpiThreadLevelNotSupportedException):
+            fn.multiply_async(a_dist, b_dist)
+        with pytest.raises(dt.MpiThreadLevelNotSupportedException):
+            fn.multiply_async(fn.Node('transpose', (b_dist,)), fn.Node('transpose', (a_dist,)))
+        with pytest.raises(dt.MpiThreadLevelNotSupportedException):
+            fn.mean_async(a=a_dist)
+    else:
+        c_dist = fn.multiply_async(a_dist, b_dist).result()
+        assert np.allclose(detail.test.to_numpy_2d(c_dist), a_np @ b_np)
+        c_dist = fn.transpose_async(c_dist).result()
+        assert np.allclose(detail.test.to_numpy_2d(c_dist), (a_np @ b_np).T)
+
+    # local operands are accepted regardless of the thread level
+    future = fn.multiply_async(dt.ElMatrix.view_from_numpy(a_np), dt.ElMatrix.view_from_numpy(b_np))
+    assert np.allclose(future.result().view_to_numpy(), a_np @ b_np)
@@ -6,3 +6,9 @@
 # Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
 
 from edamer.cpp.dt import *  # noqa 401
+
+
+def __getattr__(name):
+    # classes and functions of distributed matrices are registered on first use of their scalar type
+    import edamer.cpp.dt
+    return getattr(edamer.cpp.dt, name)
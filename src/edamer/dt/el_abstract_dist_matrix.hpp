@@ -0,0 +1,24 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EDAMER_DT_EL_ABSTRACT_DIST_MATRIX_HPP
+#define EDAMER_DT_EL_ABSTRACT_DIST_MATRIX_HPP
+
+#include "el_abstract_dist_matrix/fwd.hpp"
+#include "el_abstract_dist_matrix/impl.hpp"
+
+#endif // !EDAMER_DT_EL_ABSTRACT_DIST_MATRIX_HPP
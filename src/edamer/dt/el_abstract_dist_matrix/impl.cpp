@@ -0,0 +1,368 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "impl.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <algorithm>
+#include <boost/format.hpp>
+#include <boost/hana/concat.hpp>
+#include <boost/hana/first.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/second.hpp>
+#include <boost/hana/type.hpp>
+#include <edamer/detail/elemental.hpp>
+#include <edamer/detail/gather.hpp>
+#include <edamer/detail/npy.hpp>
+#include <edamer/detail/pybind11.hpp>
+#include <edamer/detail/scalar.hpp>
+#include <edamer/dt/matrix_distribution.hpp>
+#include <hbrs/mpl/dt/el_dist_matrix.hpp>
+#include <hbrs/mpl/dt/el_matrix.hpp>
+#include <hbrs/mpl/dt/exception.hpp>
+#include <hbrs/mpl/dt/matrix_size.hpp>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <pybind11/stl.h>
+#include <string>
+#include <vector>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace hana = boost::hana;
+namespace mpl = hbrs::mpl;
+
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+
+template<typename Ring>
+el_abstract_dist_matrix<Ring>
+make(
+	El::Grid const& grid,
+	El::Int height,
+	El::Int width,
+	El::Dist columnwise,
+	El::Dist rowwise,
+	El::DistWrap wrapping
+) {
+	auto data = detail::make_el_abstract_dist_matrix<Ring>(grid, columnwise, rowwise, wrapping);
+	data->Resize(height, width);
+	return el_abstract_dist_matrix<Ring>{data};
+}
+
+template<typename Ring>
+el_abstract_dist_matrix<Ring>
+make_view(
+	El::Grid const& grid,
+	mpl::el_matrix<Ring> & local,
+	El::Dist columnwise,
+	El::Dist rowwise,
+	El::DistWrap wrapping
+) {
+	return detail::with_el_matrix_distribution(columnwise, rowwise, wrapping,
+		[&grid, &local](auto columnwise_c, auto rowwise_c, auto wrapping_c) {
+			using global_t =
+				detail::el_dist_matrix_t<Ring, decltype(columnwise_c), decltype(rowwise_c), decltype(wrapping_c)>;
+			
+			auto global_el = std::make_shared<global_t>(grid);
+			global_el->Attach(
+				local.data().Height(), local.data().Width(), grid, 0, 0, local.data().Buffer(), local.data().LDim());
+			return el_abstract_dist_matrix<Ring>{global_el};
+		}
+	);
+}
+
+/* Assemble a matrix from row blocks of varying heights, one per process, which are stacked in the order of the ranks in
+ * the grid's VC communicator. Only the sizes of the row blocks are exchanged to compute their offsets, after which each
+ * row is sent directly to its owner in [VC,STAR]. Other matrix distributions are copied from [VC,STAR] subsequently.
+ * On a single process the row block is the whole matrix already, hence it is viewed instead of copied.
+ *
+ * Rows for each process are packed column by column, hence they arrive as a column-major block of consecutive local
+ * rows of [VC,STAR] which is unpacked column by column, too. MPI counts are ints, hence all processes throw
+ * mpi_count_overflow_exception if any process would send or receive more than INT_MAX entries.
+ */
+template<typename Ring>
+el_abstract_dist_matrix<Ring>
+from_row_blocks(
+	El::Grid const& grid,
+	mpl::el_matrix<Ring> & local,
+	El::Dist columnwise,
+	El::Dist rowwise,
+	El::DistWrap wrapping
+) {
+	El::mpi::Comm comm = grid.VCComm();
+	int const rank = El::mpi::Rank(comm);
+	int const size = El::mpi::Size(comm);
+	
+	auto const& local_el = local.data();
+	El::Int const local_size[2] = {local_el.Height(), local_el.Width()};
+	std::vector<El::Int> sizes(2 * size);
+	El::mpi::AllGather(local_size, 2, sizes.data(), 2, comm);
+	
+	El::Int const width = local_el.Width();
+	std::vector<El::Int> offsets(size + 1, 0);
+	for (int r = 0; r < size; ++r) {
+		if (sizes[2 * r + 1] != width) {
+			BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{}
+				<< mpl::errinfo_el_matrix_size{{sizes[2 * r], sizes[2 * r + 1]}}));
+		}
+		offsets[r + 1] = offsets[r] + sizes[2 * r];
+	}
+	El::Int const height = offsets.back();
+	
+	if (size == 1) {
+		return make_view(grid, local, columnwise, rowwise, wrapping);
+	}
+	
+	// number of global rows below x which are owned by process q in [VC,STAR]
+	auto owned_below = [size](El::Int x, int q) { return x > q ? (x - q + size - 1) / size : El::Int{0}; };
+	// first row of process r's row block which is owned by process q, relative to the row block
+	auto first_owned = [size, &offsets](int r, int q) { return ((q - offsets[r]) % size + size) % size; };
+	
+	std::vector<El::Int> send_rows(size), recv_rows(size);
+	for (int q = 0; q < size; ++q) {
+		send_rows[q] = owned_below(offsets[rank + 1], q) - owned_below(offsets[rank], q);
+		recv_rows[q] = owned_below(offsets[q + 1], rank) - owned_below(offsets[q], rank);
+	}
+	
+	auto entries = [width](std::vector<El::Int> rows) {
+		for (auto & n : rows) {
+			n *= width;
+		}
+		return rows;
+	};
+	std::vector<int> const send_counts = detail::mpi_counts(entries(send_rows), comm);
+	std::vector<int> const recv_counts = detail::mpi_counts(entries(recv_rows), comm);
+	std::vector<int> send_displs(size, 0), recv_displs(size, 0);
+	std::partial_sum(send_counts.begin(), std::prev(send_counts.end()), std::next(send_displs.begin()));
+	std::partial_sum(recv_counts.begin(), std::prev(recv_counts.end()), std::next(recv_displs.begin()));
+	
+	Ring const* local_buf = local_el.LockedBuffer();
+	El::Int const local_ldim = local_el.LDim();
+	std::vector<Ring> send_buf(local_el.Height() * width);
+	for (int q = 0; q < size; ++q) {
+		Ring * n = send_buf.data() + send_displs[q];
+		for (El::Int j = 0; j < width; ++j) {
+			Ring const* column = local_buf + j * local_ldim;
+			for (El::Int i = first_owned(rank, q); i < local_el.Height(); i += size) {
+				*n++ = column[i];
+			}
+		}
+	}
+	
+	std::vector<Ring> recv_buf(std::accumulate(recv_counts.begin(), recv_counts.end(), std::size_t{0}));
+	El::mpi::AllToAll(
+		send_buf.data(), send_counts.data(), send_displs.data(),
+		recv_buf.data(), recv_counts.data(), recv_displs.data(),
+		comm);
+	
+	auto vc_star = std::make_shared<El::DistMatrix<Ring, El::VC, El::STAR>>(height, width, grid);
+	auto & vc_star_local = vc_star->Matrix();
+	for (int r = 0; r < size; ++r) {
+		if (recv_rows[r] == 0) {
+			continue;
+		}
+		
+		// local row of the first global row of process r's row block which is owned by this process
+		El::Int const first = (offsets[r] + first_owned(r, rank)) / size;
+		Ring const* n = recv_buf.data() + recv_displs[r];
+		for (El::Int j = 0; j < width; ++j, n += recv_rows[r]) {
+			std::copy(n, n + recv_rows[r], vc_star_local.Buffer(first, j));
+		}
+	}
+	
+	if (columnwise == El::VC && rowwise == El::STAR && wrapping == El::ELEMENT) {
+		return el_abstract_dist_matrix<Ring>{vc_star};
+	}
+	
+	auto to = detail::make_el_abstract_dist_matrix<Ring>(grid, columnwise, rowwise, wrapping);
+	El::Copy(*vc_star, *to);
+	return el_abstract_dist_matrix<Ring>{to};
+}
+
+template<typename Ring>
+mpl::el_matrix<Ring>
+local(el_abstract_dist_matrix<Ring> & matrix) {
+	decltype(auto) local = matrix.data().Matrix();
+	return mpl::el_matrix<Ring>{El::Matrix<Ring>{local.Height(), local.Width(), local.Buffer(), local.LDim()}};
+}
+
+template<typename Ring>
+el_abstract_dist_matrix<Ring>
+copy(
+	el_abstract_dist_matrix<Ring> const& from,
+	std::optional<El::Dist> columnwise,
+	std::optional<El::Dist> rowwise,
+	std::optional<El::DistWrap> wrapping
+) {
+	auto to = detail::make_el_abstract_dist_matrix<Ring>(
+		from.data().Grid(),
+		columnwise.value_or(from.data().ColDist()),
+		rowwise.value_or(from.data().RowDist()),
+		wrapping.value_or(from.data().Wrap()));
+	
+	// El::Copy() redistributes between any pair of matrix distributions at runtime
+	El::Copy(from.data(), *to);
+	return el_abstract_dist_matrix<Ring>{to};
+}
+
+template<typename Ring>
+py::object
+typed(el_abstract_dist_matrix<Ring> & matrix) {
+	detail::require_pydefs<Ring>();
+	return detail::visit_el_dist_matrix(matrix, [](auto & typed) { return py::cast(std::move(typed)); });
+}
+
+EDAMER_NAMESPACE_END(/* unnamed */)
+
+py::module &
+pydef_impl<el_abstract_dist_matrix_tag>::apply(py::module & m, py::module & base) {
+	// El::DistMatrix<> does not support const-qualified or unsigned or long types
+	auto ring_tns = hana::concat(detail::scalars, detail::complex_scalars);
+	
+	auto py_el_abstract_dist_matrix =
+		py::class_<el_abstract_dist_matrix_tag>{m, pystrip("el_abstract_dist_matrix").c_str()};
+	
+	/* One class per ring instead of one class per ring and matrix distribution, hence this is cheap enough to be
+	 * registered at import time. Code for a specific matrix distribution is selected when functions are called.
+	 */
+	hana::for_each(ring_tns, [&m, &py_el_abstract_dist_matrix](auto ring_tn) {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		auto ring_n = hana::second(ring_tn);
+		
+		using matrix_t = el_abstract_dist_matrix<ring_t>;
+		auto name = boost::format("el_abstract_dist_matrix<%s>") % ring_n;
+		
+		/* store template function pointers in variables to work around
+		 * "unresolved overloaded function type" errors with GCC9/10
+		 */
+		constexpr auto make_ptr = &make<ring_t>;
+		constexpr auto make_view_ptr = &make_view<ring_t>;
+		constexpr auto from_row_blocks_ptr = &from_row_blocks<ring_t>;
+		constexpr auto local_ptr = &local<ring_t>;
+		constexpr auto copy_ptr = &copy<ring_t>;
+		constexpr auto typed_ptr = &typed<ring_t>;
+		
+		py::class_<matrix_t>{m, pystrip(name.str()).c_str(), py_el_abstract_dist_matrix}
+			.def(py::init(make_ptr),
+				py::arg("grid"),
+				py::arg("height"),
+				py::arg("width"),
+				py::arg("columnwise") = El::MC,
+				py::arg("rowwise") = El::MR,
+				py::arg("wrapping") = El::ELEMENT,
+				py::keep_alive<1, 2>()
+			)
+			.def("size",
+				[](matrix_t const& a) {
+					return mpl::matrix_size<El::Int, El::Int>{a.data().Height(), a.data().Width()};
+				}
+			)
+			.def("local", local_ptr, py::keep_alive<0, 1>())
+			.def("participating",
+				[](matrix_t const& a) { return a.data().Participating(); },
+				"Return True if this process can be assigned matrix data"
+			)
+			.def_property_readonly("columnwise", [](matrix_t const& a) { return a.data().ColDist(); })
+			.def_property_readonly("rowwise", [](matrix_t const& a) { return a.data().RowDist(); })
+			.def_property_readonly("wrapping", [](matrix_t const& a) { return a.data().Wrap(); })
+			.def("copy", copy_ptr,
+				py::arg("columnwise") = py::none(),
+				py::arg("rowwise") = py::none(),
+				py::arg("wrapping") = py::none(),
+				"Copy to another matrix distribution, by default to the same matrix distribution"
+			)
+			.def("typed", typed_ptr, py::keep_alive<0, 1>(),
+				"Return a view of this matrix as el_dist_matrix of its current matrix distribution")
+			.def("write",
+				[](matrix_t const& a, std::string const& path) { detail::write_npy(a.data(), path); },
+				py::arg("path"),
+				py::call_guard<py::gil_scoped_release>(),
+				"Write this matrix collectively to a .npy file in column-major order")
+			.def("gather_into",
+				[](matrix_t const& a, py::object const& out, int root) {
+					detail::gather_into(a.data(), out, root);
+				},
+				py::arg("out"),
+				py::arg("root") = 0,
+				"Gather this matrix collectively into a preallocated Fortran-ordered array out on process root, "
+				"which is ignored on all other processes")
+			.def("scatter_from",
+				[](matrix_t & a, py::object const& in, int root) {
+					detail::scatter_from(in, root, a.data());
+				},
+				py::arg("in"),
+				py::arg("root") = 0,
+				"Resize this matrix to the shape of the Fortran-ordered array in on process root and scatter its "
+				"entries collectively, in is ignored on all other processes");
+		
+		py_el_abstract_dist_matrix.def_static("make_view",
+			make_view_ptr,
+			py::arg("grid"),
+			py::arg("local"),
+			py::arg("columnwise") = El::MC,
+			py::arg("rowwise") = El::MR,
+			py::arg("wrapping") = El::ELEMENT,
+			py::keep_alive<0, 1>(),
+			py::keep_alive<0, 2>()
+		);
+		
+		py_el_abstract_dist_matrix.def_static("from_row_blocks",
+			from_row_blocks_ptr,
+			py::arg("grid"),
+			py::arg("local"),
+			py::arg("columnwise") = El::VC,
+			py::arg("rowwise") = El::STAR,
+			py::arg("wrapping") = El::ELEMENT,
+			py::keep_alive<0, 1>(),
+			py::keep_alive<0, 2>(),
+			py::call_guard<py::gil_scoped_release>(),
+			"Assemble a matrix from row blocks of varying heights which are passed as local by each process"
+		);
+	});
+	
+	// The ring is not known before the header of the file has been read
+	py_el_abstract_dist_matrix.def_static("read",
+		[](
+			std::string const& path,
+			El::Grid const& grid,
+			El::Dist columnwise,
+			El::Dist rowwise,
+			El::DistWrap wrapping
+		) {
+			auto header = detail::without_gil([&]() { return detail::read_npy_header(grid.ViewingComm(), path); });
+			return detail::with_npy_ring(header.descr, [&](auto ring_c) {
+				using ring_t = typename decltype(ring_c)::type;
+				auto a = make<ring_t>(grid, 0, 0, columnwise, rowwise, wrapping);
+				detail::without_gil([&]() { detail::read_npy(path, a.data()); });
+				return py::cast(std::move(a));
+			});
+		},
+		py::arg("path"),
+		py::arg("grid"),
+		py::arg("columnwise") = El::MC,
+		py::arg("rowwise") = El::MR,
+		py::arg("wrapping") = El::ELEMENT,
+		py::keep_alive<0, 2>(),
+		"Read a matrix collectively from a .npy file which stores a matrix in column-major order"
+	);
+	return m;
+}
+
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
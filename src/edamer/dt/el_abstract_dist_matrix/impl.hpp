@@ -0,0 +1,205 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EDAMER_DT_EL_ABSTRACT_DIST_MATRIX_IMPL_HPP
+#define EDAMER_DT_EL_ABSTRACT_DIST_MATRIX_IMPL_HPP
+
+#include "fwd.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <algorithm>
+#include <boost/hana/at.hpp>
+#include <boost/hana/first.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/transform.hpp>
+#include <boost/throw_exception.hpp>
+#include <edamer/dt/exception.hpp>
+#include <edamer/dt/matrix_distribution.hpp>
+#include <El.hpp>
+#include <hbrs/mpl/dt/el_dist_matrix.hpp>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+
+/* Distributed matrix whose distribution is selected at runtime, in contrast to hbrs::mpl::el_dist_matrix where it is a
+ * template argument. Copies share the same El::AbstractDistMatrix.
+ */
+template<typename Ring>
+struct el_abstract_dist_matrix {
+	explicit
+	el_abstract_dist_matrix(std::shared_ptr<El::AbstractDistMatrix<Ring>> data) : data_{std::move(data)} {}
+	
+	template<El::Dist Columnwise, El::Dist Rowwise, El::DistWrap Wrapping>
+	explicit
+	el_abstract_dist_matrix(hbrs::mpl::el_dist_matrix<Ring, Columnwise, Rowwise, Wrapping> && matrix)
+	: data_{std::make_shared<El::DistMatrix<Ring, Columnwise, Rowwise, Wrapping>>(std::move(matrix.data()))} {}
+	
+	El::AbstractDistMatrix<Ring> &
+	data() { return *data_; }
+	
+	El::AbstractDistMatrix<Ring> const&
+	data() const { return *data_; }
+	
+private:
+	std::shared_ptr<El::AbstractDistMatrix<Ring>> data_;
+};
+
+EDAMER_NAMESPACE_BEGIN(detail)
+
+template<typename Ring, typename Columnwise, typename Rowwise, typename Wrapping>
+using el_dist_matrix_t = El::DistMatrix<Ring, Columnwise::value, Rowwise::value, Wrapping::value>;
+
+/* Call f(columnwise, rowwise, wrapping) with hana::integral_constant's of the entry in el_matrix_distributions which
+ * matches a matrix distribution given at runtime. f has to return the same type for all matrix distributions.
+ */
+template<typename F>
+auto
+with_el_matrix_distribution(El::Dist columnwise, El::Dist rowwise, El::DistWrap wrapping, F && f) {
+	auto first_ts = hana::transform(hana::at_c<0>(el_matrix_distributions), hana::first);
+	using result_t = decltype(f(hana::at_c<0>(first_ts), hana::at_c<1>(first_ts), hana::at_c<2>(first_ts)));
+	
+	std::optional<result_t> result;
+	hana::for_each(el_matrix_distributions, [&](auto distribution_tn) {
+		auto dist_ts = hana::transform(distribution_tn, hana::first);
+		
+		using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
+		using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
+		using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
+		
+		if (!result &&
+			columnwise == columnwise_t::value && rowwise == rowwise_t::value && wrapping == wrapping_t::value) {
+			result.emplace(f(columnwise_t{}, rowwise_t{}, wrapping_t{}));
+		}
+	});
+	
+	if (!result) {
+		BOOST_THROW_EXCEPTION((matrix_distribution_not_supported_exception{}
+			<< errinfo_el_matrix_distribution{{columnwise, rowwise, wrapping}}
+		));
+	}
+	return std::move(*result);
+}
+
+/* Allocate an empty El::DistMatrix of a matrix distribution given at runtime */
+template<typename Ring>
+std::shared_ptr<El::AbstractDistMatrix<Ring>>
+make_el_abstract_dist_matrix(El::Grid const& grid, El::Dist columnwise, El::Dist rowwise, El::DistWrap wrapping) {
+	return with_el_matrix_distribution(columnwise, rowwise, wrapping,
+		[&grid](auto columnwise_c, auto rowwise_c, auto wrapping_c) -> std::shared_ptr<El::AbstractDistMatrix<Ring>> {
+			return std::make_shared<
+				el_dist_matrix_t<Ring, decltype(columnwise_c), decltype(rowwise_c), decltype(wrapping_c)>>(grid);
+		}
+	);
+}
+
+/* Call f with a view of a as hbrs::mpl::el_dist_matrix of its current matrix distribution, i.e. code specialized for
+ * a matrix distribution is selected only here and not when exposing functions to Python.
+ */
+template<typename Ring, typename F>
+auto
+visit_el_dist_matrix(el_abstract_dist_matrix<Ring> & a, F && f) {
+	El::AbstractDistMatrix<Ring> & data = a.data();
+	return with_el_matrix_distribution(data.ColDist(), data.RowDist(), data.Wrap(),
+		[&data, &f](auto columnwise_c, auto rowwise_c, auto wrapping_c) {
+			using typed_t = el_dist_matrix_t<Ring, decltype(columnwise_c), decltype(rowwise_c), decltype(wrapping_c)>;
+			
+			typed_t view{data.Grid()};
+			El::View(view, static_cast<typed_t &>(data));
+			auto matrix = hbrs::mpl::make_el_dist_matrix(std::move(view));
+			return f(matrix);
+		}
+	);
+}
+
+template<typename Ring, typename F>
+auto
+visit_el_dist_matrix(el_abstract_dist_matrix<Ring> const& a, F && f) {
+	El::AbstractDistMatrix<Ring> const& data = a.data();
+	return with_el_matrix_distribution(data.ColDist(), data.RowDist(), data.Wrap(),
+		[&data, &f](auto columnwise_c, auto rowwise_c, auto wrapping_c) {
+			using typed_t = el_dist_matrix_t<Ring, decltype(columnwise_c), decltype(rowwise_c), decltype(wrapping_c)>;
+			
+			typed_t view{data.Grid()};
+			El::LockedView(view, static_cast<typed_t const&>(data));
+			auto const matrix = hbrs::mpl::make_el_dist_matrix(std::move(view));
+			return f(matrix);
+		}
+	);
+}
+
+/* View a typed distributed matrix, e.g. el_dist_matrix<double,MC,MR,ELEMENT>, as el_abstract_dist_matrix which shares
+ * its local matrix, hence functions which write into an output argument can be defined per ring instead of per ring
+ * and matrix distribution.
+ */
+inline py::object
+as_el_abstract_dist_matrix(py::object const& a) {
+	if (py::isinstance<el_abstract_dist_matrix_tag>(a)) {
+		return a;
+	}
+	
+	if (py::hasattr(a, "abstract")) {
+		py::object view = a.attr("abstract")();
+		if (py::isinstance<el_abstract_dist_matrix_tag>(view)) {
+			return view;
+		}
+	}
+	
+	throw py::type_error{
+		"expected a distributed matrix but got " + py::str(py::type::handle_of(a)).cast<std::string>()};
+}
+
+inline bool
+is_el_dist_matrix_object(PyObject * obj) {
+	py::handle h{obj};
+	return py::isinstance<el_abstract_dist_matrix_tag>(h) || py::hasattr(h, "abstract");
+}
+
+/* Python object of an el_abstract_dist_matrix or of a typed distributed matrix which can be viewed as such. Overloads
+ * with arguments of this type are defined once for all rings and matrix distributions, but unlike py::object arguments
+ * they do not match other types, i.e. pybind11 still tries subsequent overloads, e.g. for distributed vectors.
+ */
+class el_dist_matrix_object : public py::object {
+public:
+	PYBIND11_OBJECT_DEFAULT(el_dist_matrix_object, py::object, is_el_dist_matrix_object)
+};
+
+/* Whether any of the objects has a view as el_abstract_dist_matrix. Functions which retry a call with views of their
+ * arguments have to check this first, else they would retry endlessly with arguments which do not match.
+ */
+inline bool
+has_el_abstract_dist_matrix_view(std::initializer_list<py::handle> objs) {
+	return std::any_of(objs.begin(), objs.end(), [](py::handle obj) { return py::hasattr(obj, "abstract"); });
+}
+
+EDAMER_NAMESPACE_END(detail)
+
+template <>
+struct EDAMER_API pydef_impl<el_abstract_dist_matrix_tag> {
+	static py::module &
+	apply(py::module & m, py::module & base);
+};
+
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DT_EL_ABSTRACT_DIST_MATRIX_IMPL_HPP
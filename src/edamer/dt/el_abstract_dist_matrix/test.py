@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+from edamer import detail, dt, fn
+import logging # noqa F401
+from mpi4py import MPI
+import numpy as np
+import pytest
+
+
+@pytest.fixture
+def env():
+    class Environment():
+        comm = MPI.COMM_WORLD
+        size = comm.Get_size()
+        rank = comm.Get_rank()
+        grid = dt.ElGrid(comm)
+        m = 1000  # matrix height
+        n = 2000  # matrix width
+    return Environment()
+
+
+def test_ctor(env):
+    if np.double not in detail.scalars():
+        pytest.skip("unsupported configuration")
+
+    dmat_el = dt.ElAbstractDistMatrix_Double(env.grid, 2, 3, dt.ElDist.VC, dt.ElDist.STAR)
+    assert dmat_el.size().m == 2
+    assert dmat_el.size().n == 3
+    assert dmat_el.columnwise == dt.ElDist.VC
+    assert dmat_el.rowwise == dt.ElDist.STAR
+    assert dmat_el.wrapping == dt.ElDistWrap.ELEMENT
+
+
+def test_make_view(env):
+    for dtype in detail.scalars() + detail.complex_scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np)
+
+        dmat_el = dt.ElAbstractDistMatrix.make_view(env.grid, mat_el, dt.ElDist.STAR, dt.ElDist.STAR)
+        assert isinstance(dmat_el, dt.ElAbstractDistMatrix)
+        assert dmat_el.size().m == env.m
+        assert dmat_el.size().n == env.n
+
+        lcl_np = dmat_el.local().view_to_numpy()
+        lcl_np[1, 3] = -1337
+        assert mat_np[1, 3] == -1337
+
+
+def test_copy_redist(env):
+    for dtype in detail.scalars() + detail.complex_scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np)
+
+        dmat_star_star_el = dt.ElAbstractDistMatrix.make_view(env.grid, mat_el, dt.ElDist.STAR, dt.ElDist.STAR)
+        dmat_mc_mr_el = dmat_star_star_el.copy(dt.ElDist.MC, dt.ElDist.MR)
+        dmat_circ_circ_el = dmat_mc_mr_el.copy(dt.ElDist.CIRC, dt.ElDist.CIRC)
+        assert dmat_mc_mr_el.columnwise == dt.ElDist.MC
+        assert dmat_mc_mr_el.rowwise == dt.ElDist.MR
+        assert dmat_circ_circ_el.size().m == env.m
+        assert dmat_circ_circ_el.size().n == env.n
+
+        if env.rank == 0:
+            assert np.array_equal(mat_np, dmat_circ_circ_el.local().view_to_numpy())
+
+
+def test_from_row_blocks(env):
+    n = 7
+    # process r contributes r+1 rows, i.e. row blocks of varying heights
+    heights = [r+1 for r in range(env.size)]
+    offset = sum(heights[:env.rank])
+    m = sum(heights)
+
+    for dtype in detail.scalars() + detail.complex_scalars():
+        mat_np = np.asarray(np.arange(m*n).reshape(m, n), order='F', dtype=dtype)
+        blk_np = np.asfortranarray(mat_np[offset:offset+heights[env.rank], :])
+        # view with a leading dimension larger than its height
+        blk_view_np = mat_np[offset:offset+heights[env.rank], :]
+
+        for blk_el, (columnwise, rowwise) in [
+            (dt.ElMatrix.view_from_numpy(blk_np), (dt.ElDist.VC, dt.ElDist.STAR)),
+            (dt.ElMatrix.view_from_numpy(blk_np), (dt.ElDist.MC, dt.ElDist.MR)),
+            (dt.ElMatrix.view_from_numpy(blk_view_np), (dt.ElDist.VC, dt.ElDist.STAR)),
+        ]:
+            dmat_el = dt.ElAbstractDistMatrix.from_row_blocks(env.grid, blk_el, columnwise, rowwise)
+            assert dmat_el.size().m == m
+            assert dmat_el.size().n == n
+            assert dmat_el.columnwise == columnwise
+            assert dmat_el.rowwise == rowwise
+
+            dmat_circ_circ_el = dmat_el.copy(dt.ElDist.CIRC, dt.ElDist.CIRC)
+            if env.rank == 0:
+                assert np.array_equal(mat_np, dmat_circ_circ_el.local().view_to_numpy())
+
+
+def test_typed(env):
+    for dtype in detail.scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np)
+
+        dmat_el = dt.ElAbstractDistMatrix.make_view(env.grid, mat_el, dt.ElDist.STAR, dt.ElDist.STAR)
+        typed_el = dmat_el.typed()
+        assert isinstance(typed_el, dt.ElDistMatrix)
+
+        abstract_el = typed_el.abstract()
+        assert isinstance(abstract_el, dt.ElAbstractDistMatrix)
+
+        abstract_el.local().view_to_numpy()[1, 3] = -1337
+        assert mat_np[1, 3] == -1337
+
+
+def test_fn(env):
+    for dtype in detail.scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np)
+
+        dmat_el = dt.ElAbstractDistMatrix.make_view(env.grid, mat_el, dt.ElDist.STAR, dt.ElDist.STAR)
+        dmat_mc_mr_el = dmat_el.copy(dt.ElDist.MC, dt.ElDist.MR)
+
+        assert fn.size(dmat_el).m == env.m
+        assert fn.transpose(dmat_el).size().m == env.n
+        assert fn.size(fn.transpose(dmat_el).eval()).m == env.n
+        assert fn.size(fn.multiply(dmat_mc_mr_el, fn.transpose(dmat_el))).m == env.m
+        assert fn.size(fn.multiply(dmat_mc_mr_el, fn.transpose(dmat_el))).n == env.m
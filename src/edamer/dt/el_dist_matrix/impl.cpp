@@ -30,14 +30,20 @@
 #include <boost/hana/second.hpp>
 #include <boost/hana/zip.hpp>
 #include <boost/throw_exception.hpp>
+#include <edamer/detail/gather.hpp>
+#include <edamer/detail/npy.hpp>
+#include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
+#include <edamer/dt/el_abstract_dist_matrix.hpp>
 #include <edamer/dt/el_complex.hpp>
 #include <edamer/dt/exception.hpp>
 #include <edamer/dt/matrix_distribution.hpp>
 #include <hbrs/mpl/dt/el_dist_matrix/impl.hpp>
 #include <hbrs/mpl/dt/el_matrix.hpp>
 #include <hbrs/mpl/dt/matrix_distribution.hpp>
+#include <memory>
 #include <pybind11/numpy.h>
+#include <string>
 #include <tuple>
 #include <unordered_map>
 
@@ -63,6 +69,8 @@ make_view(
 		hana::integral_constant<El::DistWrap, Wrapping>
 	>
 ) {
+	detail::require_pydefs<Ring>();
+	
 	using Ring_no_Ref = std::remove_const_t<Ring>;
 	El::DistMatrix<Ring_no_Ref, Columnwise, Rowwise, Wrapping> global_el {grid};
 	
@@ -77,6 +85,35 @@ make_view(
 	}
 }
 
+/* The ring is not known before the header of the file has been read, hence read() is defined per matrix distribution
+ * only and executes the deferred registrations of the ring found in the file.
+ */
+template<
+	El::Dist Columnwise,
+	El::Dist Rowwise,
+	El::DistWrap Wrapping
+>
+py::object
+read(
+	std::string const& path,
+	El::Grid const& grid,
+	mpl::matrix_distribution<
+		hana::integral_constant<El::Dist, Columnwise>,
+		hana::integral_constant<El::Dist, Rowwise>,
+		hana::integral_constant<El::DistWrap, Wrapping>
+	> const&
+) {
+	auto header = detail::without_gil([&]() { return detail::read_npy_header(grid.ViewingComm(), path); });
+	return detail::with_npy_ring(header.descr, [&](auto ring_c) {
+		using ring_t = typename decltype(ring_c)::type;
+		detail::require_pydefs<ring_t>();
+		
+		El::DistMatrix<ring_t, Columnwise, Rowwise, Wrapping> global_el{grid};
+		detail::without_gil([&]() { detail::read_npy(path, global_el); });
+		return py::cast(mpl::make_el_dist_matrix(std::move(global_el)));
+	});
+}
+
 template<
 	typename Ring,
 	El::Dist Columnwise,
@@ -97,6 +134,19 @@ local(py::object &obj) {
 	}
 }
 
+template<
+	typename Ring,
+	El::Dist Columnwise,
+	El::Dist Rowwise,
+	El::DistWrap Wrapping
+>
+el_abstract_dist_matrix<Ring>
+abstract(mpl::el_dist_matrix<Ring, Columnwise, Rowwise, Wrapping> & matrix) {
+	auto view = std::make_shared<El::DistMatrix<Ring, Columnwise, Rowwise, Wrapping>>(matrix.data().Grid());
+	El::View(*view, matrix.data());
+	return el_abstract_dist_matrix<Ring>{view};
+}
+
 template<
 	typename Ring,
 	El::Dist FromColumnwise,
@@ -135,57 +185,45 @@ pydef_impl<hbrs::mpl::el_dist_matrix_tag>::apply(py::module & m, py::module & ba
 	using hbrs::mpl::el_dist_matrix_tag;
 	auto py_el_dist_matrix = py::class_<el_dist_matrix_tag>{m, pystrip("el_dist_matrix").c_str()};
 	
+	hana::for_each(el_matrix_distributions, [&py_el_dist_matrix](auto distribution_tn) {
+		auto dist_ts = hana::transform(distribution_tn, hana::first);
+		
+		using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
+		using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
+		using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
+		
+		/* store template function pointers in variables to work around
+		* "unresolved overloaded function type" errors with GCC9/10
+		*/
+		constexpr auto read_ptr = &read<columnwise_t::value, rowwise_t::value, wrapping_t::value>;
+		
+		py_el_dist_matrix.def_static("read",
+			read_ptr,
+			py::arg("path"),
+			py::arg("grid"),
+			py::arg("dist"),
+			py::keep_alive<0, 2>(),
+			"Read a matrix collectively from a .npy file which stores a matrix in column-major order"
+		);
+	});
+	
 	hana::for_each(ring_tns, [&m, &py_el_dist_matrix](auto ring_tn) {
 		using ring_t = typename decltype(+hana::first(ring_tn))::type;
-		auto ring_n = hana::second(ring_tn);
 		
-		/* Make class_<> objects known to pybind11 first and add their methods later. This is required to handle
-		 * circular dependencies between distributed matrices, e.g. it will enable Python's help() function to print the
-		 * Python class names instead of printing the C++ class names for the copy() member function.
+		/* Making a view of a local matrix is the entry point to distributed matrices of a ring, hence make_view() is
+		 * registered at import time and executes the deferred registrations of its ring.
 		 */
-		auto py_el_dist_matrix_insts = hana::transform(el_matrix_distributions, [&](auto distribution_tn) {
-			auto dist_ts = hana::transform(distribution_tn, hana::first);
-			auto dist_ns = hana::transform(distribution_tn, hana::second);
-			
-			auto name = boost::format("el_dist_matrix<%s,%s>") % ring_n %
-				hana::fold_left(dist_ns, [](std::string s, std::string name) { return s + ',' + name; });
-				
-			using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
-			using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
-			using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
-			
-			using dist_matrix_t = el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
-			
-			return py::class_<dist_matrix_t>{m, pystrip(name.str()).c_str(), py_el_dist_matrix};
-		});
-		
-		// Now add class_<> functionality, e.g. member functions
-		hana::for_each(hana::zip(el_matrix_distributions, py_el_dist_matrix_insts), [&](auto zipped) {
-			auto distribution_tn = hana::at_c<0>(zipped);
-			auto py_el_dist_matrix_inst = hana::at_c<1>(zipped);
-				
+		hana::for_each(el_matrix_distributions, [&](auto distribution_tn) {
 			auto dist_ts = hana::transform(distribution_tn, hana::first);
 			
 			using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
 			using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
 			using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
 			
-			using dist_matrix_t = el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
-			
 			/* store template function pointers in variables to work around
 			* "unresolved overloaded function type" errors with GCC9/10
 			*/
 			constexpr auto make_view_ptr = &make_view<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
-			constexpr auto size_ptr = &dist_matrix_t::size;
-			constexpr auto local_ptr = &local<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
-			constexpr auto participating_ptr = &dist_matrix_t::participating;
-			
-			py_el_dist_matrix_inst
-				.def(py::init<El::Grid const&, El::Int, El::Int>(), py::keep_alive<1, 2>())
-				.def("size", size_ptr)
-				.def("local", local_ptr, py::keep_alive<0, 1>())
-				.def("participating", participating_ptr, "Return True if this process can be assigned matrix data")
-				;
 			
 			py_el_dist_matrix.def_static("make_view",
 				py::overload_cast<
@@ -200,65 +238,142 @@ pydef_impl<hbrs::mpl::el_dist_matrix_tag>::apply(py::module & m, py::module & ba
 				py::keep_alive<0, 1>(),
 				py::keep_alive<0, 2>()
 			);
+		});
+		
+		detail::defer_pydef(typeid(ring_t), [m, py_el_dist_matrix, ring_tn]() mutable {
+			auto ring_n = hana::second(ring_tn);
+			
+			/* Make class_<> objects known to pybind11 first and add their methods later. This is required to handle
+			 * circular dependencies between distributed matrices, e.g. it will enable Python's help() function to print
+			 * the Python class names instead of printing the C++ class names for the copy() member function.
+			 */
+			auto py_el_dist_matrix_insts = hana::transform(el_matrix_distributions, [&](auto distribution_tn) {
+				auto dist_ts = hana::transform(distribution_tn, hana::first);
+				auto dist_ns = hana::transform(distribution_tn, hana::second);
+				
+				auto name = boost::format("el_dist_matrix<%s,%s>") % ring_n %
+					hana::fold_left(dist_ns, [](std::string s, std::string name) { return s + ',' + name; });
+					
+				using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
+				using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
+				using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
+				
+				using dist_matrix_t = el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
+				
+				return py::class_<dist_matrix_t>{m, pystrip(name.str()).c_str(), py_el_dist_matrix};
+			});
 			
-			hana::for_each(el_matrix_distributions, [&](auto to_distribution_tn) {
-				using from_columnwise_t = columnwise_t;
-				using from_rowwise_t = rowwise_t;
-				using from_wrapping_t = wrapping_t;
-				auto to_dist_ts = hana::transform(to_distribution_tn, hana::first);
-				using to_columnwise_t = std::decay_t<decltype(hana::at_c<0>(to_dist_ts))>;
-				using to_rowwise_t = std::decay_t<decltype(hana::at_c<1>(to_dist_ts))>;
-				using to_wrapping_t = std::decay_t<decltype(hana::at_c<2>(to_dist_ts))>;
+			// Now add class_<> functionality, e.g. member functions
+			hana::for_each(hana::zip(el_matrix_distributions, py_el_dist_matrix_insts), [&](auto zipped) {
+				auto distribution_tn = hana::at_c<0>(zipped);
+				auto py_el_dist_matrix_inst = hana::at_c<1>(zipped);
+					
+				auto dist_ts = hana::transform(distribution_tn, hana::first);
+				
+				using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
+				using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
+				using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
+				
+				using dist_matrix_t = el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
+				
+				/* store template function pointers in variables to work around
+				* "unresolved overloaded function type" errors with GCC9/10
+				*/
+				constexpr auto size_ptr = &dist_matrix_t::size;
+				constexpr auto local_ptr = &local<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
+				constexpr auto participating_ptr = &dist_matrix_t::participating;
+				constexpr auto abstract_ptr =
+					&abstract<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
+				
+				py_el_dist_matrix_inst
+					.def(py::init<El::Grid const&, El::Int, El::Int>(), py::keep_alive<1, 2>())
+					.def("size", size_ptr)
+					.def("local", local_ptr, py::keep_alive<0, 1>())
+					.def("participating", participating_ptr, "Return True if this process can be assigned matrix data")
+					.def("abstract", abstract_ptr, py::keep_alive<0, 1>(),
+						"Return a view of this matrix whose matrix distribution is selected at runtime")
+					.def("write",
+						[](dist_matrix_t const& a, std::string const& path) { detail::write_npy(a.data(), path); },
+						py::arg("path"),
+						py::call_guard<py::gil_scoped_release>(),
+						"Write this matrix collectively to a .npy file in column-major order")
+					.def("gather_into",
+						[](dist_matrix_t const& a, py::object const& out, int root) {
+							detail::gather_into(a.data(), out, root);
+						},
+						py::arg("out"),
+						py::arg("root") = 0,
+						"Gather this matrix collectively into a preallocated Fortran-ordered array out on process "
+						"root, which is ignored on all other processes")
+					.def("scatter_from",
+						[](dist_matrix_t & a, py::object const& in, int root) {
+							detail::scatter_from(in, root, a.data());
+						},
+						py::arg("in"),
+						py::arg("root") = 0,
+						"Resize this matrix to the shape of the Fortran-ordered array in on process root and "
+						"scatter its entries collectively, in is ignored on all other processes")
+					;
 				
-				constexpr auto copy_ptr = &copy<
-					ring_t,
-					from_columnwise_t::value, from_rowwise_t::value, from_wrapping_t::value,
-					to_columnwise_t::value, to_rowwise_t::value, to_wrapping_t::value
-				>;
+				hana::for_each(el_matrix_distributions, [&](auto to_distribution_tn) {
+					using from_columnwise_t = columnwise_t;
+					using from_rowwise_t = rowwise_t;
+					using from_wrapping_t = wrapping_t;
+					auto to_dist_ts = hana::transform(to_distribution_tn, hana::first);
+					using to_columnwise_t = std::decay_t<decltype(hana::at_c<0>(to_dist_ts))>;
+					using to_rowwise_t = std::decay_t<decltype(hana::at_c<1>(to_dist_ts))>;
+					using to_wrapping_t = std::decay_t<decltype(hana::at_c<2>(to_dist_ts))>;
+					
+					constexpr auto copy_ptr = &copy<
+						ring_t,
+						from_columnwise_t::value, from_rowwise_t::value, from_wrapping_t::value,
+						to_columnwise_t::value, to_rowwise_t::value, to_wrapping_t::value
+					>;
 
-				if /* constexpr // but does not compile with GCC9/10 */ (
-					std::is_same_v<from_columnwise_t, to_columnwise_t> &&
-					std::is_same_v<from_rowwise_t, to_rowwise_t> &&
-					std::is_same_v<from_wrapping_t, to_wrapping_t>) {
-					// Allow to call copy() without an argument to create a copy with the same matrix distribution
-					py_el_dist_matrix_inst.def("copy",
-						py::overload_cast<
-							mpl::el_dist_matrix<
-								ring_t,
-								from_columnwise_t::value,
-								from_rowwise_t::value,
-								from_wrapping_t::value
-							> const&,
-							mpl::matrix_distribution<
-								hana::integral_constant<El::Dist, to_columnwise_t::value>,
-								hana::integral_constant<El::Dist, to_rowwise_t::value>,
-								hana::integral_constant<El::DistWrap, to_wrapping_t::value>
-							> const&
-						>(copy_ptr),
-						py::arg("to_dist") = mpl::make_matrix_distribution(
-							hana::integral_constant<El::Dist, to_columnwise_t::value>{},
-							hana::integral_constant<El::Dist, to_rowwise_t::value>{},
-							hana::integral_constant<El::DistWrap, to_wrapping_t::value>{}
-						)
-					);
-				} else {
-					py_el_dist_matrix_inst.def("copy",
-						py::overload_cast<
-							mpl::el_dist_matrix<
-								ring_t,
-								from_columnwise_t::value,
-								from_rowwise_t::value,
-								from_wrapping_t::value
-							> const&,
-							mpl::matrix_distribution<
-								hana::integral_constant<El::Dist, to_columnwise_t::value>,
-								hana::integral_constant<El::Dist, to_rowwise_t::value>,
-								hana::integral_constant<El::DistWrap, to_wrapping_t::value>
-							> const&
-						>(copy_ptr),
-						py::arg("to_dist")
-					);
-				}
+					if /* constexpr // but does not compile with GCC9/10 */ (
+						std::is_same_v<from_columnwise_t, to_columnwise_t> &&
+						std::is_same_v<from_rowwise_t, to_rowwise_t> &&
+						std::is_same_v<from_wrapping_t, to_wrapping_t>) {
+						// Allow to call copy() without an argument to create a copy with the same matrix distribution
+						py_el_dist_matrix_inst.def("copy",
+							py::overload_cast<
+								mpl::el_dist_matrix<
+									ring_t,
+									from_columnwise_t::value,
+									from_rowwise_t::value,
+									from_wrapping_t::value
+								> const&,
+								mpl::matrix_distribution<
+									hana::integral_constant<El::Dist, to_columnwise_t::value>,
+									hana::integral_constant<El::Dist, to_rowwise_t::value>,
+									hana::integral_constant<El::DistWrap, to_wrapping_t::value>
+								> const&
+							>(copy_ptr),
+							py::arg("to_dist") = mpl::make_matrix_distribution(
+								hana::integral_constant<El::Dist, to_columnwise_t::value>{},
+								hana::integral_constant<El::Dist, to_rowwise_t::value>{},
+								hana::integral_constant<El::DistWrap, to_wrapping_t::value>{}
+							)
+						);
+					} else {
+						py_el_dist_matrix_inst.def("copy",
+							py::overload_cast<
+								mpl::el_dist_matrix<
+									ring_t,
+									from_columnwise_t::value,
+									from_rowwise_t::value,
+									from_wrapping_t::value
+								> const&,
+								mpl::matrix_distribution<
+									hana::integral_constant<El::Dist, to_columnwise_t::value>,
+									hana::integral_constant<El::Dist, to_rowwise_t::value>,
+									hana::integral_constant<El::DistWrap, to_wrapping_t::value>
+								> const&
+							>(copy_ptr),
+							py::arg("to_dist")
+						);
+					}
+				});
 			});
 		});
 	});
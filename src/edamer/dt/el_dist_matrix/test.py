@@ -9,7 +9,10 @@ from edamer import detail, dt
 import logging # noqa F401
 from mpi4py import MPI
 import numpy as np
+import os
 import pytest
+import shutil
+import tempfile
 
 
 @pytest.fixture
@@ -131,3 +134,104 @@ def test_copy_redist(env):
             # To do so, set and export the OMPI_MCA_pml variable before executing the unit tests:
             #  export OMPI_MCA_pml=ob1
             assert np.array_equal(lcl_star_star_np, lcl_circ_circ_np)
+
+
+def test_read_write(env):
+    # all processes must access the same file
+    tmpdir = env.comm.bcast(tempfile.mkdtemp() if env.rank == 0 else None, root=0)
+    path = os.path.join(tmpdir, 'matrix.npy')
+
+    for dtype in detail.scalars() + detail.complex_scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np)
+
+        dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+        dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+        dist_vc_star_el = dt.MatrixDistribution.make(dt.ElDist.VC, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+        dist_circ_circ_el = dt.MatrixDistribution.make(dt.ElDist.CIRC, dt.ElDist.CIRC, dt.ElDistWrap.ELEMENT)
+
+        dmat_star_star_el = dt.ElDistMatrix.make_view(env.grid, mat_el, dist_star_star_el)
+        dmat_star_star_el.copy(dist_mc_mr_el).write(path)
+        env.comm.Barrier()
+
+        if env.rank == 0:
+            file_np = np.load(path, mmap_mode='r')
+            assert file_np.dtype == mat_np.dtype
+            assert np.isfortran(file_np)
+            assert np.array_equal(file_np, mat_np)
+
+        dmat_vc_star_el = dt.ElDistMatrix.read(path, env.grid, dist_vc_star_el)
+        assert dmat_vc_star_el.size().m == env.m
+        assert dmat_vc_star_el.size().n == env.n
+
+        dmat_circ_circ_el = dmat_vc_star_el.copy(dist_circ_circ_el)
+        if env.rank == 0:
+            assert np.array_equal(dmat_circ_circ_el.local().view_to_numpy(), mat_np)
+
+        dmat_el = dt.ElAbstractDistMatrix.read(path, env.grid, dt.ElDist.MC, dt.ElDist.MR)
+        assert dmat_el.size().m == env.m
+        env.comm.Barrier()
+
+    if env.rank == 0:
+        shutil.rmtree(tmpdir)
+
+
+def test_read_errors(env):
+    tmpdir = env.comm.bcast(tempfile.mkdtemp() if env.rank == 0 else None, root=0)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+
+    with pytest.raises(dt.FileAccessFailedException):
+        dt.ElDistMatrix.read(os.path.join(tmpdir, 'missing.npy'), env.grid, dist_mc_mr_el)
+
+    path = os.path.join(tmpdir, 'invalid.npy')
+    if env.rank == 0:
+        with open(path, 'wb') as f:
+            f.write(b'\x93NUMPY\x01\x00' + bytes(118))
+    env.comm.Barrier()
+
+    # errors are raised on all processes, which then continue with subsequent collective calls instead of blocking
+    with pytest.raises((dt.FileFormatNotSupportedException, dt.FileAccessFailedException)):
+        dt.ElDistMatrix.read(path, env.grid, dist_mc_mr_el)
+    with pytest.raises((dt.FileFormatNotSupportedException, dt.FileAccessFailedException)):
+        dt.ElAbstractDistMatrix.read(path, env.grid, dt.ElDist.MC, dt.ElDist.MR)
+    env.comm.Barrier()
+
+    if env.rank == 0:
+        shutil.rmtree(tmpdir)
+
+
+def test_gather_into_scatter_from(env):
+    root = env.size - 1
+    for dtype in detail.scalars() + detail.complex_scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np)
+
+        dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+        dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+        dist_vc_star_el = dt.MatrixDistribution.make(dt.ElDist.VC, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+        dist_circ_circ_el = dt.MatrixDistribution.make(dt.ElDist.CIRC, dt.ElDist.CIRC, dt.ElDistWrap.ELEMENT)
+
+        dmat_star_star_el = dt.ElDistMatrix.make_view(env.grid, mat_el, dist_star_star_el)
+        for dist in [dist_star_star_el, dist_mc_mr_el, dist_vc_star_el]:
+            out_np = np.zeros((env.m, env.n), order='F', dtype=dtype) if env.rank == root else None
+            dmat_star_star_el.copy(dist).gather_into(out_np, root=root)
+            if env.rank == root:
+                assert np.array_equal(out_np, mat_np)
+
+        # column slices of Fortran-ordered arrays have contiguous columns, too
+        out_np = np.zeros((env.m, env.n+1), order='F', dtype=dtype)
+        dmat_star_star_el.copy(dist_mc_mr_el).abstract().gather_into(out_np[:, 1:])
+        if env.rank == 0:
+            assert np.array_equal(out_np[:, 1:], mat_np)
+
+        dmat_mc_mr_el = dmat_star_star_el.copy(dist_mc_mr_el)
+        dmat_mc_mr_el.scatter_from(2*mat_np if env.rank == root else None, root=root)
+        assert dmat_mc_mr_el.size().m == env.m
+        assert dmat_mc_mr_el.size().n == env.n
+
+        dmat_circ_circ_el = dmat_mc_mr_el.copy(dist_circ_circ_el)
+        if env.rank == 0:
+            assert np.array_equal(dmat_circ_circ_el.local().view_to_numpy(), 2*mat_np)
+
+        with pytest.raises(dt.IncompatibleNdarrayException):
+            dmat_mc_mr_el.gather_into(np.zeros((env.m, env.n), order='C', dtype=dtype))
@@ -30,6 +30,7 @@
 #include <boost/hana/second.hpp>
 #include <boost/hana/zip.hpp>
 #include <boost/throw_exception.hpp>
+#include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
 #include <edamer/dt/el_complex.hpp>
 #include <edamer/dt/exception.hpp>
@@ -64,6 +65,8 @@ namespace mpl = hbrs::mpl;
 			hana::integral_constant<El::DistWrap, Wrapping>                                                            \
 		>                                                                                                              \
 	) {                                                                                                                \
+		detail::require_pydefs<Ring>();                                                                                \
+		                                                                                                               \
 		using Ring_no_Ref = std::remove_const_t<Ring>;                                                                 \
 		El::DistMatrix<Ring_no_Ref, Columnwise, Rowwise, Wrapping> global_el {grid};                                   \
 		                                                                                                               \
@@ -166,7 +169,6 @@ namespace mpl = hbrs::mpl;
 		                                                                                                               \
 		hana::for_each(ring_tns, [&m, &py_el_dist_ ## vector_kind ## _vector](auto ring_tn) {                          \
 			using ring_t = typename decltype(+hana::first(ring_tn))::type;                                             \
-			auto ring_n = hana::second(ring_tn);                                                                       \
 			                                                                                                           \
 			/* store template function pointers in variables to work around                                            \
 			 * "unresolved overloaded function type" errors with GCC9/10                                               \
@@ -195,137 +197,143 @@ namespace mpl = hbrs::mpl;
 				py::keep_alive<0, 2>()                                                                                 \
 			);                                                                                                         \
 			                                                                                                           \
-			/* Make class_<> objects known to pybind11 first and add their methods later. This is required to handle   \
-			* circular dependencies between distributed matrices, e.g. it will enable Python's help() function to      \
-			* print the Python class names instead of printing the C++ class names for the copy() member function.     \
-			*/                                                                                                         \
-			auto py_el_dist_ ## vector_kind ## _vector_insts =                                                         \
-				hana::transform(el_matrix_distributions, [&](auto distribution_tn) {                                   \
-					auto dist_ts = hana::transform(distribution_tn, hana::first);                                      \
-					auto dist_ns = hana::transform(distribution_tn, hana::second);                                     \
-					                                                                                                   \
-					auto name = boost::format("el_dist_"#vector_kind"_vector<%s,%s>") % ring_n %                       \
-						hana::fold_left(dist_ns, [](std::string s, std::string name) { return s + ',' + name; });      \
+			/* Classes are registered on first use of their ring, e.g. by make_view() */                               \
+			detail::defer_pydef(typeid(ring_t), [m, py_el_dist_ ## vector_kind ## _vector, ring_tn]() mutable {        \
+				auto ring_n = hana::second(ring_tn);                                                                   \
+				                                                                                                       \
+				/* Make class_<> objects known to pybind11 first and add their methods later. This is required to      \
+				* handle circular dependencies between distributed matrices, e.g. it will enable Python's help()       \
+				* function to print the Python class names instead of printing the C++ class names for the copy()      \
+				* member function.                                                                                     \
+				*/                                                                                                     \
+				auto py_el_dist_ ## vector_kind ## _vector_insts =                                                     \
+					hana::transform(el_matrix_distributions, [&](auto distribution_tn) {                               \
+						auto dist_ts = hana::transform(distribution_tn, hana::first);                                  \
+						auto dist_ns = hana::transform(distribution_tn, hana::second);                                 \
 						                                                                                               \
-					using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;                               \
-					using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;                                  \
-					using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;                                 \
-					                                                                                                   \
-					using dist_ ## vector_kind ## _vector_t =                                                          \
-						el_dist_ ## vector_kind ## _vector<                                                            \
-							ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;                         \
-					                                                                                                   \
-					return py::class_<dist_ ## vector_kind ## _vector_t>{                                              \
-						m, pystrip(name.str()).c_str(), py_el_dist_ ## vector_kind ## _vector};                        \
-				});                                                                                                    \
-			                                                                                                           \
-			/* Now add class_<> functionality, e.g. member functions */                                                \
-			hana::for_each(                                                                                            \
-				hana::zip(el_matrix_distributions, py_el_dist_ ## vector_kind ## _vector_insts),                       \
-				[&](auto zipped) {                                                                                     \
-					auto distribution_tn = hana::at_c<0>(zipped);                                                      \
-					auto py_el_dist_ ## vector_kind ## _vector_inst = hana::at_c<1>(zipped);                           \
+						auto name = boost::format("el_dist_"#vector_kind"_vector<%s,%s>") % ring_n %                   \
+							hana::fold_left(dist_ns, [](std::string s, std::string name) { return s + ',' + name; });  \
+							                                                                                           \
+						using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;                           \
+						using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;                              \
+						using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;                             \
+						                                                                                               \
+						using dist_ ## vector_kind ## _vector_t =                                                      \
+							el_dist_ ## vector_kind ## _vector<                                                        \
+								ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;                     \
+						                                                                                               \
+						return py::class_<dist_ ## vector_kind ## _vector_t>{                                          \
+							m, pystrip(name.str()).c_str(), py_el_dist_ ## vector_kind ## _vector};                    \
+					});                                                                                                \
+				                                                                                                       \
+				/* Now add class_<> functionality, e.g. member functions */                                            \
+				hana::for_each(                                                                                        \
+					hana::zip(el_matrix_distributions, py_el_dist_ ## vector_kind ## _vector_insts),                   \
+					[&](auto zipped) {                                                                                 \
+						auto distribution_tn = hana::at_c<0>(zipped);                                                  \
+						auto py_el_dist_ ## vector_kind ## _vector_inst = hana::at_c<1>(zipped);                       \
+							                                                                                           \
+						auto dist_ts = hana::transform(distribution_tn, hana::first);                                  \
+						                                                                                               \
+						using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;                           \
+						using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;                              \
+						using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;                             \
 						                                                                                               \
-					auto dist_ts = hana::transform(distribution_tn, hana::first);                                      \
-					                                                                                                   \
-					using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;                               \
-					using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;                                  \
-					using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;                                 \
-					                                                                                                   \
-					using dist_ ## vector_kind ## _vector_t =                                                          \
-						el_dist_ ## vector_kind ## _vector<                                                            \
+						using dist_ ## vector_kind ## _vector_t =                                                      \
+							el_dist_ ## vector_kind ## _vector<                                                        \
+								ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;                     \
+						                                                                                               \
+						/* store template function pointers in variables to work around                                \
+						* "unresolved overloaded function type" errors with GCC9/10                                    \
+						*/                                                                                             \
+						constexpr auto length_ptr = &dist_ ## vector_kind ## _vector_t::length;                        \
+						constexpr auto local_vector_ptr = &local_ ## vector_kind ## _vector<                           \
+							ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;                         \
+						constexpr auto local_matrix_ptr = &local_matrix_of_ ## vector_kind ## _vector<                 \
 							ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;                         \
-					                                                                                                   \
-					/* store template function pointers in variables to work around                                    \
-					* "unresolved overloaded function type" errors with GCC9/10                                        \
-					*/                                                                                                 \
-					constexpr auto length_ptr = &dist_ ## vector_kind ## _vector_t::length;                            \
-					constexpr auto local_vector_ptr = &local_ ## vector_kind ## _vector<                               \
-						ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;                             \
-					constexpr auto local_matrix_ptr = &local_matrix_of_ ## vector_kind ## _vector<                     \
-						ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;                             \
-					constexpr auto participating_ptr = &dist_ ## vector_kind ## _vector_t::participating;              \
-					                                                                                                   \
-					py_el_dist_ ## vector_kind ## _vector_inst                                                         \
-						.def(py::init<El::Grid const&, El::Int>(), py::keep_alive<0, 1>())                             \
-						.def("length", length_ptr)                                                                     \
-						.def("local_matrix", local_matrix_ptr, py::keep_alive<0, 1>())                                 \
-						.def("participating", participating_ptr,                                                       \
-							 "Return True if this process can be assigned matrix data")                                \
-						;                                                                                              \
-					                                                                                                   \
-					if constexpr(                                                                                      \
-						(columnwise_t::value == El::STAR) &&                                                           \
-						(rowwise_t::value == El::STAR) &&                                                              \
-						(wrapping_t::value == El::ELEMENT)                                                             \
-					) {                                                                                                \
-						/* returning a vector is only supported for [STAR,STAR,ELEMENT] distribution */                \
+						constexpr auto participating_ptr = &dist_ ## vector_kind ## _vector_t::participating;          \
+						                                                                                               \
 						py_el_dist_ ## vector_kind ## _vector_inst                                                     \
-							.def("local", local_vector_ptr, py::keep_alive<0, 1>())                                    \
+							.def(py::init<El::Grid const&, El::Int>(), py::keep_alive<0, 1>())                         \
+							.def("length", length_ptr)                                                                 \
+							.def("local_matrix", local_matrix_ptr, py::keep_alive<0, 1>())                             \
+							.def("participating", participating_ptr,                                                   \
+								 "Return True if this process can be assigned matrix data")                            \
 							;                                                                                          \
-					}                                                                                                  \
-					                                                                                                   \
-					hana::for_each(el_matrix_distributions, [&](auto to_distribution_tn) {                             \
-						using from_columnwise_t = columnwise_t;                                                        \
-						using from_rowwise_t = rowwise_t;                                                              \
-						using from_wrapping_t = wrapping_t;                                                            \
-						auto to_dist_ts = hana::transform(to_distribution_tn, hana::first);                            \
-						using to_columnwise_t = std::decay_t<decltype(hana::at_c<0>(to_dist_ts))>;                     \
-						using to_rowwise_t = std::decay_t<decltype(hana::at_c<1>(to_dist_ts))>;                        \
-						using to_wrapping_t = std::decay_t<decltype(hana::at_c<2>(to_dist_ts))>;                       \
 						                                                                                               \
-						constexpr auto copy_ptr = &copy_ ## vector_kind ## _vector<                                    \
-							ring_t,                                                                                    \
-							from_columnwise_t::value, from_rowwise_t::value, from_wrapping_t::value,                   \
-							to_columnwise_t::value, to_rowwise_t::value, to_wrapping_t::value                          \
-						>;                                                                                             \
-                                                                                                                       \
-						if /* constexpr // but does not compile with GCC9/10 */ (                                      \
-							std::is_same_v<from_columnwise_t, to_columnwise_t> &&                                      \
-							std::is_same_v<from_rowwise_t, to_rowwise_t> &&                                            \
-							std::is_same_v<from_wrapping_t, to_wrapping_t>) {                                          \
-							/* Allow to call copy() without an argument to                                             \
-							 * create a copy with the same matrix distribution                                         \
-							 */                                                                                        \
-							py_el_dist_ ## vector_kind ## _vector_inst.def("copy",                                     \
-								py::overload_cast<                                                                     \
-									mpl::el_dist_ ## vector_kind ## _vector<                                           \
-										ring_t,                                                                        \
-										from_columnwise_t::value,                                                      \
-										from_rowwise_t::value,                                                         \
-										from_wrapping_t::value                                                         \
-									> const&,                                                                          \
-									mpl::matrix_distribution<                                                          \
-										hana::integral_constant<El::Dist, to_columnwise_t::value>,                     \
-										hana::integral_constant<El::Dist, to_rowwise_t::value>,                        \
-										hana::integral_constant<El::DistWrap, to_wrapping_t::value>                    \
-									> const&                                                                           \
-								>(copy_ptr),                                                                           \
-								py::arg("to_dist") = mpl::make_matrix_distribution(                                    \
-									hana::integral_constant<El::Dist, to_columnwise_t::value>{},                       \
-									hana::integral_constant<El::Dist, to_rowwise_t::value>{},                          \
-									hana::integral_constant<El::DistWrap, to_wrapping_t::value>{}                      \
-								)                                                                                      \
-							);                                                                                         \
-						} else {                                                                                       \
-							py_el_dist_ ## vector_kind ## _vector_inst.def("copy",                                     \
-								py::overload_cast<                                                                     \
-									mpl::el_dist_ ## vector_kind ## _vector<                                           \
-										ring_t,                                                                        \
-										from_columnwise_t::value,                                                      \
-										from_rowwise_t::value,                                                         \
-										from_wrapping_t::value                                                         \
-									> const&,                                                                          \
-									mpl::matrix_distribution<                                                          \
-										hana::integral_constant<El::Dist, to_columnwise_t::value>,                     \
-										hana::integral_constant<El::Dist, to_rowwise_t::value>,                        \
-										hana::integral_constant<El::DistWrap, to_wrapping_t::value>                    \
-									> const&                                                                           \
-								>(copy_ptr),                                                                           \
-								py::arg("to_dist")                                                                     \
-							);                                                                                         \
+						if constexpr(                                                                                  \
+							(columnwise_t::value == El::STAR) &&                                                       \
+							(rowwise_t::value == El::STAR) &&                                                          \
+							(wrapping_t::value == El::ELEMENT)                                                         \
+						) {                                                                                            \
+							/* returning a vector is only supported for [STAR,STAR,ELEMENT] distribution */            \
+							py_el_dist_ ## vector_kind ## _vector_inst                                                 \
+								.def("local", local_vector_ptr, py::keep_alive<0, 1>())                                \
+								;                                                                                      \
 						}                                                                                              \
-					});                                                                                                \
+						                                                                                               \
+						hana::for_each(el_matrix_distributions, [&](auto to_distribution_tn) {                         \
+							using from_columnwise_t = columnwise_t;                                                    \
+							using from_rowwise_t = rowwise_t;                                                          \
+							using from_wrapping_t = wrapping_t;                                                        \
+							auto to_dist_ts = hana::transform(to_distribution_tn, hana::first);                        \
+							using to_columnwise_t = std::decay_t<decltype(hana::at_c<0>(to_dist_ts))>;                 \
+							using to_rowwise_t = std::decay_t<decltype(hana::at_c<1>(to_dist_ts))>;                    \
+							using to_wrapping_t = std::decay_t<decltype(hana::at_c<2>(to_dist_ts))>;                   \
+							                                                                                           \
+							constexpr auto copy_ptr = &copy_ ## vector_kind ## _vector<                                \
+								ring_t,                                                                                \
+								from_columnwise_t::value, from_rowwise_t::value, from_wrapping_t::value,               \
+								to_columnwise_t::value, to_rowwise_t::value, to_wrapping_t::value                      \
+							>;                                                                                         \
+	                                                                                                                   \
+							if /* constexpr // but does not compile with GCC9/10 */ (                                  \
+								std::is_same_v<from_columnwise_t, to_columnwise_t> &&                                  \
+								std::is_same_v<from_rowwise_t, to_rowwise_t> &&                                        \
+								std::is_same_v<from_wrapping_t, to_wrapping_t>) {                                      \
+								/* Allow to call copy() without an argument to                                         \
+								 * create a copy with the same matrix distribution                                     \
+								 */                                                                                    \
+								py_el_dist_ ## vector_kind ## _vector_inst.def("copy",                                 \
+									py::overload_cast<                                                                 \
+										mpl::el_dist_ ## vector_kind ## _vector<                                       \
+											ring_t,                                                                    \
+											from_columnwise_t::value,                                                  \
+											from_rowwise_t::value,                                                     \
+											from_wrapping_t::value                                                     \
+										> const&,                                                                      \
+										mpl::matrix_distribution<                                                      \
+											hana::integral_constant<El::Dist, to_columnwise_t::value>,                 \
+											hana::integral_constant<El::Dist, to_rowwise_t::value>,                    \
+											hana::integral_constant<El::DistWrap, to_wrapping_t::value>                \
+										> const&                                                                       \
+									>(copy_ptr),                                                                       \
+									py::arg("to_dist") = mpl::make_matrix_distribution(                                \
+										hana::integral_constant<El::Dist, to_columnwise_t::value>{},                   \
+										hana::integral_constant<El::Dist, to_rowwise_t::value>{},                      \
+										hana::integral_constant<El::DistWrap, to_wrapping_t::value>{}                  \
+									)                                                                                  \
+								);                                                                                     \
+							} else {                                                                                   \
+								py_el_dist_ ## vector_kind ## _vector_inst.def("copy",                                 \
+									py::overload_cast<                                                                 \
+										mpl::el_dist_ ## vector_kind ## _vector<                                       \
+											ring_t,                                                                    \
+											from_columnwise_t::value,                                                  \
+											from_rowwise_t::value,                                                     \
+											from_wrapping_t::value                                                     \
+										> const&,                                                                      \
+										mpl::matrix_distribution<                                                      \
+											hana::integral_constant<El::Dist, to_columnwise_t::value>,                 \
+											hana::integral_constant<El::Dist, to_rowwise_t::value>,                    \
+											hana::integral_constant<El::DistWrap, to_wrapping_t::value>                \
+										> const&                                                                       \
+									>(copy_ptr),                                                                       \
+									py::arg("to_dist")                                                                 \
+								);                                                                                     \
+							}                                                                                          \
+						});                                                                                            \
+				});                                                                                                    \
 			});                                                                                                        \
 		});                                                                                                            \
 		return m;                                                                                                      \
@@ -18,21 +18,35 @@
 
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 
+#include <algorithm>
 #include <boost/assert.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/format.hpp>
+#include <boost/hana/contains.hpp>
 #include <boost/hana/drop_back.hpp>
 #include <boost/hana/first.hpp>
 #include <boost/hana/for_each.hpp>
+#include <boost/hana/transform.hpp>
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 #include <boost/hana/second.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/numeric/conversion/cast.hpp>
+#include <boost/system/error_code.hpp>
 #include <boost/throw_exception.hpp>
+#include <edamer/detail/buffer.hpp>
 #include <edamer/detail/scalar.hpp>
 #include <edamer/dt/el_complex.hpp>
 #include <edamer/dt/exception.hpp>
 #include <hbrs/mpl/dt/el_matrix/impl.hpp>
+#include <memory>
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 namespace hana = boost::hana;
@@ -40,26 +54,69 @@ namespace hana = boost::hana;
 EDAMER_NAMESPACE_BEGIN(/* unnamed */)
 
 EDAMER_NAMESPACE_BEGIN(detail)
+/* Whether a height x width array with the given strides (in elements) can be viewed as a column-major Elemental matrix,
+ * i.e. consecutive rows are adjacent in memory and columns are at least height elements apart
+ */
+bool
+column_major_compatible(py::ssize_t height, py::ssize_t width, py::ssize_t row_stride, py::ssize_t col_stride) {
+	return (height <= 1 || row_stride == 1) && (width <= 1 || col_stride >= std::max<py::ssize_t>(height, 1));
+}
+
+/* View a 2d array as a mxn matrix whose leading dimension is the column stride of the array, e.g. a column slice of a
+ * larger Fortran-ordered array. Arrays whose rows are adjacent instead, e.g. C-ordered arrays, are viewed as their nxm
+ * transpose. Other layouts cannot be viewed without a copy and are rejected.
+ */
 template<typename Ring>
 auto
-view_from_numpy_2d(py::array_t<Ring, py::array::f_style> & array) {
+view_from_numpy_2d(py::array_t<Ring> & array) {
 	if (array.ndim() != 2) {
 		BOOST_THROW_EXCEPTION((incompatible_ndarray_exception{} << errinfo_ndarray_ndim{array.ndim()}));
 	}
 	
 	py::buffer_info buf = array.request(array.writeable());
-	auto m = boost::numeric_cast<El::Int>( array.shape(0) );
-	auto n = boost::numeric_cast<El::Int>( array.shape(1) );
-	auto ldim = m;
+	
+	auto const itemsize = static_cast<py::ssize_t>(sizeof(Ring));
+	if (array.strides(0) % itemsize != 0 || array.strides(1) % itemsize != 0) {
+		BOOST_THROW_EXCEPTION((incompatible_ndarray_exception{}
+			<< errinfo_ndarray_strides{{array.strides(0), array.strides(1)}}));
+	}
+	
+	py::ssize_t const rows = array.shape(0);
+	py::ssize_t const cols = array.shape(1);
+	py::ssize_t const row_stride = array.strides(0) / itemsize;
+	py::ssize_t const col_stride = array.strides(1) / itemsize;
+	
+	py::ssize_t height, width, ldim;
+	if (column_major_compatible(rows, cols, row_stride, col_stride)) {
+		height = rows;
+		width = cols;
+		ldim = col_stride;
+	} else if (column_major_compatible(cols, rows, col_stride, row_stride)) {
+		height = cols;
+		width = rows;
+		ldim = row_stride;
+	} else {
+		BOOST_THROW_EXCEPTION((incompatible_ndarray_exception{}
+			<< errinfo_ndarray_strides{{array.strides(0), array.strides(1)}}));
+	}
+	
+	if (width <= 1) {
+		// stride of a single column is meaningless
+		ldim = height;
+	}
+	
+	auto m = boost::numeric_cast<El::Int>(height);
+	auto n = boost::numeric_cast<El::Int>(width);
+	auto ldim_ = std::max<El::Int>(boost::numeric_cast<El::Int>(ldim), 1);
 	
 	// Wrap matrix types in py::object instances because it is not possible in C++ to return different types.
 	if constexpr (!std::is_const_v<Ring>) {
 		if (array.writeable()) {
-			return El::Matrix<Ring>{m, n, static_cast<Ring*>(buf.ptr), ldim};
+			return El::Matrix<Ring>{m, n, static_cast<Ring*>(buf.ptr), ldim_};
 		}
 	}
 	
-	auto && matrix = El::Matrix<std::remove_const_t<Ring>>{m, n, static_cast<Ring const*>(buf.ptr), ldim};
+	auto && matrix = El::Matrix<std::remove_const_t<Ring>>{m, n, static_cast<Ring const*>(buf.ptr), ldim_};
 	BOOST_ASSERT(matrix.Locked());
 	return HBRS_MPL_FWD(matrix);
 }
@@ -67,7 +124,7 @@ EDAMER_NAMESPACE_END(detail)
 
 template<typename Ring>
 auto
-view_from_numpy_2d(py::array_t<Ring, py::array::f_style> & array) {
+view_from_numpy_2d(py::array_t<Ring> & array) {
 	auto matrix = detail::view_from_numpy_2d(array);
 	
 	// Wrap matrix types in py::object instances because it is not possible in C++ to return different types.
@@ -79,27 +136,24 @@ view_from_numpy_2d(py::array_t<Ring, py::array::f_style> & array) {
 }
 
 EDAMER_NAMESPACE_BEGIN(detail)
+template<typename Ring>
+std::vector<py::ssize_t>
+shape_2d(El::Matrix<Ring> const& matrix) {
+	return { matrix.Height(), matrix.Width() };
+}
+
+/* Strides in elements */
+template<typename Ring>
+std::vector<py::ssize_t>
+strides_2d(El::Matrix<Ring> const& matrix) {
+	return { 1, matrix.LDim() };
+}
+
 template<typename Ring>
 auto
 view_to_numpy_2d(El::Matrix<Ring> & matrix, py::handle base) {
-	auto shape = py::array::ShapeContainer{ matrix.Height(), matrix.Width() };
-	auto strides = py::array::StridesContainer{ sizeof(Ring), sizeof(Ring) * matrix.Height() };
-	void * buf_ptr = matrix.Locked()
-		? const_cast<void*>(static_cast<void const*>(matrix.LockedBuffer()))
-		  /* is safe because it will be casted to const void* in py::array_t */
-		: static_cast<void*>(matrix.Buffer());
-	
-	auto buf = py::buffer_info(
-		buf_ptr,                               /* Pointer to buffer */
-		sizeof(Ring),                          /* Size of one scalar */
-		py::format_descriptor<Ring>::format(), /* Python struct-style format descriptor */
-		2,                                     /* Number of dimensions */
-		shape,                                 /* Buffer dimensions */
-		strides,                               /* Strides (in bytes) for each index */
-		matrix.Locked()                        /* Buffer is readonly */
-	);
-	
-	auto && array = py::array_t<Ring, py::array::f_style>{buf, base};
+	auto buf = make_buffer_info(matrix, shape_2d(matrix), strides_2d(matrix));
+	auto && array = py::array_t<Ring>{buf, base};
 	
 	if (matrix.Locked()) {
 		// Uses pybind11's private API to remove writeable flag because there is currently no official API for that
@@ -119,6 +173,26 @@ view_to_numpy_2d(py::object &obj) {
 	return detail::view_to_numpy_2d(matrix.data(), obj);
 }
 
+template<typename Ring>
+py::buffer_info
+buffer_2d(mpl::el_matrix<Ring> & matrix) {
+	auto & data = matrix.data();
+	return detail::make_buffer_info(data, detail::shape_2d(data), detail::strides_2d(data));
+}
+
+template<typename Ring>
+py::capsule
+to_dlpack_2d(py::object &obj, py::object const& stream, py::kwargs const&) {
+	// host memory is synchronous, hence no stream can be waited on
+	if (!stream.is_none()) {
+		throw py::buffer_error{"stream must be None for CPU tensors"};
+	}
+	
+	mpl::el_matrix<Ring> & matrix = obj.cast<mpl::el_matrix<Ring>&>();
+	auto & data = matrix.data();
+	return detail::make_dlpack_capsule(data, detail::shape_2d(data), detail::strides_2d(data), obj);
+}
+
 auto scalars = hana::drop_back(hana::make_tuple(
 	#ifdef EDAMER_ENABLE_SCALAR_INT
 		EDAMER_TYPE_NAME_PAIR(std::int32_t),
@@ -147,6 +221,77 @@ auto scalars = hana::drop_back(hana::make_tuple(
 	"SEQUENCE_TERMINATOR___REMOVED_BY_DROP_BACK"
 ));
 
+/* Whether el_matrix<Ring const> is registered, i.e. whether read-only matrices with scalar type Ring are supported */
+template<typename Ring>
+constexpr bool
+has_const_variant() {
+	return decltype(hana::contains(hana::transform(scalars, hana::first), hana::type_c<Ring const>))::value;
+}
+
+/* Map the height x width entries of a file, which are stored in column-major order from offset on, into memory and view
+ * them as matrix. Nothing is read until entries are accessed and pages can be evicted again by the operating system,
+ * hence files may be larger than the main memory. Modes are those of numpy.memmap, i.e. 'r' is read-only and yields an
+ * el_matrix<Ring const>, 'r+' writes changes back to the file and 'c' keeps changes in memory (copy-on-write).
+ */
+template<typename Ring>
+py::object
+from_mmap(std::string const& path, El::Int height, El::Int width, std::size_t offset, std::string const& mode) {
+	namespace bip = boost::interprocess;
+	
+	static std::unordered_map<std::string, bip::mode_t> const modes = {
+		{ "r", bip::read_only },
+		{ "r+", bip::read_write },
+		{ "c", bip::copy_on_write }
+	};
+	auto it = modes.find(mode);
+	if (it == modes.end()) {
+		throw py::value_error{"mode must be one of 'r', 'r+' or 'c'"};
+	}
+	bool const writeable = it->second != bip::read_only;
+	
+	if constexpr (!has_const_variant<Ring>()) {
+		if (!writeable) {
+			throw py::type_error{"read-only mappings are not supported for this dtype"};
+		}
+	}
+	
+	std::size_t const size = static_cast<std::size_t>(height * width) * sizeof(Ring);
+	boost::system::error_code ec;
+	auto const file_size = boost::filesystem::file_size(path, ec);
+	// mapping beyond the end of the file would crash on access instead of failing here
+	if (ec || file_size < offset + size) {
+		BOOST_THROW_EXCEPTION((file_access_failed_exception{} << errinfo_file_path{path}));
+	}
+	
+	std::unique_ptr<bip::mapped_region> region;
+	void * ptr = nullptr;
+	if (size > 0) {
+		try {
+			bip::file_mapping file{path.c_str(), it->second == bip::read_write ? bip::read_write : bip::read_only};
+			region = std::make_unique<bip::mapped_region>(file, it->second, offset, size);
+		} catch (bip::interprocess_exception const&) {
+			BOOST_THROW_EXCEPTION((file_access_failed_exception{} << errinfo_file_path{path}));
+		}
+		ptr = region->get_address();
+	}
+	
+	El::Int const ldim = std::max<El::Int>(height, 1);
+	py::object matrix;
+	if (writeable) {
+		matrix = py::cast(mpl::el_matrix<Ring>{El::Matrix<Ring>{height, width, static_cast<Ring*>(ptr), ldim}});
+	} else if constexpr (has_const_variant<Ring>()) {
+		matrix = py::cast(mpl::el_matrix<Ring const>{
+			El::Matrix<Ring>{height, width, static_cast<Ring const*>(ptr), ldim}});
+	}
+	
+	if (region) {
+		// the file is unmapped when the matrix has been garbage collected
+		py::capsule owner{region.release(), [](void * region) { delete static_cast<bip::mapped_region*>(region); }};
+		py::detail::keep_alive_impl(matrix, owner);
+	}
+	return matrix;
+}
+
 EDAMER_NAMESPACE_END(/* unnamed */)
 
 py::module &
@@ -170,28 +315,67 @@ pydef_impl<hbrs::mpl::el_matrix_tag>::apply(py::module & m, py::module & base) {
 			 */
 			constexpr auto view_from_numpy_2d_ptr = &view_from_numpy_2d<ring_t>;
 			constexpr auto view_to_numpy_2d_ptr = &view_to_numpy_2d<ring_t>;
+			constexpr auto buffer_2d_ptr = &buffer_2d<ring_t>;
+			constexpr auto to_dlpack_2d_ptr = &to_dlpack_2d<ring_t>;
 			constexpr auto size_ptr = &type_t::size;
 			
 			py_el_matrix.def_static("view_from_numpy",
-				py::overload_cast<py::array_t<ring_t, py::array::f_style>&>(view_from_numpy_2d_ptr),
+				py::overload_cast<py::array_t<ring_t>&>(view_from_numpy_2d_ptr),
 				py::arg("array").noconvert(true),
 				py::keep_alive<0, 1>());
 			/* Previously, incompatible arrays were just accepted by mistake even if noconvert(true) [1], but since pull
 			 * request #2484 [2], pybind11 checks whether the array::c_style or array::f_style flags are satisifed and
-			 * raises an error otherwise.
+			 * raises an error otherwise. No layout flags are requested here, so noconvert(true) only rejects arrays of
+			 * other dtypes and the strides are checked in detail::view_from_numpy_2d instead.
 			 * Ref.:
 			 * [1] https://github.com/pybind/pybind11/issues/2455
 			 * [2] https://github.com/pybind/pybind11/pull/2484
 			 */
 			
-			py::class_<type_t>{m, pystrip(name.str()).c_str(), py_el_matrix}
+			py::class_<type_t>{m, pystrip(name.str()).c_str(), py_el_matrix, py::buffer_protocol()}
 				.def(py::init<El::Int, El::Int>())
 				.def("size", size_ptr)
 				.def("view_to_numpy", view_to_numpy_2d_ptr, py::keep_alive<0, 1>())
+				.def_buffer(buffer_2d_ptr)
+				.def("__dlpack__", to_dlpack_2d_ptr, py::arg("stream") = py::none())
+				.def("__dlpack_device__", [](type_t const&) { return detail::dlpack_device(); })
 				;
 		}
 	);
 	
+	// The ring is selected at runtime by dtype, like for numpy.memmap
+	py_el_matrix.def_static("from_mmap",
+		[](
+			std::string const& path,
+			std::pair<El::Int, El::Int> const& shape,
+			py::object const& dtype,
+			std::size_t offset,
+			std::string const& mode
+		) {
+			auto const requested = py::dtype::from_args(dtype);
+			py::object matrix;
+			hana::for_each(scalars, [&](auto pair) {
+				using ring_t = typename decltype(+hana::first(pair))::type;
+				if constexpr (!std::is_const_v<ring_t>) {
+					if (!matrix && requested.equal(py::dtype::of<ring_t>())) {
+						matrix = from_mmap<ring_t>(path, shape.first, shape.second, offset, mode);
+					}
+				}
+			});
+			
+			if (!matrix) {
+				throw py::type_error{"dtype is not supported"};
+			}
+			return matrix;
+		},
+		py::arg("path"),
+		py::arg("shape"),
+		py::arg("dtype"),
+		py::arg("offset") = 0,
+		py::arg("mode") = "r",
+		"View a memory-mapped file, whose entries are stored in column-major order, as matrix without reading it"
+	);
+	
 	return m;
 }
 
@@ -5,10 +5,13 @@
 #
 # Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
 
-from edamer import detail, dt
+from edamer import detail, dt, fn
 import logging
 import numpy as np
+import os
 import pytest
+import shutil
+import tempfile
 
 
 @pytest.fixture
@@ -69,3 +72,105 @@ def test_ctor_complex(env):
         logging.debug(str(mat_np2))
         logging.debug(mat_np2.flags)
         logging.debug(mat_np2.dtype)
+
+
+def test_ctor_view_strided(env):
+    for dtype in detail.scalars():
+        base_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+
+        # column slices of Fortran-ordered arrays keep the array's column stride as leading dimension
+        mat_np = base_np[1:env.m-1, ::3]
+        assert not mat_np.flags.f_contiguous
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np)
+        assert (mat_el.size().m, mat_el.size().n) == mat_np.shape
+        mat_np2 = mat_el.view_to_numpy()
+        assert np.array_equal(mat_np, mat_np2)
+
+        mat_np2[3, 5] = 1337
+        assert base_np[4, 15] == 1337
+
+
+def test_ctor_view_c_order(env):
+    for dtype in detail.scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='C', dtype=dtype)
+
+        # C-ordered arrays are viewed as their transpose without copying
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np)
+        assert (mat_el.size().m, mat_el.size().n) == (env.n, env.m)
+        mat_np2 = mat_el.view_to_numpy()
+        assert np.array_equal(mat_np.T, mat_np2)
+
+        mat_np2[5, 3] = 1337
+        assert mat_np[3, 5] == 1337
+
+
+def test_ctor_view_incompatible(env):
+    mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=np.float64)
+    with pytest.raises(Exception):
+        dt.ElMatrix.view_from_numpy(mat_np[::2, :])
+
+
+def test_buffer_protocol(env):
+    for dtype in detail.scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np)
+
+        mat_np2 = np.asarray(memoryview(mat_el))
+        assert mat_np2.shape == mat_np.shape
+        assert np.array_equal(mat_np, mat_np2)
+
+        mat_np2[3, 5] = 1337
+        assert mat_np[3, 5] == 1337
+
+
+@pytest.mark.skipif(not hasattr(np, 'from_dlpack'), reason="requires NumPy with DLPack support")
+def test_dlpack(env):
+    for dtype in detail.scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np[:, 1:])
+        assert mat_el.__dlpack_device__() == (1, 0)
+
+        mat_np2 = np.from_dlpack(mat_el)
+        del mat_el  # consumer keeps the matrix alive
+        assert np.array_equal(mat_np[:, 1:], mat_np2)
+
+        if mat_np2.flags.writeable:
+            mat_np2[3, 5] = 1337
+            assert mat_np[3, 6] == 1337
+
+
+def test_from_mmap(env):
+    tmpdir = tempfile.mkdtemp()
+    try:
+        path = os.path.join(tmpdir, 'matrix.bin')
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=np.float64)
+        # raw files store entries in column-major order
+        mat_np.T.tofile(path)
+
+        mat_el = dt.ElMatrix.from_mmap(path, (env.m, env.n), np.float64)
+        assert isinstance(mat_el, dt.ElMatrix)
+        assert np.array_equal(mat_el.view_to_numpy(), mat_np)
+
+        # read-only matrices can be used as arguments to functions
+        rng = (dt.MatrixIndex.make(1, 2), dt.MatrixSize.make(3, 4))
+        assert np.array_equal(fn.select(mat_el, rng).view_to_numpy(), mat_np[1:4, 2:6])
+        for rng in [(dt.MatrixIndex.make(env.m-2, 0), dt.MatrixSize.make(3, 1)),
+                    (dt.MatrixIndex.make(0, env.n), dt.MatrixSize.make(1, 1)),
+                    (dt.MatrixIndex.make(-1, 0), dt.MatrixSize.make(1, 1))]:
+            with pytest.raises(dt.IncompatibleMatrixException):
+                fn.select(mat_el, rng)
+        b_np = np.asarray(np.ones((env.n, 3)), order='F')
+        product = fn.multiply(mat_el, dt.ElMatrix.view_from_numpy(b_np))
+        assert np.allclose(product.view_to_numpy(), mat_np @ b_np)
+
+        mat_rw = dt.ElMatrix.from_mmap(path, (env.m, env.n), np.float64, mode='r+')
+        mat_rw.view_to_numpy()[3, 5] = 1337
+        del mat_rw
+        assert np.fromfile(path, dtype=np.float64)[5*env.m+3] == 1337
+
+        with pytest.raises(dt.FileAccessFailedException):
+            dt.ElMatrix.from_mmap(path, (env.m+1, env.n), np.float64)
+        with pytest.raises(ValueError):
+            dt.ElMatrix.from_mmap(path, (env.m, env.n), np.float64, mode='w')
+    finally:
+        shutil.rmtree(tmpdir)
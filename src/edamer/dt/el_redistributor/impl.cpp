@@ -0,0 +1,137 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "impl.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <boost/format.hpp>
+#include <boost/hana/concat.hpp>
+#include <boost/hana/first.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/second.hpp>
+#include <boost/hana/type.hpp>
+#include <edamer/detail/pybind11.hpp>
+#include <edamer/detail/scalar.hpp>
+#include <edamer/dt/el_abstract_dist_matrix.hpp>
+#include <memory>
+#include <pybind11/stl.h>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace hana = boost::hana;
+
+py::module &
+pydef_impl<el_redistributor_tag>::apply(py::module & m, py::module & base) {
+	auto ring_tns = hana::concat(detail::scalars, detail::complex_scalars);
+	
+	auto py_el_redistributor = py::class_<el_redistributor_tag>{m, pystrip("el_redistributor").c_str()};
+	auto py_el_redistribution = py::class_<el_redistribution_tag>{m, pystrip("el_redistribution").c_str()};
+	
+	hana::for_each(ring_tns, [&m, &py_el_redistributor, &py_el_redistribution](auto ring_tn) {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		auto ring_n = hana::second(ring_tn);
+		
+		using redistributor_t = el_redistributor<ring_t>;
+		using redistribution_t = el_redistribution<ring_t>;
+		using distribution_t = typename redistributor_t::distribution_t;
+		using matrix_t = el_abstract_dist_matrix<ring_t>;
+		auto name = boost::format("el_redistributor<%s>") % ring_n;
+		auto redistribution_name = boost::format("el_redistribution<%s>") % ring_n;
+		
+		py::class_<redistribution_t>{m, pystrip(redistribution_name.str()).c_str(), py_el_redistribution}
+			.def("test", &redistribution_t::test, py::call_guard<py::gil_scoped_release>(),
+				"Return True if the redistribution has finished, without blocking")
+			.def("wait", &redistribution_t::wait, py::call_guard<py::gil_scoped_release>(),
+				"Block until the redistribution has finished and return the target matrix");
+		
+		py::class_<redistributor_t>{m, pystrip(name.str()).c_str(), py_el_redistributor}
+			.def(py::init<El::Grid const&, El::Int, El::Int, distribution_t const&, distribution_t const&>(),
+				py::arg("grid"),
+				py::arg("height"),
+				py::arg("width"),
+				py::arg("from_dist"),
+				py::arg("to_dist"),
+				py::keep_alive<1, 2>()
+			)
+			.def("__call__",
+				[](redistributor_t & r, matrix_t const& a) {
+					return matrix_t{r(a.data())};
+				},
+				py::arg("a"),
+				py::call_guard<py::gil_scoped_release>(),
+				"Return a copy of a in the target matrix distribution"
+			)
+			.def("__call__",
+				[](redistributor_t & r, matrix_t const& a, matrix_t & out) {
+					r(a.data(), out.data());
+				},
+				py::arg("a"),
+				py::arg("out"),
+				py::call_guard<py::gil_scoped_release>(),
+				"Copy a into out, which is resized if necessary"
+			)
+			.def("start",
+				[](redistributor_t const& r, matrix_t const& a) {
+					auto const& [columnwise, rowwise, wrapping] = r.to();
+					return std::make_unique<redistribution_t>(
+						r, a.data(), matrix_t{detail::make_el_abstract_dist_matrix<ring_t>(
+							r.grid(), columnwise, rowwise, wrapping)});
+				},
+				py::arg("a"),
+				py::keep_alive<0, 1>(),
+				py::call_guard<py::gil_scoped_release>(),
+				"Start copying a to a new matrix in the target matrix distribution and return without waiting for "
+				"the exchange to finish, a may be modified immediately"
+			)
+			.def("start",
+				[](redistributor_t const& r, matrix_t const& a, matrix_t const& out) {
+					return std::make_unique<redistribution_t>(r, a.data(), out);
+				},
+				py::arg("a"),
+				py::arg("out"),
+				py::keep_alive<0, 1>(),
+				py::call_guard<py::gil_scoped_release>(),
+				"Start copying a into out and return without waiting for the exchange to finish, out must not be "
+				"accessed before wait() returned"
+			)
+			.def_property_readonly("from_dist", &redistributor_t::from)
+			.def_property_readonly("to_dist", &redistributor_t::to);
+		
+		// Plan the redistribution of matrices like a, i.e. of the same size, grid and matrix distribution
+		py_el_redistributor.def_static("make",
+			[](matrix_t const& a, El::Dist columnwise, El::Dist rowwise, El::DistWrap wrapping) {
+				return redistributor_t{
+					a.data().Grid(),
+					a.data().Height(),
+					a.data().Width(),
+					{a.data().ColDist(), a.data().RowDist(), a.data().Wrap()},
+					{columnwise, rowwise, wrapping}
+				};
+			},
+			py::arg("a"),
+			py::arg("columnwise"),
+			py::arg("rowwise"),
+			py::arg("wrapping") = El::ELEMENT,
+			py::keep_alive<0, 1>()
+		);
+	});
+	return m;
+}
+
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
@@ -0,0 +1,325 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EDAMER_DT_EL_REDISTRIBUTOR_IMPL_HPP
+#define EDAMER_DT_EL_REDISTRIBUTOR_IMPL_HPP
+
+#include "fwd.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <boost/throw_exception.hpp>
+#include <edamer/detail/elemental.hpp>
+#include <edamer/dt/el_abstract_dist_matrix.hpp>
+#include <edamer/dt/exception.hpp>
+#include <El.hpp>
+#include <hbrs/mpl/dt/exception.hpp>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+
+/* Redistributes matrices of a fixed size from one matrix distribution to another with a communication pattern which
+ * is computed once, in contrast to El::Copy() which recomputes it on each call. Buffers are kept between calls, hence
+ * each call only packs, exchanges and unpacks matrix entries. Matrices must have default alignments and roots, like
+ * the ones returned by make_view() and copy(). If no process receives entries from another one, e.g. from [STAR,STAR]
+ * to [MC,MR], El::Copy() is used instead, which copies local entries without index lists. MPI counts and
+ * displacements are ints, hence plans which would exchange more than INT_MAX entries with a single process are
+ * rejected with mpi_count_overflow_exception on all processes.
+ */
+template<typename Ring>
+struct el_redistributor {
+	using distribution_t = std::tuple<El::Dist, El::Dist, El::DistWrap>;
+	
+	el_redistributor(
+		El::Grid const& grid,
+		El::Int height,
+		El::Int width,
+		distribution_t const& from,
+		distribution_t const& to
+	) : grid_{&grid}, height_{height}, width_{width}, from_{from}, to_{to} {
+		El::mpi::Comm comm = grid.ViewingComm();
+		int const rank = El::mpi::Rank(comm);
+		int const size = El::mpi::Size(comm);
+		
+		/* Let Elemental redistribute the origin of each entry, i.e. process and local index in from, once. Then each
+		 * process knows where to receive its entries of to from.
+		 */
+		auto from_ranks = make_plan_matrix(from);
+		auto from_offsets = make_plan_matrix(from);
+		El::Int const from_local_height = from_ranks->LocalHeight();
+		for (El::Int j = 0; j < from_ranks->LocalWidth(); ++j) {
+			for (El::Int i = 0; i < from_local_height; ++i) {
+				from_ranks->Matrix().Set(i, j, rank);
+				from_offsets->Matrix().Set(i, j, i + j * from_local_height);
+			}
+		}
+		
+		auto to_ranks = make_plan_matrix(to);
+		auto to_offsets = make_plan_matrix(to);
+		El::Copy(*from_ranks, *to_ranks);
+		El::Copy(*from_offsets, *to_offsets);
+		
+		El::Int const to_local_height = to_ranks->LocalHeight();
+		El::Int const to_local_width = to_ranks->LocalWidth();
+		
+		std::vector<El::Int> recv_counts(size, 0);
+		for (El::Int j = 0; j < to_local_width; ++j) {
+			for (El::Int i = 0; i < to_local_height; ++i) {
+				++recv_counts[to_ranks->LockedMatrix().Get(i, j)];
+			}
+		}
+		
+		// all processes take the same branch, hence they skip the collectives below together
+		bool const local = recv_counts[rank] == to_local_height * to_local_width;
+		local_ = El::mpi::AllReduce(static_cast<int>(local), El::mpi::MIN, comm) == 1;
+		if (local_) {
+			return;
+		}
+		
+		recv_counts_ = detail::mpi_counts(recv_counts, comm);
+		recv_displs_ = displacements(recv_counts_);
+		
+		// entries are received grouped by source process, unpack_ maps them back to their local index in to
+		std::vector<El::Int> requests(to_local_height * to_local_width);
+		unpack_.resize(requests.size());
+		std::vector<int> next = recv_displs_;
+		for (El::Int j = 0; j < to_local_width; ++j) {
+			for (El::Int i = 0; i < to_local_height; ++i) {
+				auto n = next[to_ranks->LockedMatrix().Get(i, j)]++;
+				requests[n] = to_offsets->LockedMatrix().Get(i, j);
+				unpack_[n] = i + j * to_local_height;
+			}
+		}
+		
+		// tell each source process which of its local entries to send in which order
+		std::vector<El::Int> send_counts(size, 0);
+		El::mpi::AllToAll(recv_counts.data(), 1, send_counts.data(), 1, comm);
+		send_counts_ = detail::mpi_counts(send_counts, comm);
+		send_displs_ = displacements(send_counts_);
+		
+		pack_.resize(std::accumulate(send_counts_.begin(), send_counts_.end(), El::Int{0}));
+		El::mpi::AllToAll(
+			requests.data(), recv_counts_.data(), recv_displs_.data(),
+			pack_.data(), send_counts_.data(), send_displs_.data(),
+			comm);
+		
+		send_buf_.resize(pack_.size());
+		recv_buf_.resize(unpack_.size());
+	}
+	
+	void
+	operator()(El::AbstractDistMatrix<Ring> const& from, El::AbstractDistMatrix<Ring> & to) {
+		prepare(from, to);
+		if (local_) {
+			El::Copy(from, to);
+			return;
+		}
+		
+		pack(from, send_buf_);
+		El::mpi::AllToAll(
+			send_buf_.data(), send_counts_.data(), send_displs_.data(),
+			recv_buf_.data(), recv_counts_.data(), recv_displs_.data(),
+			grid_->ViewingComm());
+		unpack(recv_buf_, to);
+	}
+	
+	std::shared_ptr<El::AbstractDistMatrix<Ring>>
+	operator()(El::AbstractDistMatrix<Ring> const& from) {
+		auto to = detail::make_el_abstract_dist_matrix<Ring>(
+			*grid_, std::get<0>(to_), std::get<1>(to_), std::get<2>(to_));
+		(*this)(from, *to);
+		return to;
+	}
+	
+	El::Grid const&
+	grid() const { return *grid_; }
+	
+	distribution_t const&
+	from() const { return from_; }
+	
+	distribution_t const&
+	to() const { return to_; }
+	
+private:
+	template<typename> friend struct el_redistribution;
+	
+	void
+	prepare(El::AbstractDistMatrix<Ring> const& from, El::AbstractDistMatrix<Ring> & to) const {
+		check(from, from_);
+		check(to, to_);
+		if (from.Height() != height_ || from.Width() != width_) {
+			BOOST_THROW_EXCEPTION((hbrs::mpl::incompatible_matrix_exception{}
+				<< hbrs::mpl::errinfo_el_matrix_size{{from.Height(), from.Width()}}));
+		}
+		to.Resize(height_, width_);
+	}
+	
+	void
+	pack(El::AbstractDistMatrix<Ring> const& from, std::vector<Ring> & buf) const {
+		auto const& from_local = from.LockedMatrix();
+		El::Int const from_local_height = from_local.Height();
+		for (std::size_t n = 0; n < pack_.size(); ++n) {
+			El::Int const k = pack_[n];
+			buf[n] = from_local.Get(k % from_local_height, k / from_local_height);
+		}
+	}
+	
+	void
+	unpack(std::vector<Ring> const& buf, El::AbstractDistMatrix<Ring> & to) const {
+		auto & to_local = to.Matrix();
+		El::Int const to_local_height = to_local.Height();
+		for (std::size_t n = 0; n < unpack_.size(); ++n) {
+			El::Int const k = unpack_[n];
+			to_local.Set(k % to_local_height, k / to_local_height, buf[n]);
+		}
+	}
+	
+	std::shared_ptr<El::AbstractDistMatrix<El::Int>>
+	make_plan_matrix(distribution_t const& dist) const {
+		auto a = detail::make_el_abstract_dist_matrix<El::Int>(
+			*grid_, std::get<0>(dist), std::get<1>(dist), std::get<2>(dist));
+		a->Resize(height_, width_);
+		return a;
+	}
+	
+	static std::vector<int>
+	displacements(std::vector<int> const& counts) {
+		std::vector<int> displs(counts.size(), 0);
+		std::partial_sum(counts.begin(), std::prev(counts.end()), std::next(displs.begin()));
+		return displs;
+	}
+	
+	void
+	check(El::AbstractDistMatrix<Ring> const& a, distribution_t const& dist) const {
+		if (std::make_tuple(a.ColDist(), a.RowDist(), a.Wrap()) != dist) {
+			BOOST_THROW_EXCEPTION((matrix_distribution_not_supported_exception{}
+				<< errinfo_el_matrix_distribution{{a.ColDist(), a.RowDist(), a.Wrap()}}
+			));
+		}
+		
+		if (&a.Grid() != grid_ || a.ColAlign() != 0 || a.RowAlign() != 0 || a.Root() != 0) {
+			BOOST_THROW_EXCEPTION((hbrs::mpl::incompatible_matrix_exception{}
+				<< hbrs::mpl::errinfo_el_matrix_size{{a.Height(), a.Width()}}));
+		}
+	}
+	
+	El::Grid const* grid_;
+	El::Int height_;
+	El::Int width_;
+	distribution_t from_;
+	distribution_t to_;
+	bool local_ = false;
+	std::vector<int> send_counts_;
+	std::vector<int> send_displs_;
+	std::vector<int> recv_counts_;
+	std::vector<int> recv_displs_;
+	std::vector<El::Int> pack_;
+	std::vector<El::Int> unpack_;
+	std::vector<Ring> send_buf_;
+	std::vector<Ring> recv_buf_;
+};
+
+/* A redistribution which has been started with a plan of el_redistributor but might not have finished yet. Entries of
+ * from are packed when it is started, so from may be modified or destroyed afterwards, while to must not be accessed
+ * before wait() returned or test() returned true. Progress of the exchange depends on the MPI implementation, some
+ * only progress while test() or wait() are called. The plan must outlive the redistribution.
+ */
+template<typename Ring>
+struct el_redistribution {
+	el_redistribution(
+		el_redistributor<Ring> const& plan,
+		El::AbstractDistMatrix<Ring> const& from,
+		el_abstract_dist_matrix<Ring> to
+	) : plan_{&plan}, to_{std::move(to)}, send_buf_(plan.pack_.size()), recv_buf_(plan.unpack_.size()) {
+		plan_->prepare(from, to_.data());
+		if (plan_->local_) {
+			El::Copy(from, to_.data());
+			done_ = true;
+			return;
+		}
+		
+		plan_->pack(from, send_buf_);
+		MPI_Ialltoallv(
+			send_buf_.data(), plan_->send_counts_.data(), plan_->send_displs_.data(), El::mpi::TypeMap<Ring>(),
+			recv_buf_.data(), plan_->recv_counts_.data(), plan_->recv_displs_.data(), El::mpi::TypeMap<Ring>(),
+			plan_->grid_->ViewingComm().comm, &request_);
+	}
+	
+	el_redistribution(el_redistribution const&) = delete;
+	el_redistribution &
+	operator=(el_redistribution const&) = delete;
+	
+	// Buffers must stay valid until MPI is done with them
+	~el_redistribution() {
+		if (request_ != MPI_REQUEST_NULL) {
+			MPI_Wait(&request_, MPI_STATUS_IGNORE);
+		}
+	}
+	
+	bool
+	test() {
+		if (!done_) {
+			int flag = 0;
+			MPI_Test(&request_, &flag, MPI_STATUS_IGNORE);
+			if (flag) {
+				finish();
+			}
+		}
+		return done_;
+	}
+	
+	el_abstract_dist_matrix<Ring>
+	wait() {
+		if (!done_) {
+			MPI_Wait(&request_, MPI_STATUS_IGNORE);
+			finish();
+		}
+		return to_;
+	}
+	
+private:
+	void
+	finish() {
+		plan_->unpack(recv_buf_, to_.data());
+		done_ = true;
+		// buffers are not needed anymore
+		send_buf_ = {};
+		recv_buf_ = {};
+	}
+	
+	el_redistributor<Ring> const* plan_;
+	el_abstract_dist_matrix<Ring> to_;
+	std::vector<Ring> send_buf_;
+	std::vector<Ring> recv_buf_;
+	MPI_Request request_ = MPI_REQUEST_NULL;
+	bool done_ = false;
+};
+
+template <>
+struct EDAMER_API pydef_impl<el_redistributor_tag> {
+	static py::module &
+	apply(py::module & m, py::module & base);
+};
+
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DT_EL_REDISTRIBUTOR_IMPL_HPP
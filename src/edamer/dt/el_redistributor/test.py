@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+from edamer import detail, dt
+import logging
+from mpi4py import MPI
+import numpy as np
+import pytest
+import time
+
+
+@pytest.fixture
+def env():
+    class Environment():
+        comm = MPI.COMM_WORLD
+        size = comm.Get_size()
+        rank = comm.Get_rank()
+        grid = dt.ElGrid(comm)
+        m = 100  # matrix height
+        n = 200  # matrix width
+    return Environment()
+
+
+def test_redistribute(env):
+    for dtype in detail.scalars() + detail.complex_scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+        mat_el = dt.ElMatrix.view_from_numpy(mat_np)
+        dmat_el = dt.ElAbstractDistMatrix.make_view(env.grid, mat_el, dt.ElDist.STAR, dt.ElDist.STAR)
+
+        for columnwise, rowwise in [(dt.ElDist.MC, dt.ElDist.MR), (dt.ElDist.VC, dt.ElDist.STAR),
+                                    (dt.ElDist.CIRC, dt.ElDist.CIRC)]:
+            redist = dt.ElRedistributor.make(dmat_el, columnwise, rowwise)
+
+            # plans are reused, e.g. once per time step
+            for step in range(3):
+                mat_np[0, 0] = step
+                expected = dmat_el.copy(columnwise, rowwise)
+                actual = redist(dmat_el)
+                assert actual.columnwise == columnwise
+                assert actual.rowwise == rowwise
+                assert np.array_equal(actual.local().view_to_numpy(), expected.local().view_to_numpy())
+
+            out = type(expected)(env.grid, 1, 1, columnwise, rowwise)
+            redist(dmat_el, out)
+            assert out.size().m == env.m and out.size().n == env.n
+            assert np.array_equal(out.local().view_to_numpy(), expected.local().view_to_numpy())
+
+
+def test_redistribute_incompatible(env):
+    if np.double not in detail.scalars():
+        pytest.skip("unsupported configuration")
+
+    dmat_el = dt.ElAbstractDistMatrix_Double(env.grid, 2, 3, dt.ElDist.STAR, dt.ElDist.STAR)
+    redist = dt.ElRedistributor.make(dmat_el, dt.ElDist.MC, dt.ElDist.MR)
+
+    with pytest.raises(dt.IncompatibleMatrixException):
+        redist(dt.ElAbstractDistMatrix_Double(env.grid, 3, 3, dt.ElDist.STAR, dt.ElDist.STAR))
+
+    with pytest.raises(dt.MatrixDistributionNotSupportedException):
+        redist(dt.ElAbstractDistMatrix_Double(env.grid, 2, 3, dt.ElDist.MC, dt.ElDist.MR))
+
+
+def test_redistribute_nonblocking(env):
+    for dtype in detail.scalars() + detail.complex_scalars():
+        mat_np = np.asarray(np.arange(env.m*env.n).reshape(env.m, env.n), order='F', dtype=dtype)
+        dmat_el = dt.ElAbstractDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(mat_np),
+                                                    dt.ElDist.STAR, dt.ElDist.STAR).copy(dt.ElDist.VC, dt.ElDist.STAR)
+        expected = dmat_el.copy(dt.ElDist.MC, dt.ElDist.MR)
+
+        redist = dt.ElRedistributor.make(dmat_el, dt.ElDist.MC, dt.ElDist.MR)
+        request = redist.start(dmat_el)
+        # entries have been packed already, hence the source can be reused while the exchange is in flight
+        dmat_el.local().view_to_numpy()[:] = 0
+        actual = request.wait()
+        assert request.test()
+        assert np.array_equal(actual.local().view_to_numpy(), expected.local().view_to_numpy())
+
+        out = type(expected)(env.grid, 1, 1, dt.ElDist.MC, dt.ElDist.MR)
+        request = redist.start(expected.copy(dt.ElDist.VC, dt.ElDist.STAR), out)
+        while not request.test():
+            pass
+        assert np.array_equal(out.local().view_to_numpy(), expected.local().view_to_numpy())
+
+
+@detail.test.benchmark
+def test_redistribute_timing(env):
+    if np.double not in detail.scalars():
+        pytest.skip("unsupported configuration")
+
+    def best(f):
+        f()
+        times = []
+        for _ in range(5):
+            env.comm.Barrier()
+            t = time.perf_counter()
+            f()
+            env.comm.Barrier()
+            times.append(time.perf_counter() - t)
+        return min(times)
+
+    m, n = 4000, 1000
+    mat_np = np.asarray(np.random.default_rng(0).standard_normal((m, n)), order='F')
+    star_star = dt.ElAbstractDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(mat_np),
+                                                  dt.ElDist.STAR, dt.ElDist.STAR)
+
+    # [STAR,STAR] to [MC,MR] requires no communication and falls back to El::Copy, the others exchange entries
+    for source in [star_star, star_star.copy(dt.ElDist.VC, dt.ElDist.STAR), star_star.copy(dt.ElDist.MC, dt.ElDist.MR)]:
+        target = (dt.ElDist.MC, dt.ElDist.MR) if source.columnwise != dt.ElDist.MC else (dt.ElDist.VR, dt.ElDist.STAR)
+        redist = dt.ElRedistributor.make(source, *target)
+        out = source.copy(*target)
+
+        copy = best(lambda: source.copy(*target))
+        planned = best(lambda: redist(source, out))
+        # wall-clock times depend on the machine and its load, hence they are logged only
+        logging.info('[%s,%s] to [%s,%s]: El::Copy %.3f ms, ElRedistributor %.3f ms', source.columnwise,
+                     source.rowwise, target[0], target[1], 1e3 * copy, 1e3 * planned)
+        assert np.array_equal(out.local().view_to_numpy(), source.copy(*target).local().view_to_numpy())
@@ -18,6 +18,7 @@
 
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 
+#include <algorithm>
 #include <boost/assert.hpp>
 #include <boost/format.hpp>
 #include <boost/hana/at.hpp>
@@ -31,12 +32,15 @@
 #include <boost/hana/second.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/throw_exception.hpp>
+#include <edamer/detail/buffer.hpp>
 #include <edamer/detail/scalar.hpp>
 #include <edamer/dt/el_complex.hpp>
 #include <edamer/dt/exception.hpp>
 #include <hbrs/mpl/dt/el_vector/impl.hpp>
 #include <hbrs/mpl/dt/exception.hpp>
 #include <pybind11/numpy.h>
+#include <type_traits>
+#include <vector>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 namespace hana = boost::hana;
@@ -46,10 +50,13 @@ EDAMER_NAMESPACE_BEGIN(/* unnamed */)
 
 EDAMER_NAMESPACE_BEGIN(detail)
 
+/* Row vectors are views with unit height, so a strided array such as a[::k] maps to a row vector whose leading
+ * dimension is the array stride. Column vectors require adjacent elements.
+ */
 template<typename Ring, typename Orientation>
 auto
 view_from_numpy_1d(
-	py::array_t<Ring, py::array::f_style> & array,
+	py::array_t<Ring> & array,
 	hana::basic_type<Orientation> = hana::type_c<Orientation>
 ) {
 	static_assert(
@@ -64,15 +71,29 @@ view_from_numpy_1d(
 	py::buffer_info buf = array.request(array.writeable());
 	El::Int m;
 	El::Int n;
+	El::Int ldim;
+	
+	auto const itemsize = static_cast<py::ssize_t>(sizeof(Ring));
+	auto const length = array.shape(0);
+	auto const stride = array.strides(0);
 	
 	if constexpr (std::is_same_v<Orientation, mpl::el_column_vector_tag>) {
-		m = boost::numeric_cast<El::Int>( array.shape(0) );
+		if (length > 1 && stride != itemsize) {
+			BOOST_THROW_EXCEPTION((incompatible_ndarray_exception{} << errinfo_ndarray_strides{{stride}}));
+		}
+		
+		m = boost::numeric_cast<El::Int>(length);
 		n = 1;
+		ldim = std::max<El::Int>(m, 1);
 	} else {
+		if (length > 1 && (stride <= 0 || stride % itemsize != 0)) {
+			BOOST_THROW_EXCEPTION((incompatible_ndarray_exception{} << errinfo_ndarray_strides{{stride}}));
+		}
+		
 		m = 1;
-		n = boost::numeric_cast<El::Int>( array.shape(0) );
+		n = boost::numeric_cast<El::Int>(length);
+		ldim = length > 1 ? boost::numeric_cast<El::Int>(stride / itemsize) : 1;
 	}
-	El::Int ldim = m;
 	
 	// Wrap matrix types in py::object instances because it is not possible in C++ to return different types.
 	if constexpr (!std::is_const_v<Ring>) {
@@ -91,7 +112,7 @@ EDAMER_NAMESPACE_END(detail)
 template<typename Ring, typename Orientation>
 struct view_from_numpy_1d_t {
 	static auto
-	apply(py::array_t<Ring, py::array::f_style> & array) {
+	apply(py::array_t<Ring> & array) {
 		static_assert(
 			std::is_same_v<Orientation, mpl::el_column_vector_tag> ||
 			std::is_same_v<Orientation, mpl::el_row_vector_tag>,
@@ -127,6 +148,27 @@ struct view_from_numpy_1d_t {
 
 EDAMER_NAMESPACE_BEGIN(detail)
 
+template<typename Orientation, typename Ring>
+std::vector<py::ssize_t>
+shape_1d(El::Matrix<Ring> const& matrix) {
+	if constexpr (std::is_same_v<Orientation, mpl::el_column_vector_tag>) {
+		return { matrix.Height() };
+	} else {
+		return { matrix.Width() };
+	}
+}
+
+/* Strides in elements, i.e. entries of row vectors are a leading dimension apart */
+template<typename Orientation, typename Ring>
+std::vector<py::ssize_t>
+strides_1d(El::Matrix<Ring> const& matrix) {
+	if constexpr (std::is_same_v<Orientation, mpl::el_column_vector_tag>) {
+		return { 1 };
+	} else {
+		return { matrix.LDim() };
+	}
+}
+
 template<typename Ring, typename Orientation>
 auto
 view_to_numpy_1d(
@@ -139,33 +181,9 @@ view_to_numpy_1d(
 		std::is_same_v<Orientation, mpl::el_row_vector_tag>,
 		"Only hbrs::mpl::el_column_vector_tag and hbrs::mpl::el_row_vector_tag are supported");
 	
-	py::array::ShapeContainer shape;
-	py::array::StridesContainer strides;
+	auto buf = make_buffer_info(matrix, shape_1d<Orientation>(matrix), strides_1d<Orientation>(matrix));
 	
-	if constexpr (std::is_same_v<Orientation, mpl::el_column_vector_tag>) {
-		shape = py::array::ShapeContainer{ matrix.Height(), };
-		strides = py::array::StridesContainer{ sizeof(Ring) };
-	} else {
-		shape = py::array::ShapeContainer{ matrix.Width(), };
-		strides = py::array::StridesContainer{ sizeof(Ring) };
-	}
-	
-	void * buf_ptr = matrix.Locked()
-		? const_cast<void*>(static_cast<void const*>(matrix.LockedBuffer()))
-		  /* is safe because it will be casted to const void* in py::array_t */
-		: static_cast<void*>(matrix.Buffer());
-	
-	auto buf = py::buffer_info(
-		buf_ptr,                               /* Pointer to buffer */
-		sizeof(Ring),                          /* Size of one scalar */
-		py::format_descriptor<Ring>::format(), /* Python struct-style format descriptor */
-		1,                                     /* Number of dimensions */
-		shape,                                 /* Buffer dimensions */
-		strides,                               /* Strides (in bytes) for each index */
-		matrix.Locked()                        /* Buffer is readonly */
-	);
-	
-	auto && array = py::array_t<Ring, py::array::f_style>{buf, base};
+	auto && array = py::array_t<Ring>{buf, base};
 	
 	if (matrix.Locked()) {
 		// Uses pybind11's private API to remove writeable flag because there is currently no official API for that
@@ -197,6 +215,38 @@ struct view_to_numpy_1d_t {
 	}
 };
 
+template<typename Ring, typename Orientation>
+struct buffer_1d_t {
+	using vector_type = std::conditional_t<
+		std::is_same_v<Orientation, mpl::el_column_vector_tag>,
+		mpl::el_column_vector<Ring>,
+		mpl::el_row_vector<Ring>
+	>;
+	
+	static py::buffer_info
+	apply(vector_type & vector) {
+		auto & data = vector.data();
+		return detail::make_buffer_info(
+			data, detail::shape_1d<Orientation>(data), detail::strides_1d<Orientation>(data));
+	}
+};
+
+template<typename Ring, typename Orientation>
+struct to_dlpack_1d_t {
+	static py::capsule
+	apply(py::object &obj, py::object const& stream, py::kwargs const&) {
+		// host memory is synchronous, hence no stream can be waited on
+		if (!stream.is_none()) {
+			throw py::buffer_error{"stream must be None for CPU tensors"};
+		}
+		
+		auto & vector = obj.cast<typename buffer_1d_t<Ring, Orientation>::vector_type &>();
+		auto & data = vector.data();
+		return detail::make_dlpack_capsule(
+			data, detail::shape_1d<Orientation>(data), detail::strides_1d<Orientation>(data), obj);
+	}
+};
+
 auto scalars = hana::drop_back(hana::make_tuple(
 	#ifdef EDAMER_ENABLE_SCALAR_INT
 		EDAMER_TYPE_NAME_PAIRS(std::int32_t),
@@ -256,6 +306,10 @@ EDAMER_NAMESPACE_END(/* unnamed */)
 					&view_from_numpy_1d_t<ring_t, el_ ## vector_kind ## _vector_tag>::apply;                           \
 				constexpr auto view_to_numpy_1d_ptr =                                                                  \
 					&view_to_numpy_1d_t<ring_t, el_ ## vector_kind ## _vector_tag>::apply;                             \
+				constexpr auto buffer_1d_ptr =                                                                         \
+					&buffer_1d_t<ring_t, el_ ## vector_kind ## _vector_tag>::apply;                                    \
+				constexpr auto to_dlpack_1d_ptr =                                                                      \
+					&to_dlpack_1d_t<ring_t, el_ ## vector_kind ## _vector_tag>::apply;                                 \
 				constexpr auto length_ptr = &type_t::length;                                                           \
 				                                                                                                       \
 				py_el_vector.def_static("view_from_numpy",                                                             \
@@ -270,10 +324,13 @@ EDAMER_NAMESPACE_END(/* unnamed */)
 				* [2] https://github.com/pybind/pybind11/pull/2484                                                     \
 				*/                                                                                                     \
 				                                                                                                       \
-				py::class_<type_t>{m, pystrip(name.str()).c_str(), py_el_vector}                                       \
+				py::class_<type_t>{m, pystrip(name.str()).c_str(), py_el_vector, py::buffer_protocol()}                \
 					.def(py::init<El::Int>())                                                                          \
 					.def("length", length_ptr)                                                                         \
 					.def("view_to_numpy", view_to_numpy_1d_ptr, py::keep_alive<0, 1>())                                \
+					.def_buffer(buffer_1d_ptr)                                                                         \
+					.def("__dlpack__", to_dlpack_1d_ptr, py::arg("stream") = py::none())                               \
+					.def("__dlpack_device__", [](type_t const&) { return detail::dlpack_device(); })                   \
 					;                                                                                                  \
 			}                                                                                                          \
 		);                                                                                                             \
@@ -67,3 +67,47 @@ def test_ctor_complex(env):
             logging.debug(str(vec_np2))
             logging.debug(vec_np2.flags)
             logging.debug(vec_np2.dtype)
+
+
+def test_ctor_view_strided(env):
+    for dtype in detail.scalars():
+        base_np = np.asarray(np.arange(env.n), order='F', dtype=dtype)
+        vec_np = base_np[::4]
+
+        # row vectors use the array stride as leading dimension
+        vec_el = dt.ElRowVector.view_from_numpy(vec_np)
+        assert vec_el.length() == vec_np.size
+        vec_np2 = vec_el.view_to_numpy()
+        assert np.array_equal(vec_np, vec_np2)
+
+        vec_np2[3] = 1337
+        assert base_np[12] == 1337
+
+        # column vectors require adjacent elements
+        with pytest.raises(Exception):
+            dt.ElColumnVector.view_from_numpy(vec_np)
+
+
+def test_buffer_protocol(env):
+    for dtype in detail.scalars():
+        for vector_t in [dt.ElColumnVector, dt.ElRowVector]:
+            vec_np = np.asarray(np.arange(env.n), order='F', dtype=dtype)
+            vec_el = vector_t.view_from_numpy(vec_np)
+
+            vec_np2 = np.asarray(memoryview(vec_el))
+            assert np.array_equal(vec_np, vec_np2)
+
+            vec_np2[3] = 1337
+            assert vec_np[3] == 1337
+
+
+@pytest.mark.skipif(not hasattr(np, 'from_dlpack'), reason="requires NumPy with DLPack support")
+def test_dlpack(env):
+    for dtype in detail.scalars():
+        for vector_t in [dt.ElColumnVector, dt.ElRowVector]:
+            vec_np = np.asarray(np.arange(env.n), order='F', dtype=dtype)
+            vec_el = vector_t.view_from_numpy(vec_np)
+            assert vec_el.__dlpack_device__() == (1, 0)
+
+            vec_np2 = np.from_dlpack(vec_el)
+            assert np.array_equal(vec_np, vec_np2)
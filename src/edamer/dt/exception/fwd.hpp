@@ -22,7 +22,9 @@
 #include <edamer/config.hpp>
 #include <edamer/detail/pybind11.hpp>
 #include <hbrs/mpl/config.hpp>
+#include <string>
 #include <tuple>
+#include <vector>
 
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 	#include <El.hpp>
@@ -38,13 +40,56 @@ struct pydef_impl<exception_tag>;
 struct EDAMER_API incompatible_ndarray_exception;
 struct EDAMER_API import_mpi4py_failed_exception;
 struct EDAMER_API matrix_distribution_not_supported_exception;
+struct EDAMER_API pca_method_not_supported_exception;
+struct EDAMER_API pca_score_not_supported_exception;
+struct EDAMER_API pca_precision_not_supported_exception;
+struct EDAMER_API dimension_not_supported_exception;
+struct EDAMER_API normalization_not_supported_exception;
+struct EDAMER_API components_not_orthonormal_exception;
+struct EDAMER_API mpi_thread_level_not_supported_exception;
+struct EDAMER_API mpi_count_overflow_exception;
+struct EDAMER_API file_access_failed_exception;
+struct EDAMER_API file_format_not_supported_exception;
 
 typedef boost::error_info<struct errinfo_ndarray_ndim_, py::ssize_t>
 	errinfo_ndarray_ndim;
 
+typedef boost::error_info<struct errinfo_ndarray_strides_, std::vector<py::ssize_t>>
+	errinfo_ndarray_strides;
+
+typedef boost::error_info<struct errinfo_pca_method_, std::string>
+	errinfo_pca_method;
+
+typedef boost::error_info<struct errinfo_pca_score_, std::string>
+	errinfo_pca_score;
+
+typedef boost::error_info<struct errinfo_pca_precision_, std::string>
+	errinfo_pca_precision;
+
+typedef boost::error_info<struct errinfo_dimension_, int>
+	errinfo_dimension;
+
+typedef boost::error_info<struct errinfo_normalization_, int>
+	errinfo_normalization;
+
+typedef boost::error_info<struct errinfo_orthonormality_deviation_, double>
+	errinfo_orthonormality_deviation;
+
+typedef boost::error_info<struct errinfo_mpi_thread_level_, int>
+	errinfo_mpi_thread_level;
+
+typedef boost::error_info<struct errinfo_file_path_, std::string>
+	errinfo_file_path;
+
+typedef boost::error_info<struct errinfo_file_header_, std::string>
+	errinfo_file_header;
+
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 typedef boost::error_info<struct errinfo_el_matrix_distribution_, std::tuple<El::Dist, El::Dist, El::DistWrap>>
 	errinfo_el_matrix_distribution;
+
+typedef boost::error_info<struct errinfo_mpi_count_, El::Int>
+	errinfo_mpi_count;
 #endif // HBRS_MPL_ENABLE_ELEMENTAL
 
 EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
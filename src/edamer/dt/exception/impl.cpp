@@ -33,6 +33,16 @@ pydef_impl<exception_tag>::apply(py::module & m, py::module & base) {
 	_REGISTER_EXCEPTION(m, incompatible_ndarray_exception, ex);
 	_REGISTER_EXCEPTION(m, import_mpi4py_failed_exception, ex);
 	_REGISTER_EXCEPTION(m, matrix_distribution_not_supported_exception,ex);
+	_REGISTER_EXCEPTION(m, pca_method_not_supported_exception, ex);
+	_REGISTER_EXCEPTION(m, pca_score_not_supported_exception, ex);
+	_REGISTER_EXCEPTION(m, pca_precision_not_supported_exception, ex);
+	_REGISTER_EXCEPTION(m, dimension_not_supported_exception, ex);
+	_REGISTER_EXCEPTION(m, normalization_not_supported_exception, ex);
+	_REGISTER_EXCEPTION(m, components_not_orthonormal_exception, ex);
+	_REGISTER_EXCEPTION(m, mpi_thread_level_not_supported_exception, ex);
+	_REGISTER_EXCEPTION(m, mpi_count_overflow_exception, ex);
+	_REGISTER_EXCEPTION(m, file_access_failed_exception, ex);
+	_REGISTER_EXCEPTION(m, file_format_not_supported_exception, ex);
 	return m;
 }
 
@@ -33,6 +33,16 @@ struct EDAMER_API pydef_impl<exception_tag> {
 struct EDAMER_API incompatible_ndarray_exception : virtual mpl::exception {};
 struct EDAMER_API import_mpi4py_failed_exception : virtual mpl::exception {};
 struct EDAMER_API matrix_distribution_not_supported_exception : virtual mpl::exception {};
+struct EDAMER_API pca_method_not_supported_exception : virtual mpl::exception {};
+struct EDAMER_API pca_score_not_supported_exception : virtual mpl::exception {};
+struct EDAMER_API pca_precision_not_supported_exception : virtual mpl::exception {};
+struct EDAMER_API dimension_not_supported_exception : virtual mpl::exception {};
+struct EDAMER_API normalization_not_supported_exception : virtual mpl::exception {};
+struct EDAMER_API components_not_orthonormal_exception : virtual mpl::exception {};
+struct EDAMER_API mpi_thread_level_not_supported_exception : virtual mpl::exception {};
+struct EDAMER_API mpi_count_overflow_exception : virtual mpl::exception {};
+struct EDAMER_API file_access_failed_exception : virtual mpl::exception {};
+struct EDAMER_API file_format_not_supported_exception : virtual mpl::exception {};
 
 EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
 
@@ -0,0 +1,122 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <boost/format.hpp>
+#include <boost/hana/at.hpp>
+#include <boost/hana/drop_back.hpp>
+#include <boost/hana/first.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/transform.hpp>
+#include <boost/hana/tuple.hpp>
+#include <boost/hana/type.hpp>
+#include <boost/hana/second.hpp>
+#include <edamer/detail/pybind11.hpp>
+#include <edamer/detail/scalar.hpp>
+#include <edamer/dt/matrix_distribution.hpp>
+#include <hbrs/mpl/dt/el_dist_matrix.hpp>
+#include <hbrs/mpl/dt/el_dist_vector.hpp>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace hana = boost::hana;
+namespace mpl = hbrs::mpl;
+
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+/* Elemental's SVD supports real and complex floating-point types only; like fn.pca we support real types only */
+auto scalars = hana::drop_back(hana::make_tuple(
+	#ifdef EDAMER_ENABLE_SCALAR_FLOAT
+		EDAMER_TYPE_NAME_PAIR(float),
+	#endif // EDAMER_ENABLE_SCALAR_FLOAT
+
+	#ifdef EDAMER_ENABLE_SCALAR_DOUBLE
+		EDAMER_TYPE_NAME_PAIR(double),
+	#endif // EDAMER_ENABLE_SCALAR_DOUBLE
+
+	"SEQUENCE_TERMINATOR___REMOVED_BY_DROP_BACK"
+));
+
+EDAMER_NAMESPACE_END(/* unnamed */)
+
+py::module &
+pydef_impl<incremental_pca_tag>::apply(py::module & m, py::module & base) {
+	auto py_incremental_pca = py::class_<incremental_pca_tag>{m, pystrip("incremental_pca").c_str()};
+	
+	hana::for_each(scalars, [&m, &py_incremental_pca](auto ring_tn) {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		auto ring_n = hana::second(ring_tn);
+		
+		using type_t = incremental_pca<ring_t>;
+		auto name = boost::format("incremental_pca<%s>") % ring_n;
+		
+		auto c = py::class_<type_t>{m, pystrip(name.str()).c_str(), py_incremental_pca}
+			.def(
+				py::init<El::Grid const&, El::Int>(),
+				py::arg("grid"),
+				py::arg("n_components") = 0,
+				py::keep_alive<1, 2>()
+			)
+			.def_property_readonly("n_components", &type_t::n_components)
+			.def_property_readonly("n_samples_seen", &type_t::n_samples_seen)
+			.def_property_readonly("coeff",
+				[](type_t const& o) {
+					// classes of distributed matrices are registered on first use of their ring
+					detail::require_pydefs<ring_t>();
+					return mpl::make_el_dist_matrix(El::DistMatrix<ring_t>{o.coeff()});
+				}
+			)
+			.def_property_readonly("latent",
+				[](type_t const& o) {
+					detail::require_pydefs<ring_t>();
+					return mpl::make_el_dist_column_vector(El::DistMatrix<ring_t, El::MD, El::STAR>{o.latent()});
+				}
+			)
+			.def_property_readonly("mean",
+				[](type_t const& o) {
+					detail::require_pydefs<ring_t>();
+					El::DistMatrix<ring_t, El::STAR, El::VC> mean{o.grid()};
+					El::Transpose(o.mean(), mean);
+					return mpl::make_el_dist_row_vector(std::move(mean));
+				}
+			);
+		
+		hana::for_each(el_matrix_distributions, [&c](auto distribution_tn) {
+			auto dist_ts = hana::transform(distribution_tn, hana::first);
+			
+			using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
+			using rowwise_t    = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
+			using wrapping_t   = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
+			
+			using dist_matrix_t = mpl::el_dist_matrix<
+				ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
+			
+			c.def("partial_fit",
+				[](type_t & o, dist_matrix_t const& a) {
+					o.partial_fit(a.data());
+				},
+				py::arg("a")
+			);
+		});
+	});
+	
+	return m;
+}
+
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
@@ -0,0 +1,162 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EDAMER_DT_INCREMENTAL_PCA_IMPL_HPP
+#define EDAMER_DT_INCREMENTAL_PCA_IMPL_HPP
+
+#include "fwd.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <algorithm>
+#include <boost/throw_exception.hpp>
+#include <cmath>
+#include <edamer/detail/elemental.hpp>
+#include <El.hpp>
+#include <hbrs/mpl/dt/exception.hpp>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace mpl = hbrs::mpl;
+
+/* Incremental PCA which updates the principal components, the variances and the mean of all observations (rows) seen
+ * so far from a new block of observations. It uses the incremental SVD of Ross et al., i.e. the right singular vectors
+ * and singular values of the centered history are computed from the (k+b+1)xn matrix
+ *     [ diag(s) * coeff'                                   ]
+ *     [ a - ones(b,1) * mean(a)                            ]
+ *     [ sqrt(seen*b/(seen+b)) * (mean(a) - mean(history))' ]
+ * where k is the number of kept components and b is the number of rows of the new block a. Hence the costs of each
+ * call to partial_fit() depend on the size of the new block only and not on the number of observations seen before.
+ *
+ * Ref.: D. A. Ross, J. Lim, R.-S. Lin, M.-H. Yang. Incremental Learning for Robust Visual Tracking. 2008.
+ */
+template<typename Ring>
+struct incremental_pca {
+	/* n_components <= 0 keeps all components */
+	incremental_pca(El::Grid const& grid, El::Int n_components)
+	: grid_{&grid}, n_components_{n_components}, n_samples_seen_{0},
+	  coeff_{grid}, singular_values_{grid}, mean_{grid} {}
+	
+	template<El::Dist Columnwise, El::Dist Rowwise, El::DistWrap Wrapping>
+	void
+	partial_fit(El::DistMatrix<Ring, Columnwise, Rowwise, Wrapping> const& a) {
+		El::Int const b = a.Height();
+		El::Int const n = a.Width();
+		
+		if (n_samples_seen_ > 0 && n != mean_.Height()) {
+			BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{} << mpl::errinfo_el_matrix_size{{b, n}}));
+		}
+		
+		if (b == 0) {
+			return;
+		}
+		
+		if (n_samples_seen_ == 0) {
+			El::Zeros(mean_, n, 1);
+		}
+		
+		El::Int const n_total = n_samples_seen_ + b;
+		
+		El::DistMatrix<Ring> a_c{a};
+		auto batch_mean = detail::column_means(a_c);
+		detail::center_columns(a_c, batch_mean);
+		
+		El::DistMatrix<Ring> stacked{*grid_};
+		if (n_samples_seen_ == 0) {
+			stacked = std::move(a_c);
+		} else {
+			El::DistMatrix<Ring> history{*grid_};
+			El::Transpose(coeff_, history);
+			El::DiagonalScale(El::LEFT, El::NORMAL, singular_values_, history);
+			
+			El::DistMatrix<Ring> correction{*grid_};
+			El::Copy(batch_mean, correction);
+			El::Axpy(Ring(-1), mean_, correction);
+			El::Scale(std::sqrt(Ring(n_samples_seen_) * Ring(b) / Ring(n_total)), correction);
+			
+			El::DistMatrix<Ring> correction_t{*grid_};
+			El::Transpose(correction, correction_t);
+			
+			El::DistMatrix<Ring> upper{*grid_};
+			El::VCat(history, a_c, upper);
+			El::VCat(upper, correction_t, stacked);
+		}
+		
+		El::Scale(Ring(n_samples_seen_) / Ring(n_total), mean_);
+		El::Axpy(Ring(b) / Ring(n_total), batch_mean, mean_);
+		
+		El::DistMatrix<Ring> u{*grid_};
+		El::DistMatrix<Ring, El::VR, El::STAR> s{*grid_};
+		El::DistMatrix<Ring> v{*grid_};
+		
+		El::SVDCtrl<Ring> ctrl;
+		ctrl.bidiagSVDCtrl.approach = El::THIN_SVD;
+		ctrl.bidiagSVDCtrl.wantU = false;
+		El::SVD(stacked, u, s, v, ctrl);
+		
+		El::Int k = std::min(s.Height(), n);
+		if (n_components_ > 0) {
+			k = std::min(k, n_components_);
+		}
+		
+		El::Copy(v(El::ALL, El::IR(0, k)), coeff_);
+		El::Copy(s(El::IR(0, k), El::ALL), singular_values_);
+		n_samples_seen_ = n_total;
+	}
+	
+	El::Grid const&
+	grid() const { return *grid_; }
+	
+	El::Int
+	n_components() const { return n_components_; }
+	
+	El::Int
+	n_samples_seen() const { return n_samples_seen_; }
+	
+	/* nxk matrix of principal components */
+	El::DistMatrix<Ring> const&
+	coeff() const { return coeff_; }
+	
+	/* kx1 vector of principal component variances, i.e. s.^2/(seen-1) like fn.pca's latent */
+	El::DistMatrix<Ring, El::STAR, El::STAR>
+	latent() const {
+		El::DistMatrix<Ring, El::STAR, El::STAR> latent{singular_values_};
+		detail::singular_values_to_variances(latent, n_samples_seen_);
+		return latent;
+	}
+	
+	/* nx1 vector of column means */
+	El::DistMatrix<Ring, El::STAR, El::STAR> const&
+	mean() const { return mean_; }
+
+private:
+	El::Grid const* grid_;
+	El::Int n_components_;
+	El::Int n_samples_seen_;
+	El::DistMatrix<Ring> coeff_;
+	El::DistMatrix<Ring, El::STAR, El::STAR> singular_values_;
+	El::DistMatrix<Ring, El::STAR, El::STAR> mean_;
+};
+
+template <>
+struct EDAMER_API pydef_impl<incremental_pca_tag> {
+	static py::module &
+	apply(py::module & m, py::module & base);
+};
+
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
+#endif // !EDAMER_DT_INCREMENTAL_PCA_IMPL_HPP
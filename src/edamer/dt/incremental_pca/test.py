@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+from edamer import detail, dt
+import logging # noqa F401
+from mpi4py import MPI
+import numpy as np
+import pytest
+
+
+@pytest.fixture
+def env():
+    class Environment():
+        comm = MPI.COMM_WORLD
+        size = comm.Get_size()
+        rank = comm.Get_rank()
+        grid = dt.ElGrid(comm)
+        m = 120  # number of observations
+        n = 10  # number of variables
+        b = 25  # number of observations per block
+    return Environment()
+
+
+def make_dataset(env, dtype, rank=0):
+    rng = np.random.RandomState(4711)
+    if rank == 0:
+        # scale columns differently to get well separated principal component variances
+        return np.asarray(rng.standard_normal((env.m, env.n)) * np.arange(env.n, 0, -1) + 42, dtype=dtype)
+
+    # truncated updates are approximate in general but exact if the centered dataset has at most rank components
+    factors = rng.standard_normal((env.m, rank)) * np.arange(rank, 0, -1)
+    return np.asarray(factors @ rng.standard_normal((rank, env.n)) + 42, dtype=dtype)
+
+
+def fit(env, dataset, n_components):
+    dist_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+
+    ipca = dt.IncrementalPca_Double(env.grid, n_components) if dataset.dtype == np.double \
+        else dt.IncrementalPca_Float(env.grid, n_components)
+
+    for i in range(0, env.m, env.b):
+        block_np = np.asarray(dataset[i:i+env.b, :], order='F')
+        block_el = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(block_np), dist_el)
+        ipca.partial_fit(block_el.copy(dist_mc_mr_el))
+
+    return ipca
+
+
+@pytest.mark.parametrize("n_components", [0, 3])
+def test_partial_fit(env, n_components):
+    for dtype in [np.float32, np.double]:
+        if dtype not in detail.scalars():
+            continue
+
+        dataset = make_dataset(env, dtype, n_components)
+        ipca = fit(env, dataset, n_components)
+        k = env.n if n_components == 0 else n_components
+
+        assert isinstance(ipca, dt.IncrementalPca)
+        assert ipca.n_samples_seen == env.m
+        assert ipca.n_components == n_components
+
+        mean_np = dataset.astype(np.double).mean(axis=0)
+        centered_np = dataset.astype(np.double) - mean_np
+        _, s_np, vt_np = np.linalg.svd(centered_np, full_matrices=False)
+        latent_np = s_np**2 / (env.m - 1)
+
+        rtol = 1e-4 if dtype == np.float32 else 1e-8
+
+        mean = detail.test.to_numpy_1d(ipca.mean)
+        assert np.allclose(mean, mean_np, rtol=rtol)
+
+        latent = detail.test.to_numpy_1d(ipca.latent)
+        assert latent.shape == (k,)
+        assert np.allclose(latent, latent_np[:k], rtol=rtol)
+
+        coeff = detail.test.to_numpy_2d(ipca.coeff)
+        assert coeff.shape == (env.n, k)
+        # principal components are unique up to their sign
+        assert np.allclose(np.abs(coeff), np.abs(vt_np[:k, :].T), rtol=rtol*10, atol=rtol*10)
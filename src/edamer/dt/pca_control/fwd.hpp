@@ -24,6 +24,30 @@
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 
+/* No tag or wrapper for PCA algorithms other than hbrs::mpl's SVD-based PCA has been defined in hbrs::mpl */
+enum class pca_method {
+	svd,
+	randomized,
+	gram,
+	streaming
+};
+
+/* Whether score is computed along with the other members of the pca result, on first access or not at all */
+enum class pca_score {
+	eager,
+	lazy,
+	none
+};
+
+/* Floating-point type of computations or results of a PCA, where input means the scalar type of the input matrix */
+enum class pca_precision {
+	input,
+	float32,
+	float64
+};
+
+struct pca_extended_control;
+
 template <>
 struct pydef_impl<hbrs::mpl::pca_control_tag>;
 
@@ -25,14 +25,79 @@
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 #include <boost/hana/second.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstdint>
+#include <edamer/dt/exception.hpp>
 #include <hbrs/mpl/dt/pca_control/impl.hpp>
 #include <memory>
 #include <pybind11/numpy.h>
+#include <string>
+#include <unordered_map>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 namespace hana = boost::hana;
 namespace mpl = hbrs::mpl;
 
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+
+pca_method
+make_pca_method(std::string const& name) {
+	static std::unordered_map<std::string, pca_method> const methods = {
+		{ "svd", pca_method::svd },
+		{ "randomized", pca_method::randomized },
+		{ "gram", pca_method::gram },
+		{ "streaming", pca_method::streaming }
+	};
+	
+	auto it = methods.find(name);
+	if (it == methods.end()) {
+		BOOST_THROW_EXCEPTION((pca_method_not_supported_exception{} << errinfo_pca_method{name}));
+	}
+	return it->second;
+}
+
+pca_score
+make_pca_score(std::string const& name) {
+	static std::unordered_map<std::string, pca_score> const scores = {
+		{ "eager", pca_score::eager },
+		{ "lazy", pca_score::lazy },
+		{ "none", pca_score::none }
+	};
+	
+	auto it = scores.find(name);
+	if (it == scores.end()) {
+		BOOST_THROW_EXCEPTION((pca_score_not_supported_exception{} << errinfo_pca_score{name}));
+	}
+	return it->second;
+}
+
+pca_precision
+make_pca_precision(std::string const& name) {
+	static std::unordered_map<std::string, pca_precision> const precisions = {
+		{ "input", pca_precision::input },
+		{ "float32", pca_precision::float32 },
+		{ "float64", pca_precision::float64 }
+	};
+	
+	auto it = precisions.find(name);
+	if (it == precisions.end()) {
+		BOOST_THROW_EXCEPTION((pca_precision_not_supported_exception{} << errinfo_pca_precision{name}));
+	}
+	return it->second;
+}
+
+/* Convert an option given as enum or by name, unknown names raise the exception thrown by make */
+template<typename Enum>
+Enum
+make_pca_option(py::object const& option, Enum (*make)(std::string const&)) {
+	if (py::isinstance<py::str>(option)) {
+		return make(option.cast<std::string>());
+	}
+	return option.cast<Enum>();
+}
+
+EDAMER_NAMESPACE_END(/* unnamed */)
+
 py::module &
 pydef_impl<hbrs::mpl::pca_control_tag>::apply(py::module & m, py::module & base) {
 	using hbrs::mpl::pca_control;
@@ -112,6 +177,120 @@ pydef_impl<hbrs::mpl::pca_control_tag>::apply(py::module & m, py::module & base)
 		}
 	);
 	
+	py::enum_<pca_method>(m, pystrip("pca_method").c_str())
+		.value("SVD", pca_method::svd)
+		.value("RANDOMIZED", pca_method::randomized)
+		.value("GRAM", pca_method::gram)
+		.value("STREAMING", pca_method::streaming);
+	
+	py::enum_<pca_score>(m, pystrip("pca_score").c_str())
+		.value("EAGER", pca_score::eager)
+		.value("LAZY", pca_score::lazy,
+			"Compute the score from the input on first access, hence the input must not be modified in between")
+		.value("NONE", pca_score::none);
+	
+	py::enum_<pca_precision>(m, pystrip("pca_precision").c_str())
+		.value("INPUT", pca_precision::input)
+		.value("FLOAT32", pca_precision::float32)
+		.value("FLOAT64", pca_precision::float64);
+	
+	py::class_<pca_extended_control>{m, pystrip("pca_extended_control").c_str(), py_pca_control}
+		.def(
+			py::init<
+				bool, bool, bool, pca_method, std::size_t, std::size_t, std::size_t, pca_score, pca_precision,
+				pca_precision, std::uint64_t
+			>(),
+			py::arg("economy"),
+			py::arg("center"),
+			py::arg("normalize"),
+			py::arg("method"),
+			py::arg("num_components") = 0,
+			py::arg("oversampling") = 10,
+			py::arg("power_iterations") = 2,
+			py::arg("score") = pca_score::eager,
+			py::arg("accumulation") = pca_precision::input,
+			py::arg("result_precision") = pca_precision::input,
+			py::arg("seed") = 0
+		)
+		.def_property("economy",
+			[](pca_extended_control & o) { return o.economy(); },
+			[](pca_extended_control & o, bool v) { o.economy() = v; }
+		)
+		.def_property("center",
+			[](pca_extended_control & o) { return o.center(); },
+			[](pca_extended_control & o, bool v) { o.center() = v; }
+		)
+		.def_property("normalize",
+			[](pca_extended_control & o) { return o.normalize(); },
+			[](pca_extended_control & o, bool v) { o.normalize() = v; }
+		)
+		.def_property("method",
+			[](pca_extended_control & o) { return o.method(); },
+			[](pca_extended_control & o, pca_method v) { o.method() = v; }
+		)
+		.def_property("num_components",
+			[](pca_extended_control & o) { return o.num_components(); },
+			[](pca_extended_control & o, std::size_t v) { o.num_components() = v; }
+		)
+		.def_property("oversampling",
+			[](pca_extended_control & o) { return o.oversampling(); },
+			[](pca_extended_control & o, std::size_t v) { o.oversampling() = v; }
+		)
+		.def_property("power_iterations",
+			[](pca_extended_control & o) { return o.power_iterations(); },
+			[](pca_extended_control & o, std::size_t v) { o.power_iterations() = v; }
+		)
+		.def_property("score",
+			[](pca_extended_control & o) { return o.score(); },
+			[](pca_extended_control & o, pca_score v) { o.score() = v; }
+		)
+		.def_property("accumulation",
+			[](pca_extended_control & o) { return o.accumulation(); },
+			[](pca_extended_control & o, pca_precision v) { o.accumulation() = v; }
+		)
+		.def_property("result_precision",
+			[](pca_extended_control & o) { return o.result_precision(); },
+			[](pca_extended_control & o, pca_precision v) { o.result_precision() = v; }
+		)
+		.def_property("seed",
+			[](pca_extended_control & o) { return o.seed(); },
+			[](pca_extended_control & o, std::uint64_t v) { o.seed() = v; }
+		);
+	
+	/* Options can be given as enums or by their lower case names, e.g. method="randomized" like MATLAB's options */
+	py_pca_control.def_static("make",
+		[](
+			bool economy,
+			bool center,
+			bool normalize,
+			py::object const& method,
+			std::size_t num_components,
+			std::size_t oversampling,
+			std::size_t power_iterations,
+			py::object const& score,
+			py::object const& accumulation,
+			py::object const& result_precision,
+			std::uint64_t seed
+		) {
+			return pca_extended_control{
+				economy, center, normalize, make_pca_option(method, &make_pca_method), num_components, oversampling,
+				power_iterations, make_pca_option(score, &make_pca_score),
+				make_pca_option(accumulation, &make_pca_precision),
+				make_pca_option(result_precision, &make_pca_precision), seed};
+		},
+		py::arg("economy"),
+		py::arg("center"),
+		py::arg("normalize"),
+		py::arg("method") = pca_method::svd,
+		py::arg("num_components") = 0,
+		py::arg("oversampling") = 10,
+		py::arg("power_iterations") = 2,
+		py::arg("score") = pca_score::eager,
+		py::arg("accumulation") = pca_precision::input,
+		py::arg("result_precision") = pca_precision::input,
+		py::arg("seed") = 0
+	);
+	
 	return m;
 }
 
@@ -19,8 +19,99 @@
 
 #include "fwd.hpp"
 
+#include <cstddef>
+#include <cstdint>
+
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 
+/* Options of hbrs::mpl's pca_control<bool,bool,bool> plus the choice of the PCA algorithm and its parameters.
+ *
+ * num_components limits the result to the leading principal components, where 0 means all components. The svd method
+ * always computes all components, because Elemental has no truncated SVD, hence num_components only trims its result
+ * and saves neither time nor memory. The randomized method projects the data onto a random subspace of dimension
+ * num_components+oversampling, refines it with power_iterations subspace iterations and always returns an
+ * economy-sized result. Its random test matrix is drawn from a generator with the given seed, hence results are equal
+ * on all processes and reproducible across runs. The gram method (method of
+ * snapshots) computes the eigendecomposition of the nxn matrix x'*x instead of the SVD of the mxn matrix x, which is
+ * much cheaper if m >> n but squares the condition number of x. The streaming method computes the same Gram matrix
+ * and the column means and standard deviations in a single pass over panels of rows of x, without copying x, e.g. for
+ * memory-mapped files which are larger than the main memory. Only the score requires a second pass. Distributed
+ * matrices are decomposed with the gram method instead, because each panel would require collective communication.
+ *
+ * score controls whether the score, which has the size of the input, is computed eagerly, on first access or never.
+ * Lazy scores are computed from the input, hence it must not be modified in between. The result keeps the input
+ * alive, but changes to it, e.g. through a NumPy array the input views, are not detected. Inputs which pybind11
+ * converted from arguments of other types are destroyed after the call, hence their score is computed eagerly.
+ *
+ * accumulation is the precision of all products and reductions, e.g. Gram matrices, while the preprocessed data is
+ * kept in the precision of the input. For example, float32 data with float64 accumulation needs half the memory of
+ * float64 data but forms the covariance without float32 rounding errors. The svd method needs a full copy of the data
+ * in accumulation precision though. result_precision is the precision of coeff, score, latent and mean.
+ */
+struct pca_extended_control {
+	pca_extended_control(
+		bool economy,
+		bool center,
+		bool normalize,
+		pca_method method,
+		std::size_t num_components,
+		std::size_t oversampling,
+		std::size_t power_iterations,
+		pca_score score,
+		pca_precision accumulation,
+		pca_precision result_precision,
+		std::uint64_t seed = 0
+	) : economy_{economy}, center_{center}, normalize_{normalize}, method_{method}, num_components_{num_components},
+	    oversampling_{oversampling}, power_iterations_{power_iterations}, score_{score}, accumulation_{accumulation},
+	    result_precision_{result_precision}, seed_{seed} {}
+	
+	bool & economy() { return economy_; }
+	bool const& economy() const { return economy_; }
+	
+	bool & center() { return center_; }
+	bool const& center() const { return center_; }
+	
+	bool & normalize() { return normalize_; }
+	bool const& normalize() const { return normalize_; }
+	
+	pca_method & method() { return method_; }
+	pca_method const& method() const { return method_; }
+	
+	std::size_t & num_components() { return num_components_; }
+	std::size_t const& num_components() const { return num_components_; }
+	
+	std::size_t & oversampling() { return oversampling_; }
+	std::size_t const& oversampling() const { return oversampling_; }
+	
+	std::size_t & power_iterations() { return power_iterations_; }
+	std::size_t const& power_iterations() const { return power_iterations_; }
+	
+	pca_score & score() { return score_; }
+	pca_score const& score() const { return score_; }
+	
+	pca_precision & accumulation() { return accumulation_; }
+	pca_precision const& accumulation() const { return accumulation_; }
+	
+	pca_precision & result_precision() { return result_precision_; }
+	pca_precision const& result_precision() const { return result_precision_; }
+	
+	std::uint64_t & seed() { return seed_; }
+	std::uint64_t const& seed() const { return seed_; }
+
+private:
+	bool economy_;
+	bool center_;
+	bool normalize_;
+	pca_method method_;
+	std::size_t num_components_;
+	std::size_t oversampling_;
+	std::size_t power_iterations_;
+	pca_score score_;
+	pca_precision accumulation_;
+	pca_precision result_precision_;
+	std::uint64_t seed_;
+};
+
 template <>
 struct EDAMER_API pydef_impl<hbrs::mpl::pca_control_tag> {
 	static py::module &
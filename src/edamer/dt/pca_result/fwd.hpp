@@ -24,6 +24,10 @@
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 
+/* No lazy variant of pca_result has been defined in hbrs::mpl */
+template<typename Coeff, typename Score, typename Latent, typename Mean>
+struct lazy_pca_result;
+
 template <>
 struct pydef_impl<hbrs::mpl::pca_result_tag>;
 
@@ -21,7 +21,6 @@
 #include <boost/hana/cartesian_product.hpp>
 #include <boost/hana/concat.hpp>
 #include <boost/hana/first.hpp>
-#include <boost/hana/flatten.hpp>
 #include <boost/hana/fold_left.hpp>
 #include <boost/hana/for_each.hpp>
 #include <boost/hana/pair.hpp>
@@ -29,6 +28,8 @@
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 #include <boost/hana/second.hpp>
+#include <edamer/detail/elemental.hpp>
+#include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
 #include <edamer/dt/matrix_distribution.hpp>
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
@@ -38,8 +39,10 @@
 	#include <hbrs/mpl/dt/el_dist_vector.hpp>
 #endif // HBRS_MPL_ENABLE_ELEMENTAL
 #include <hbrs/mpl/dt/pca_result/impl.hpp>
+#include <functional>
 #include <memory>
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 namespace hana = boost::hana;
@@ -137,86 +140,125 @@ pydef_impl<hbrs::mpl::pca_result_tag>::apply(py::module & m, py::module & base)
 				hana::make_pair(hana::type_c<dist_row_vector_t>, dist_row_vector_n)
 			);
 	});
-	
-	auto el_pca_result_tns = hana::concat(pca_result_el_matrix_tns, pca_result_el_dist_matrix_tns);
 	#endif // HBRS_MPL_ENABLE_ELEMENTAL
 	
-	hana::for_each(
-		hana::flatten(hana::make_tuple(
-			#ifdef HBRS_MPL_ENABLE_ELEMENTAL
-			el_pca_result_tns
-			#endif // HBRS_MPL_ENABLE_ELEMENTAL
-		)),
-		[&m, &py_pca_result](auto pairs) {
-			auto types = hana::transform(pairs, hana::first);
-			auto names = hana::transform(pairs, hana::second);
-			auto name = boost::format("pca_result<%s>") %
-				hana::fold_left(names, [](std::string s, std::string name) { return s + ',' + name; });
-			
-			using coeff_t = typename decltype(+hana::at_c<0>(types))::type;
-			using score_t = typename decltype(+hana::at_c<1>(types))::type;
-			using latent_t = typename decltype(+hana::at_c<2>(types))::type;
-			using mean_t = typename decltype(+hana::at_c<3>(types))::type;
-			
-			using type_t = pca_result<coeff_t, score_t, latent_t, mean_t>;
-			
-			/* store template function pointers in variables to work around
-			 * "unresolved overloaded function type" errors with GCC9/10
-			 */
-			auto c = py::class_<type_t>{m, pystrip(name.str()).c_str(), py_pca_result}
-				.def(
-					py::init<coeff_t, score_t, latent_t, mean_t>(),
-					py::arg("coeff"),
-					py::arg("score"),
-					py::arg("latent"),
-					py::arg("mean")
-				);
-			
-			if constexpr (std::is_assignable_v<decltype(std::declval<type_t&>().coeff()), coeff_t &>) {
-				c.def_property("coeff",
-					[](type_t & o) { return o.coeff(); },
-					[](type_t & o, coeff_t & v) { o.coeff() = HBRS_MPL_FWD(v); }
-				);
-			} else {
-				c.def_property_readonly("coeff",
-					[](type_t & o) { return o.coeff(); }
-				);
-			}
-			
-			if constexpr (std::is_assignable_v<decltype(std::declval<type_t&>().score()), score_t &>) {
-				c.def_property("score",
-					[](type_t & o) { return o.score(); },
-					[](type_t & o, score_t & v) { o.score() = HBRS_MPL_FWD(v); }
-				);
-			} else {
-				c.def_property_readonly("score",
-					[](type_t & o) { return o.score(); }
-				);
-			}
-			
-			if constexpr (std::is_assignable_v<decltype(std::declval<type_t&>().latent()), latent_t &>) {
-				c.def_property("latent",
-					[](type_t & o) { return o.latent(); },
-					[](type_t & o, latent_t & v) { o.latent() = HBRS_MPL_FWD(v); }
-				);
-			} else {
-				c.def_property_readonly("latent",
-					[](type_t & o) { return o.latent(); }
-				);
-			}
-			
-			if constexpr (std::is_assignable_v<decltype(std::declval<type_t&>().mean()), mean_t &>) {
-				c.def_property("mean",
-					[](type_t & o) { return o.mean(); },
-					[](type_t & o, mean_t & v) { o.mean() = HBRS_MPL_FWD(v); }
-				);
-			} else {
-				c.def_property_readonly("mean",
-					[](type_t & o) { return o.mean(); }
-				);
-			}
+	auto def_pca_result = [m, py_pca_result](auto pairs) mutable {
+		auto types = hana::transform(pairs, hana::first);
+		auto names = hana::transform(pairs, hana::second);
+		auto name = boost::format("pca_result<%s>") %
+			hana::fold_left(names, [](std::string s, std::string name) { return s + ',' + name; });
+		
+		using coeff_t = typename decltype(+hana::at_c<0>(types))::type;
+		using score_t = typename decltype(+hana::at_c<1>(types))::type;
+		using latent_t = typename decltype(+hana::at_c<2>(types))::type;
+		using mean_t = typename decltype(+hana::at_c<3>(types))::type;
+		
+		using type_t = pca_result<coeff_t, score_t, latent_t, mean_t>;
+		
+		/* store template function pointers in variables to work around
+		 * "unresolved overloaded function type" errors with GCC9/10
+		 */
+		auto c = py::class_<type_t>{m, pystrip(name.str()).c_str(), py_pca_result}
+			.def(
+				py::init<coeff_t, score_t, latent_t, mean_t>(),
+				py::arg("coeff"),
+				py::arg("score"),
+				py::arg("latent"),
+				py::arg("mean")
+			);
+		
+		if constexpr (std::is_assignable_v<decltype(std::declval<type_t&>().coeff()), coeff_t &>) {
+			c.def_property("coeff",
+				[](type_t & o) { return o.coeff(); },
+				[](type_t & o, coeff_t & v) { o.coeff() = HBRS_MPL_FWD(v); }
+			);
+		} else {
+			c.def_property_readonly("coeff",
+				[](type_t & o) { return o.coeff(); }
+			);
 		}
-	);
+		
+		if constexpr (std::is_assignable_v<decltype(std::declval<type_t&>().score()), score_t &>) {
+			c.def_property("score",
+				[](type_t & o) { return o.score(); },
+				[](type_t & o, score_t & v) { o.score() = HBRS_MPL_FWD(v); }
+			);
+		} else {
+			c.def_property_readonly("score",
+				[](type_t & o) { return o.score(); }
+			);
+		}
+		
+		if constexpr (std::is_assignable_v<decltype(std::declval<type_t&>().latent()), latent_t &>) {
+			c.def_property("latent",
+				[](type_t & o) { return o.latent(); },
+				[](type_t & o, latent_t & v) { o.latent() = HBRS_MPL_FWD(v); }
+			);
+		} else {
+			c.def_property_readonly("latent",
+				[](type_t & o) { return o.latent(); }
+			);
+		}
+		
+		if constexpr (std::is_assignable_v<decltype(std::declval<type_t&>().mean()), mean_t &>) {
+			c.def_property("mean",
+				[](type_t & o) { return o.mean(); },
+				[](type_t & o, mean_t & v) { o.mean() = HBRS_MPL_FWD(v); }
+			);
+		} else {
+			c.def_property_readonly("mean",
+				[](type_t & o) { return o.mean(); }
+			);
+		}
+		
+		using lazy_type_t = lazy_pca_result<coeff_t, score_t, latent_t, mean_t>;
+		auto lazy_name = boost::format("lazy_pca_result<%s>") %
+			hana::fold_left(names, [](std::string s, std::string name) { return s + ',' + name; });
+		
+		py::class_<lazy_type_t>{m, pystrip(lazy_name.str()).c_str(), py_pca_result}
+			.def_property_readonly("coeff",
+				[](lazy_type_t & o) { return o.coeff(); }
+			)
+			.def_property_readonly("score",
+				[](lazy_type_t & o) -> py::object {
+					// score is None if it has been skipped
+					if (!o.has_score()) {
+						return py::none();
+					}
+					
+					/* Computing a lazy score does not touch Python objects, but make_score holds a reference to the
+					 * input, which is released when make_score is destroyed after the GIL has been reacquired
+					 */
+					std::function<score_t()> make_score;
+					return py::cast(detail::without_gil([&o, &make_score]() -> decltype(auto) {
+						return o.score(make_score);
+					}));
+				}
+			)
+			.def_property_readonly("latent",
+				[](lazy_type_t & o) { return o.latent(); }
+			)
+			.def_property_readonly("mean",
+				[](lazy_type_t & o) { return o.mean(); }
+			)
+			.def_property_readonly("scale",
+				// standard deviations of the columns of a normalized input or None
+				[](lazy_type_t & o) { return o.scale(); }
+			)
+			.def("has_score", &lazy_type_t::has_score);
+	};
+	
+	#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+	hana::for_each(pca_result_el_matrix_tns, def_pca_result);
+	
+	// Results of distributed PCAs are registered on first use of their ring
+	hana::for_each(pca_result_el_dist_matrix_tns, [&def_pca_result](auto pairs) {
+		using coeff_t = typename decltype(+hana::first(hana::at_c<0>(pairs)))::type;
+		using ring_t = detail::el_ring_t<decltype(std::declval<coeff_t&>().data())>;
+		
+		detail::defer_pydef(typeid(ring_t), [def_pca_result, pairs]() mutable { def_pca_result(pairs); });
+	});
+	#endif // HBRS_MPL_ENABLE_ELEMENTAL
 	
 	return m;
 }
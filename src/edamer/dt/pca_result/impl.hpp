@@ -19,8 +19,76 @@
 
 #include "fwd.hpp"
 
+#include <boost/assert.hpp>
+#include <functional>
+#include <optional>
+#include <utility>
+
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 
+/* Like hbrs::mpl's pca_result<>, but score, which has the size of the input and hence is by far the largest member, is
+ * computed by make_score on first access only. Without score and make_score, e.g. if the PCA has been told to skip the
+ * score, has_score() returns false and score() must not be called.
+ *
+ * Unlike pca_result<>, it records the standard deviations by which the columns of the input have been divided if the
+ * PCA normalized them, because they cannot be recovered from coeff but are required to project other data.
+ */
+template<typename Coeff, typename Score, typename Latent, typename Mean>
+struct lazy_pca_result {
+	lazy_pca_result(
+		Coeff coeff,
+		std::optional<Score> score,
+		std::function<Score()> make_score,
+		Latent latent,
+		Mean mean,
+		std::optional<Mean> scale
+	)
+	: coeff_{std::move(coeff)}, score_{std::move(score)}, make_score_{std::move(make_score)},
+	  latent_{std::move(latent)}, mean_{std::move(mean)}, scale_{std::move(scale)} {}
+	
+	Coeff & coeff() { return coeff_; }
+	Coeff const& coeff() const { return coeff_; }
+	
+	bool
+	has_score() const { return score_.has_value() || static_cast<bool>(make_score_); }
+	
+	Score &
+	score() {
+		std::function<Score()> used;
+		return score(used);
+	}
+	
+	/* Like score(), but a make_score which has been called is moved into used instead of being destroyed here. Its
+	 * captures, e.g. references to Python objects of the input, may then be released where it is safe to do so, i.e.
+	 * with the GIL held.
+	 */
+	Score &
+	score(std::function<Score()> & used) {
+		BOOST_ASSERT(has_score());
+		if (!score_) {
+			score_.emplace(make_score_());
+			used = std::exchange(make_score_, nullptr);
+		}
+		return *score_;
+	}
+	
+	Latent & latent() { return latent_; }
+	Latent const& latent() const { return latent_; }
+	
+	Mean & mean() { return mean_; }
+	Mean const& mean() const { return mean_; }
+	
+	std::optional<Mean> const& scale() const { return scale_; }
+
+private:
+	Coeff coeff_;
+	std::optional<Score> score_;
+	std::function<Score()> make_score_;
+	Latent latent_;
+	Mean mean_;
+	std::optional<Mean> scale_;
+};
+
 template <>
 struct EDAMER_API pydef_impl<hbrs::mpl::pca_result_tag> {
 	static py::module &
@@ -5,4 +5,46 @@
 #
 # Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
 
+from edamer.cpp.detail import submit as _submit
+import edamer.cpp.fn as _cpp_fn
 from edamer.cpp.fn import *  # noqa 401
+from .graph import Node, evaluate, lazy, wrap as _wrap  # noqa 401
+
+
+def _wrappable(name, f):
+    # expressions of expand() are compared with edamer.fn.expand, hence it is not wrapped
+    return not name.startswith('_') and name != 'expand' and callable(f) and not isinstance(f, type)
+
+
+def __getattr__(name):
+    # classes and functions of distributed matrices are registered on first use of their scalar type
+    f = getattr(_cpp_fn, name)
+    if not _wrappable(name, f):
+        return f
+    globals()[name] = _wrap(name)
+    return globals()[name]
+
+
+# accept expression graph nodes in all functions, see edamer.fn.graph
+for _name, _f in list(vars(_cpp_fn).items()):
+    if _wrappable(_name, _f):
+        globals()[_name] = _wrap(_name)
+
+
+def _async(f):
+    def f_async(*args, **kwargs):
+        return _submit(f, *args, **kwargs)
+    f_async.__name__ = f.__name__ + '_async'
+    f_async.__doc__ = 'Like %s() but executed in a C++ worker thread, returns a concurrent.futures.Future' % f.__name__
+    return f_async
+
+
+multiply_async = _async(multiply)  # noqa F405
+pca_async = _async(pca)  # noqa F405
+pca_transform_async = _async(pca_transform)  # noqa F405
+pca_inverse_transform_async = _async(pca_inverse_transform)  # noqa F405
+plus_async = _async(plus)  # noqa F405
+transpose_async = _async(transpose)  # noqa F405
+mean_async = _async(mean)  # noqa F405
+var_async = _async(var)  # noqa F405
+std_async = _async(std)  # noqa F405
@@ -0,0 +1,103 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "elemental.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <cstddef>
+#include <edamer/detail/elementwise.hpp>
+#include <edamer/detail/pybind11.hpp>
+#include <string>
+#include <vector>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+/* Register elementwise function op as name(a, b, out=None) */
+void
+def_elementwise(py::module & m, char const* name, detail::elementwise_op op, char const* doc) {
+	m.def(name,
+		[op, name](py::object const& a, py::object const& b, py::object const& out) {
+			return detail::elementwise(a, b, out, op, name);
+		},
+		py::arg("a"),
+		py::arg("b"),
+		py::arg("out") = py::none(),
+		doc
+	);
+}
+EDAMER_NAMESPACE_END(/* unnamed */)
+
+py::module &
+pydef_impl<detail::elementwise_impl_el_matrix_el_dist_matrix>::apply(py::module & m, py::module & base) {
+	using detail::elementwise_op;
+	
+	def_elementwise(m, "minus", elementwise_op::minus,
+		"Compute a - b entrywise with implicit expansion of scalars, vectors and expand() expressions");
+	def_elementwise(m, "times", elementwise_op::times,
+		"Compute a .* b entrywise with implicit expansion of scalars, vectors and expand() expressions");
+	def_elementwise(m, "rdivide", elementwise_op::rdivide,
+		"Compute a ./ b entrywise with implicit expansion of scalars, vectors and expand() expressions");
+	def_elementwise(m, "power", elementwise_op::power,
+		"Compute a .^ b entrywise with implicit expansion of scalars, vectors and expand() expressions");
+	
+	// Like MATLAB's logical arrays but of the ring of the operands, i.e. true and false are stored as 1 and 0
+	def_elementwise(m, "eq", elementwise_op::eq, "Compare a == b entrywise, true is 1 and false is 0");
+	def_elementwise(m, "ne", elementwise_op::ne, "Compare a ~= b entrywise, true is 1 and false is 0");
+	
+	// Orderings are undefined for complex rings, hence lt, le, gt and ge support real rings only
+	def_elementwise(m, "lt", elementwise_op::lt, "Compare a < b entrywise, true is 1 and false is 0");
+	def_elementwise(m, "le", elementwise_op::le, "Compare a <= b entrywise, true is 1 and false is 0");
+	def_elementwise(m, "gt", elementwise_op::gt, "Compare a > b entrywise, true is 1 and false is 0");
+	def_elementwise(m, "ge", elementwise_op::ge, "Compare a >= b entrywise, true is 1 and false is 0");
+	
+	/* Backend of edamer.fn.evaluate() which fuses chains of elementwise functions into a single program */
+	auto m_detail = base.attr("detail").cast<py::module_>();
+	m_detail.def("elementwise_fused",
+		[](py::list const& operands, py::list const& program, py::object const& out) {
+			std::vector<py::handle> ops(operands.begin(), operands.end());
+			
+			std::vector<detail::elementwise_instruction> instructions;
+			instructions.reserve(program.size());
+			for (py::handle instruction : program) {
+				auto t = instruction.cast<py::tuple>();
+				if (t.size() != 3) {
+					throw py::value_error{"elementwise instructions must be tuples (function, lhs, rhs)"};
+				}
+				instructions.push_back({
+					detail::make_elementwise_op(t[0].cast<std::string>()),
+					t[1].cast<std::size_t>(),
+					t[2].cast<std::size_t>()
+				});
+			}
+			return detail::elementwise(ops, instructions, out, "elementwise_fused");
+		},
+		py::arg("operands"),
+		py::arg("program"),
+		py::arg("out") = py::none(),
+		"Evaluate a program of elementwise functions on operands in a single pass. Each instruction (function, lhs, "
+		"rhs) applies function, e.g. 'plus' or 'rdivide', to values lhs and rhs which index operands followed by the "
+		"results of preceding instructions. Returns the result of the last instruction, written into out if out is not "
+		"None."
+	);
+	return m;
+}
+
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
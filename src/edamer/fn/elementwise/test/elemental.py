@@ -0,0 +1,294 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+from edamer import detail, dt, fn
+import logging
+from mpi4py import MPI
+import numpy as np
+import pytest
+
+TestArguments = dict(
+    dist=[
+        (dt.ElDist.STAR, dt.ElDist.STAR),
+        (dt.ElDist.MC, dt.ElDist.MR),
+        (dt.ElDist.VC, dt.ElDist.STAR),
+        (dt.ElDist.CIRC, dt.ElDist.CIRC)
+    ]
+)
+
+Functions = [
+    (fn.plus, np.add),
+    (fn.minus, np.subtract),
+    (fn.times, np.multiply),
+    (fn.rdivide, np.divide),
+    (fn.power, np.power),
+    (fn.eq, np.equal),
+    (fn.ne, np.not_equal),
+    (fn.lt, np.less),
+    (fn.le, np.less_equal),
+    (fn.gt, np.greater),
+    (fn.ge, np.greater_equal)
+]
+
+
+@pytest.fixture
+def env():
+    class Environment():
+        comm = MPI.COMM_WORLD
+        size = comm.Get_size()
+        rank = comm.Get_rank()
+        grid = dt.ElGrid(comm)
+    return Environment()
+
+
+def test_fn_elementwise_el_matrix(env):
+    rng = np.random.default_rng(0)
+    a_np = np.asarray(rng.uniform(1, 2, (30, 20)), order='F')
+    row_np = np.asarray(rng.uniform(1, 2, 20), order='F')
+    col_np = np.asarray(rng.uniform(1, 2, 30), order='F')
+
+    a = dt.ElMatrix.view_from_numpy(a_np)
+    row = dt.ElRowVector.view_from_numpy(row_np)
+    col = dt.ElColumnVector.view_from_numpy(col_np)
+
+    for f, f_np in Functions:
+        logging.debug('f: %r' % f)
+        # matrix with matrix, scalar, row vector and column vector like MATLAB's implicit expansion
+        assert np.allclose(f(a, a).view_to_numpy(), f_np(a_np, a_np))
+        assert np.allclose(f(a, 1.5).view_to_numpy(), f_np(a_np, 1.5))
+        assert np.allclose(f(1.5, a).view_to_numpy(), f_np(1.5, a_np))
+        assert np.allclose(f(a, row).view_to_numpy(), f_np(a_np, row_np[np.newaxis, :]))
+        assert np.allclose(f(col, a).view_to_numpy(), f_np(col_np[:, np.newaxis], a_np))
+        assert np.allclose(f(col, row).view_to_numpy(), f_np(col_np[:, np.newaxis], row_np[np.newaxis, :]))
+
+    out_np = a_np.copy(order='F')
+    out = dt.ElMatrix.view_from_numpy(out_np)
+    assert fn.minus(out, row, out=out) is out
+    assert np.allclose(out_np, a_np - row_np[np.newaxis, :])
+
+    with pytest.raises(dt.IncompatibleMatrixException):
+        fn.minus(a, dt.ElMatrix.view_from_numpy(np.zeros((20, 30), order='F')))
+
+    with pytest.raises(TypeError):
+        fn.lt(dt.ElMatrix.view_from_numpy(a_np.astype(np.complex128, order='F')), 1.0)
+
+
+def test_fn_rdivide_integers(env):
+    imax, imin = np.iinfo(np.intc).max, np.iinfo(np.intc).min
+    a_np = np.asarray([[7, -7, 0, imin], [5, -5, imax, 1]], dtype=np.intc, order='F')
+    a = dt.ElMatrix.view_from_numpy(a_np)
+
+    # like MATLAB's, quotients of integers are rounded to the nearest integer, ties away from zero
+    assert np.array_equal(fn.rdivide(a, 2).view_to_numpy(), [[4, -4, 0, imin // 2], [3, -3, imax // 2 + 1, 1]])
+
+    # and saturate instead of trapping on division by zero or overflowing
+    assert np.array_equal(fn.rdivide(a, 0).view_to_numpy(), [[imax, imin, 0, imin], [imax, imin, imax, imax]])
+    assert np.array_equal(fn.rdivide(a, -1).view_to_numpy(), [[-7, 7, 0, imax], [-5, 5, -imax, -1]])
+
+    b_np = np.asarray([[0, 2, 0, -1], [-2, 0, 3, 0]], dtype=np.intc, order='F')
+    c = fn.rdivide(a, dt.ElMatrix.view_from_numpy(b_np)).view_to_numpy()
+    assert c.dtype == np.intc
+    assert np.array_equal(c, [[imax, -4, 0, imax], [-3, imin, round(imax / 3), imax]])
+
+
+def test_fn_saturating_integers(env):
+    imax, imin = np.iinfo(np.intc).max, np.iinfo(np.intc).min
+    a_np = np.asarray([[imax, imin, 7], [imax - 1, imin + 1, -7]], dtype=np.intc, order='F')
+    a = dt.ElMatrix.view_from_numpy(a_np)
+
+    # like MATLAB's, sums, differences and products of integers saturate instead of overflowing
+    assert np.array_equal(fn.plus(a, 2).view_to_numpy(), [[imax, imin + 2, 9], [imax, imin + 3, -5]])
+    assert np.array_equal(fn.plus(a, a).view_to_numpy(), [[imax, imin, 14], [imax, imin, -14]])
+    assert np.array_equal(fn.minus(a, 2).view_to_numpy(), [[imax - 2, imin, 5], [imax - 3, imin, -9]])
+    assert np.array_equal(fn.minus(0, a).view_to_numpy(), [[-imax, imax, -7], [-imax + 1, imax, 7]])
+    c = fn.times(a, -3).view_to_numpy()
+    assert c.dtype == np.intc
+    assert np.array_equal(c, [[imin, imax, -21], [imin, imax, 21]])
+
+    out_np = a_np.copy(order='F')
+    out = dt.ElMatrix.view_from_numpy(out_np)
+    assert fn.plus(out, out, out=out) is out
+    assert np.array_equal(out_np, [[imax, imin, 14], [imax, imin, -14]])
+
+
+def test_fn_power_integers(env):
+    imax, imin = np.iinfo(np.intc).max, np.iinfo(np.intc).min
+    a_np = np.asarray([[2, -2, 0, 3], [1, -1, 10, 46341]], dtype=np.intc, order='F')
+    a = dt.ElMatrix.view_from_numpy(a_np)
+
+    c = fn.power(a, 3).view_to_numpy()
+    assert c.dtype == np.intc
+    assert np.array_equal(c, [[8, -8, 0, 27], [1, -1, 1000, imax]])
+
+    # powers which do not fit saturate instead of being cast out of range
+    assert np.array_equal(fn.power(a, 31).view_to_numpy(), [[imax, imin, 0, imax], [1, -1, imax, imax]])
+    assert np.array_equal(fn.power(a, 2).view_to_numpy(), [[4, 4, 0, 9], [1, 1, 100, imax]])
+
+    # like MATLAB's, negative exponents are rounded to the nearest integer, ties away from zero, and 0^-1 saturates
+    assert np.array_equal(fn.power(a, -1).view_to_numpy(), [[1, -1, imax, 0], [1, -1, 0, 0]])
+    assert np.array_equal(fn.power(a, -2).view_to_numpy(), [[0, 0, imax, 0], [1, 1, 0, 0]])
+
+    e = dt.ElMatrix.view_from_numpy(np.asarray([[30, 31, 32, -1]], dtype=np.intc, order='F'))
+    assert np.array_equal(fn.power(2, e).view_to_numpy(), [[2**30, imax, imax, 1]])
+
+
+def test_fn_rdivide_float32_and_complex(env):
+    rng = np.random.default_rng(0)
+    # lengths which are not a multiple of the vector width exercise the scalar tail of vectorized kernels
+    a_np = np.asarray(rng.uniform(1, 2, (31, 7)), dtype=np.float32, order='F')
+    b_np = np.asarray(rng.uniform(1, 2, (31, 7)), dtype=np.float32, order='F')
+    a = dt.ElMatrix.view_from_numpy(a_np)
+    b = dt.ElMatrix.view_from_numpy(b_np)
+
+    c = fn.rdivide(a, b).view_to_numpy()
+    assert c.dtype == np.float32
+    assert np.allclose(c, a_np / b_np, rtol=1e-6)
+    assert np.allclose(fn.rdivide(1.5, a).view_to_numpy(), np.float32(1.5) / a_np, rtol=1e-6)
+    # floating point division by zero follows IEEE 754
+    assert np.all(np.isinf(fn.rdivide(a, 0.0).view_to_numpy()))
+
+    z_np = np.asarray(a_np + 1j * b_np, dtype=np.complex128, order='F')
+    w_np = np.asarray(b_np - 2j * a_np, dtype=np.complex128, order='F')
+    z = dt.ElMatrix.view_from_numpy(z_np)
+    w = dt.ElMatrix.view_from_numpy(w_np)
+
+    assert np.allclose(fn.rdivide(z, w).view_to_numpy(), z_np / w_np)
+    assert np.allclose(fn.rdivide(z, 1.5 - 0.5j).view_to_numpy(), z_np / (1.5 - 0.5j))
+
+
+@pytest.mark.parametrize("dist", TestArguments["dist"])
+def test_fn_elementwise_el_dist_matrix(env, dist):
+    logging.debug('dist: %r' % (dist,))
+
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+    dist_el = dt.MatrixDistribution.make(dist[0], dist[1], dt.ElDistWrap.ELEMENT)
+
+    rng = np.random.default_rng(0)
+    a_np = np.asarray(rng.uniform(1, 2, (30, 20)), order='F')
+    b_np = np.asarray(rng.uniform(1, 2, (30, 20)), order='F')
+    row_np = np.asarray(rng.uniform(1, 2, 20), order='F')
+    col_np = np.asarray(rng.uniform(1, 2, 30), order='F')
+
+    a = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(a_np), dist_star_star_el).copy(dist_el)
+    b = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(b_np), dist_star_star_el).copy(dist_mc_mr_el)
+    row = dt.ElDistRowVector.make_view(env.grid, dt.ElRowVector.view_from_numpy(row_np), dist_star_star_el)
+    col = dt.ElDistColumnVector.make_view(env.grid, dt.ElColumnVector.view_from_numpy(col_np), dist_star_star_el)
+
+    for f, f_np in Functions:
+        logging.debug('f: %r' % f)
+        assert np.allclose(detail.test.to_numpy_2d(f(a, 1.5)), f_np(a_np, 1.5))
+        # b is redistributed to the distribution of a
+        assert np.allclose(detail.test.to_numpy_2d(f(a, b)), f_np(a_np, b_np))
+        assert np.allclose(
+            detail.test.to_numpy_2d(f(a, fn.expand(row, fn.size(a)))), f_np(a_np, row_np[np.newaxis, :]))
+        assert np.allclose(
+            detail.test.to_numpy_2d(f(fn.expand(col, fn.size(a)), a)), f_np(col_np[:, np.newaxis], a_np))
+        # expansion of both a column and a row vector results in a [MC,MR] matrix
+        assert np.allclose(
+            detail.test.to_numpy_2d(f(col, row)), f_np(col_np[:, np.newaxis], row_np[np.newaxis, :]))
+
+    # results are abstract if an operand is abstract
+    c = fn.times(a.abstract(), 2.0)
+    assert isinstance(c, dt.ElAbstractDistMatrix)
+    assert np.allclose(detail.test.to_numpy_2d(c.typed()), a_np * 2.0)
+
+    out = a.copy()
+    assert fn.rdivide(out, fn.expand(row, fn.size(a)), out=out) is out
+    assert np.allclose(detail.test.to_numpy_2d(out), a_np / row_np[np.newaxis, :])
+
+    with pytest.raises(dt.IncompatibleMatrixException):
+        out = dt.ElDistMatrix.make_view(
+            env.grid, dt.ElMatrix.view_from_numpy(np.zeros((20, 30), order='F')), dist_star_star_el)
+        fn.minus(a, fn.expand(row, fn.size(a)), out=out)
+
+    with pytest.raises(TypeError):
+        fn.minus(a, dt.ElMatrix.view_from_numpy(a_np))
+
+
+def test_fn_evaluate_el_matrix(env):
+    rng = np.random.default_rng(0)
+    a_np = np.asarray(rng.uniform(1, 2, (30, 20)), order='F')
+    b_np = np.asarray(rng.uniform(1, 2, (20, 30)), order='F')
+    row_np = np.asarray(rng.uniform(1, 2, 20), order='F')
+
+    a = dt.ElMatrix.view_from_numpy(a_np)
+    b = dt.ElMatrix.view_from_numpy(b_np)
+    row = dt.ElRowVector.view_from_numpy(row_np)
+
+    with fn.lazy():
+        x = fn.minus(a, row)
+        y = x * x / (fn.plus(a, 1.0) + x * x)
+        z = fn.multiply(fn.transpose(fn.multiply(a, b)), a)
+        w = fn.transpose(fn.transpose(a)) >= 1.5
+    assert isinstance(y, fn.Node)
+
+    x_np = a_np - row_np[np.newaxis, :]
+    y_ = fn.evaluate(y)
+    assert np.allclose(y_.view_to_numpy(), x_np * x_np / (a_np + 1.0 + x_np * x_np))
+    # results are not cached, i.e. each evaluation reads the current values of the operands
+    assert y.eval() is not y_
+    a_saved_np = a_np.copy()
+    a_np += 1.0
+    x_1_np = a_np - row_np[np.newaxis, :]
+    assert np.allclose(y.eval().view_to_numpy(), x_1_np * x_1_np / (a_np + 1.0 + x_1_np * x_1_np))
+    assert np.allclose(y_.view_to_numpy(), x_np * x_np / (a_saved_np + 1.0 + x_np * x_np))
+    a_np[...] = a_saved_np
+
+    z_, w_ = fn.evaluate(z, w)
+    assert np.allclose(z_.view_to_numpy(), (a_np @ b_np).T @ a_np)
+    assert np.allclose(w_.view_to_numpy(), a_np >= 1.5)
+
+    # nodes are materialized implicitly and operands of nodes with out= are fused into out
+    assert fn.size(x).m == 30
+    out_np = np.zeros((30, 20), order='F')
+    out = dt.ElMatrix.view_from_numpy(out_np)
+    assert fn.times(x, 2.0, out=out) is out
+    assert np.allclose(out_np, x_np * 2.0)
+
+    # out is written if the expression is optimized to a leaf, too
+    assert fn.evaluate(y, out=out) is out
+    assert np.allclose(out_np, y_.view_to_numpy())
+    with fn.lazy():
+        t = fn.transpose(fn.transpose(a))
+    assert fn.evaluate(t, out=out) is out
+    assert np.array_equal(out_np, a_np)
+    assert fn.evaluate(a, out=out) is out
+
+    # without lazy mode functions are evaluated immediately
+    assert isinstance(fn.plus(a, 1.0), dt.ElMatrix)
+
+    with pytest.raises(ValueError):
+        detail.elementwise_fused([a, 1.0], [('plus', 0, 2)])
+
+
+@pytest.mark.parametrize("dist", TestArguments["dist"])
+def test_fn_evaluate_el_dist_matrix(env, dist):
+    logging.debug('dist: %r' % (dist,))
+
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+    dist_el = dt.MatrixDistribution.make(dist[0], dist[1], dt.ElDistWrap.ELEMENT)
+
+    rng = np.random.default_rng(0)
+    a_np = np.asarray(rng.uniform(1, 2, (30, 20)), order='F')
+    b_np = np.asarray(rng.uniform(1, 2, (30, 20)), order='F')
+    row_np = np.asarray(rng.uniform(1, 2, 20), order='F')
+
+    a = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(a_np), dist_star_star_el).copy(dist_el)
+    b = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(b_np), dist_star_star_el).copy(dist_mc_mr_el)
+    row = dt.ElDistRowVector.make_view(env.grid, dt.ElRowVector.view_from_numpy(row_np), dist_star_star_el)
+
+    # b is redistributed once although it is read three times
+    with fn.lazy():
+        c = (fn.minus(a, fn.expand(row, fn.size(a))) * b + b) / b
+    assert np.allclose(
+        detail.test.to_numpy_2d(c.eval()), ((a_np - row_np[np.newaxis, :]) * b_np + b_np) / b_np)
+
+    with fn.lazy():
+        d = fn.multiply(fn.transpose(b), b) - 1.0
+    assert np.allclose(detail.test.to_numpy_2d(fn.evaluate(d)), b_np.T @ b_np - 1.0)
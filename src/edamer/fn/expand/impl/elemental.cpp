@@ -27,6 +27,7 @@
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 #include <boost/hana/second.hpp>
+#include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
 #include <edamer/dt/matrix_distribution.hpp>
 #include <edamer/dt/expression.hpp> // include type_caster<hbrs::mpl::expression<Operation, Operands>>
@@ -73,7 +74,7 @@ _EL_VECTOR(row)
 		                                                                                                               \
 		using hbrs::mpl::el_dist_ ## vector_kind ## _vector;                                                           \
 		                                                                                                               \
-		hana::for_each(ring_tns, [&m, &base](auto ring_tn) {                                                           \
+		detail::for_each_deferred(ring_tns, [m, base](auto ring_tn) mutable {                                          \
 			using ring_t = typename decltype(+hana::first(ring_tn))::type;                                             \
 			auto ring_n = hana::second(ring_tn);                                                                       \
 			                                                                                                           \
@@ -0,0 +1,341 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+"""Expression graphs with deferred evaluation
+
+Within a `with edamer.fn.lazy():` block, elementwise functions, multiply() and transpose() return nodes of an
+expression graph instead of computing their results. Nodes support Python's operators, too, i.e. + - * / ** == != <
+<= > >= for elementwise functions, @ for multiply() and .T for transpose(). A node is evaluated by edamer.fn.evaluate(),
+by its eval() method or implicitly when it is passed to any other function of edamer.fn. Before evaluation the graph
+is optimized:
+
+* Equal calls on the same operands, i.e. common subexpressions, are computed once.
+* transpose(transpose(a)) is replaced by a and transpose(multiply(a, b)) by multiply(transpose(b), transpose(a)).
+  Transposes of operands of multiply() are passed to GEMM instead of being materialized.
+* Elementwise functions whose intermediate results are not used elsewhere are fused into a single pass over local
+  matrices. It allocates the result only, or none if out is given, and redistributes each operand at most once.
+
+Results are not cached in nodes, i.e. each evaluation computes a new result from the current values of the operands.
+Pass expressions which share subexpressions to a single call of edamer.fn.evaluate() to compute them once.
+"""
+
+import collections
+import contextvars
+import functools
+
+import edamer.cpp.detail as _detail
+import edamer.cpp.fn as _fn
+
+ELEMENTWISE = ('plus', 'minus', 'times', 'rdivide', 'power', 'eq', 'ne', 'lt', 'le', 'gt', 'ge')
+
+_lazy = contextvars.ContextVar('edamer_fn_lazy', default=False)
+
+
+class lazy:
+    """Context manager in which elementwise functions, multiply() and transpose() return expression graph nodes"""
+
+    def __enter__(self):
+        self._token = _lazy.set(True)
+        return self
+
+    def __exit__(self, *exc_info):
+        _lazy.reset(self._token)
+        return False
+
+
+class Node:
+    """Deferred call of function op of edamer.fn on args, which are nodes, matrices, vectors or scalars"""
+
+    __slots__ = ('op', 'args')
+
+    def __init__(self, op, args):
+        self.op = op
+        self.args = tuple(args)
+
+    def __repr__(self):
+        return 'Node(%r, %r)' % (self.op, self.args)
+
+    def __bool__(self):
+        raise TypeError('truth value of an unevaluated expression is undefined, call eval() first')
+
+    def eval(self):
+        return evaluate(self)
+
+    @property
+    def T(self):
+        return Node('transpose', (self,))
+
+    def __add__(self, other):
+        return Node('plus', (self, other))
+
+    def __radd__(self, other):
+        return Node('plus', (other, self))
+
+    def __sub__(self, other):
+        return Node('minus', (self, other))
+
+    def __rsub__(self, other):
+        return Node('minus', (other, self))
+
+    def __mul__(self, other):
+        return Node('times', (self, other))
+
+    def __rmul__(self, other):
+        return Node('times', (other, self))
+
+    def __truediv__(self, other):
+        return Node('rdivide', (self, other))
+
+    def __rtruediv__(self, other):
+        return Node('rdivide', (other, self))
+
+    def __pow__(self, other):
+        return Node('power', (self, other))
+
+    def __rpow__(self, other):
+        return Node('power', (other, self))
+
+    def __neg__(self):
+        return Node('times', (self, -1))
+
+    def __matmul__(self, other):
+        return Node('multiply', (self, other))
+
+    def __rmatmul__(self, other):
+        return Node('multiply', (other, self))
+
+    def __eq__(self, other):
+        return Node('eq', (self, other))
+
+    def __ne__(self, other):
+        return Node('ne', (self, other))
+
+    def __lt__(self, other):
+        return Node('lt', (self, other))
+
+    def __le__(self, other):
+        return Node('le', (self, other))
+
+    def __gt__(self, other):
+        return Node('gt', (self, other))
+
+    def __ge__(self, other):
+        return Node('ge', (self, other))
+
+    __hash__ = object.__hash__
+
+
+def _consumers(roots):
+    """Number of references to each node of the graph, by id, where roots count as referenced once more"""
+    count = collections.Counter(id(x) for x in roots if isinstance(x, Node))
+    stack = [x for x in roots if isinstance(x, Node)]
+    seen = set()
+    while stack:
+        x = stack.pop()
+        if id(x) in seen:
+            continue
+        seen.add(id(x))
+        for y in x.args:
+            if isinstance(y, Node):
+                count[id(y)] += 1
+                stack.append(y)
+    return count
+
+
+class _Evaluator:
+    """Optimizes and evaluates a graph, all graph nodes are created via make() to identify equal subexpressions"""
+
+    def __init__(self):
+        self.nodes = {}
+        self.keys = {}
+        self.values = {}
+        self.materialized = {}
+        self.consumers = collections.Counter()
+
+    def key(self, x):
+        if isinstance(x, Node):
+            return self.keys[id(x)]
+        if isinstance(x, (bool, int, float, complex)):
+            return (type(x), repr(x))
+        # matrices and vectors are distinct unless identical
+        return id(x)
+
+    def make(self, op, args):
+        key = (op,) + tuple(self.key(x) for x in args)
+        node = self.nodes.get(key)
+        if node is None:
+            node = self.nodes[key] = Node(op, args)
+            self.keys[id(node)] = key
+        return node
+
+    def transpose(self, x):
+        if isinstance(x, Node) and x.op == 'transpose':
+            return x.args[0]
+        return self.make('transpose', (x,))
+
+    def canonical(self, x, memo):
+        """Identify common subexpressions and remove double transposes"""
+        if not isinstance(x, Node):
+            return x
+        if id(x) not in memo:
+            args = [self.canonical(y, memo) for y in x.args]
+            memo[id(x)] = self.transpose(args[0]) if x.op == 'transpose' else self.make(x.op, args)
+        return memo[id(x)]
+
+    def push_transposes(self, x, memo):
+        """Replace transposes of products which are used once with products of transposes"""
+        if not isinstance(x, Node):
+            return x
+        if id(x) not in memo:
+            args = [self.push_transposes(y, memo) for y in x.args]
+            a = x.args[0]
+            if x.op == 'transpose' and isinstance(a, Node) and a.op == 'multiply' and self.consumers[id(a)] == 1:
+                a_args = memo[id(a)].args
+                memo[id(x)] = self.make('multiply', (self.transpose(a_args[1]), self.transpose(a_args[0])))
+            elif x.op == 'transpose':
+                memo[id(x)] = self.transpose(args[0])
+            else:
+                memo[id(x)] = self.make(x.op, args)
+        return memo[id(x)]
+
+    def optimize(self, roots):
+        memo = {}
+        roots = [self.canonical(x, memo) for x in roots]
+        self.consumers = _consumers(roots)
+        memo = {}
+        roots = [self.push_transposes(x, memo) for x in roots]
+        self.consumers = _consumers(roots)
+        return roots
+
+    def value(self, x, out=None):
+        if not isinstance(x, Node):
+            # e.g. a of transpose(transpose(a))
+            return x if out is None else self.copy(x, out)
+        if id(x) in self.values:
+            return self.values[id(x)]
+
+        if x.op in ELEMENTWISE:
+            v = self.fused(x, out)
+        else:
+            # transposes of operands of multiply() are lazy expressions which are passed to GEMM
+            args = [self.value(y) for y in x.args]
+            f = getattr(_fn, x.op)
+            v = f(*args) if out is None else f(*args, out)
+
+        if out is None:
+            self.values[id(x)] = v
+        return v
+
+    def copy(self, x, out):
+        """Write matrix or vector x into out in a single pass, i.e. out = x*1, and return out"""
+        return _detail.elementwise_fused([x, 1], [('times', 0, 1)], out)
+
+    def operand(self, x):
+        """Value of x as an operand of an elementwise function, which requires transposes to be materialized"""
+        if not (isinstance(x, Node) and x.op == 'transpose'):
+            return self.value(x)
+        if id(x) not in self.materialized:
+            self.materialized[id(x)] = self.value(x).eval()
+        return self.materialized[id(x)]
+
+    def fusible(self, root):
+        """Ids of elementwise nodes which are evaluated together with root because all their consumers are"""
+        group, refs, stack = {id(root)}, collections.Counter(), [root]
+        while stack:
+            x = stack.pop()
+            for y in x.args:
+                if isinstance(y, Node) and y.op in ELEMENTWISE and id(y) not in self.values:
+                    refs[id(y)] += 1
+                    if refs[id(y)] == self.consumers[id(y)]:
+                        group.add(id(y))
+                        stack.append(y)
+        return group
+
+    def fused(self, root, out):
+        """Evaluate the elementwise functions at root as a single program, see detail.elementwise_fused()"""
+        group = self.fusible(root)
+        operands, slots, program, results = [], {}, [], {}
+
+        def emit(x):
+            if isinstance(x, Node) and id(x) in group:
+                if id(x) not in results:
+                    lhs = emit(x.args[0])
+                    rhs = emit(x.args[1])
+                    program.append((x.op, lhs, rhs))
+                    results[id(x)] = ('result', len(program) - 1)
+                return results[id(x)]
+
+            # each operand is passed once, hence it is redistributed at most once
+            key = self.key(x)
+            if key not in slots:
+                slots[key] = len(operands)
+                operands.append(self.operand(x))
+            return ('operand', slots[key])
+
+        emit(root)
+
+        def index(ref):
+            kind, i = ref
+            return i if kind == 'operand' else len(operands) + i
+
+        program = [(op, index(lhs), index(rhs)) for op, lhs, rhs in program]
+        return _detail.elementwise_fused(operands, program, out)
+
+
+def evaluate(*exprs, out=None):
+    """Optimize and evaluate expressions jointly, i.e. subexpressions shared between them are computed once.
+
+    Returns the value of a single expression or a tuple of values. If out is not None, then the value of a single
+    expression is written into out, even if it is optimized to one of its operands.
+    Other arguments which are not expression graph nodes are returned unchanged.
+    """
+    if out is not None and len(exprs) != 1:
+        raise ValueError('out requires a single expression')
+
+    evaluator = _Evaluator()
+    roots = evaluator.optimize(exprs)
+    values = tuple(evaluator.value(x, out) for x in roots)
+    return values[0] if len(values) == 1 else values
+
+
+def _materialize(x):
+    return evaluate(x) if isinstance(x, Node) else x
+
+
+def _deferrable(name, arity):
+    """Wrap function name of edamer.cpp.fn to return a node in lazy mode or if an operand is a node"""
+    def deferred(*args, out=None, **kwargs):
+        operands, rest = args[:arity], args[arity:]
+        if len(operands) == arity and not rest and not kwargs and \
+                (_lazy.get() or any(isinstance(x, Node) for x in operands)):
+            node = Node(name, operands)
+            return node if out is None else evaluate(node, out=out)
+
+        # e.g. multiply(a, b, out, alpha, beta)
+        args = [_materialize(x) for x in args] + ([] if out is None else [out])
+        return getattr(_fn, name)(*args, **{k: _materialize(v) for k, v in kwargs.items()})
+
+    return functools.update_wrapper(deferred, getattr(_fn, name))
+
+
+def _materializing(name):
+    """Wrap function name of edamer.cpp.fn to evaluate nodes which are passed to it"""
+    def materializing(*args, **kwargs):
+        args = [_materialize(x) for x in args]
+        return getattr(_fn, name)(*args, **{k: _materialize(v) for k, v in kwargs.items()})
+
+    return functools.update_wrapper(materializing, getattr(_fn, name))
+
+
+def wrap(name):
+    """Wrapper of function name of edamer.cpp.fn which accepts nodes, functions are looked up on each call because
+    registrations on first use of a ring may replace them"""
+    if name in ELEMENTWISE or name == 'multiply':
+        return _deferrable(name, 2)
+    elif name == 'transpose':
+        return _deferrable(name, 1)
+    return _materializing(name)
@@ -19,22 +19,171 @@
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 
 #include "../fwd.hpp" // Make help(edamer.fn.*) show Python type names
+#include <boost/container_hash/hash.hpp>
 #include <boost/hana/at.hpp>
 #include <boost/hana/concat.hpp>
-#include <boost/hana/cartesian_product.hpp>
 #include <boost/hana/first.hpp>
 #include <boost/hana/for_each.hpp>
+#include <boost/hana/transform.hpp>
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 #include <boost/hana/second.hpp>
+#include <boost/throw_exception.hpp>
+#include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
+#include <edamer/dt/el_abstract_dist_matrix.hpp>
 #include <edamer/dt/matrix_distribution.hpp>
+#include <edamer/fn/transpose.hpp> // Make help(edamer.fn.multiply) show Python type names
 #include <hbrs/mpl/dt/el_dist_matrix.hpp>
 #include <hbrs/mpl/dt/el_matrix.hpp>
+#include <hbrs/mpl/dt/exception.hpp>
+#include <hbrs/mpl/dt/expression.hpp>
 #include <hbrs/mpl/fn/multiply.hpp>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+/* Matrix and orientation which an operand is passed to GEMM with. Lazy transposes from fn.transpose() are not
+ * materialized, instead their operand is passed with TRANSPOSE orientation.
+ */
+template<typename Matrix>
+auto
+gemm_operand(Matrix const& a) {
+	return std::tuple<decltype(a.data()), El::Orientation>{a.data(), El::NORMAL};
+}
+
+template<typename Matrix>
+auto
+gemm_operand(el_transpose_expression<Matrix> const& a) {
+	auto const& operand = hana::at_c<0>(a.operands());
+	return std::tuple<decltype(operand.data()), El::Orientation>{operand.data(), El::TRANSPOSE};
+}
+
+/* Size of the product of two GEMM operands */
+template<typename Left, typename Right>
+std::pair<El::Int, El::Int>
+gemm_size(Left const& a, El::Orientation a_orientation, Right const& b, El::Orientation b_orientation) {
+	bool const a_normal = a_orientation == El::NORMAL;
+	bool const b_normal = b_orientation == El::NORMAL;
+	
+	if ((a_normal ? a.Width() : a.Height()) != (b_normal ? b.Height() : b.Width())) {
+		BOOST_THROW_EXCEPTION((hbrs::mpl::incompatible_matrix_exception{}
+			<< hbrs::mpl::errinfo_el_matrix_size{{b.Height(), b.Width()}}));
+	}
+	return { a_normal ? a.Height() : a.Width(), b_normal ? b.Width() : b.Height() };
+}
+
+template<typename Out>
+void
+check_gemm_out(std::pair<El::Int, El::Int> const& size, Out const& out) {
+	if (out.Height() != size.first || out.Width() != size.second) {
+		BOOST_THROW_EXCEPTION((hbrs::mpl::incompatible_matrix_exception{}
+			<< hbrs::mpl::errinfo_el_matrix_size{{out.Height(), out.Width()}}));
+	}
+}
+
+/* Product of non-distributed matrices of which at least one is read-only, e.g. a memory-mapped file, or a lazy
+ * transpose
+ */
+template<typename Ring, typename Left, typename Right>
+hbrs::mpl::el_matrix<Ring>
+multiply_el_matrix(Left const& a, Right const& b) {
+	auto [a_data, a_orientation] = gemm_operand(a);
+	auto [b_data, b_orientation] = gemm_operand(b);
+	gemm_size(a_data, a_orientation, b_data, b_orientation);
+	
+	El::Matrix<Ring> c;
+	El::Gemm(a_orientation, b_orientation, Ring(1), a_data, b_data, c);
+	return hbrs::mpl::el_matrix<Ring>{std::move(c)};
+}
+
+/* Compute out = alpha*a*b + beta*out in place, like numpy.matmul(a, b, out=out) but accumulating if beta is not zero */
+template<typename Ring, typename Left, typename Right>
+hbrs::mpl::el_matrix<Ring> &
+multiply_el_matrix_into(Left const& a, Right const& b, hbrs::mpl::el_matrix<Ring> & out, Ring alpha, Ring beta) {
+	auto [a_data, a_orientation] = gemm_operand(a);
+	auto [b_data, b_orientation] = gemm_operand(b);
+	check_gemm_out(gemm_size(a_data, a_orientation, b_data, b_orientation), out.data());
+	
+	El::Gemm(a_orientation, b_orientation, alpha, a_data, b_data, beta, out.data());
+	return out;
+}
+
+/* Product of distributed matrices of any matrix distributions or lazy transposes of them, which El::Gemm() selects at
+ * runtime. The product is distributed as [MC,MR], like the product computed by hbrs::mpl::multiply().
+ */
+template<typename Ring, typename Left, typename Right>
+El::DistMatrix<Ring>
+gemm_el_dist_matrix(Left const& a, Right const& b) {
+	auto [a_data, a_orientation] = gemm_operand(a);
+	auto [b_data, b_orientation] = gemm_operand(b);
+	gemm_size(a_data, a_orientation, b_data, b_orientation);
+	
+	El::DistMatrix<Ring> c{a_data.Grid()};
+	El::Gemm(a_orientation, b_orientation, Ring(1), a_data, b_data, c);
+	return c;
+}
+
+template<typename Ring, typename Left, typename Right>
+el_abstract_dist_matrix<Ring>
+multiply_el_abstract_dist_matrix(Left const& a, Right const& b) {
+	return el_abstract_dist_matrix<Ring>{std::make_shared<El::DistMatrix<Ring>>(gemm_el_dist_matrix<Ring>(a, b))};
+}
+
+/* Distributed variant of multiply_el_matrix_into(). Matrices of any distribution are supported, but if out is not
+ * distributed as [MC,MR] then Elemental redistributes it to and from a temporary matrix.
+ */
+template<typename Ring, typename Left, typename Right>
+el_abstract_dist_matrix<Ring> &
+multiply_el_abstract_dist_matrix_into(
+	Left const& a,
+	Right const& b,
+	el_abstract_dist_matrix<Ring> & out,
+	Ring alpha,
+	Ring beta
+) {
+	auto [a_data, a_orientation] = gemm_operand(a);
+	auto [b_data, b_orientation] = gemm_operand(b);
+	check_gemm_out(gemm_size(a_data, a_orientation, b_data, b_orientation), out.data());
+	
+	El::Gemm(a_orientation, b_orientation, alpha, a_data, b_data, beta, out.data());
+	return out;
+}
+
+/* View a typed distributed matrix as el_abstract_dist_matrix, like its abstract() method but without calling Python */
+template<typename Ring, typename Matrix>
+el_abstract_dist_matrix<Ring>
+abstract_view_of(py::handle a) {
+	Matrix const& matrix = a.cast<Matrix const&>();
+	auto view = std::make_shared<std::decay_t<decltype(matrix.data())>>(matrix.data().Grid());
+	El::LockedView(*view, matrix.data());
+	return el_abstract_dist_matrix<Ring>{view};
+}
+
+/* Product of typed distributed matrices of any matrix distributions, which is a typed matrix again. Both operands have
+ * been cast from Python objects already, hence the GIL is released for the product only.
+ */
+template<typename Ring>
+py::object
+multiply_el_dist_matrix(el_abstract_dist_matrix<Ring> const& a, el_abstract_dist_matrix<Ring> const& b) {
+	auto c = detail::without_gil([&a, &b]() { return gemm_el_dist_matrix<Ring>(a, b); });
+	return py::cast(hbrs::mpl::make_el_dist_matrix(std::move(c)));
+}
+
+/* View typed distributed matrices as el_abstract_dist_matrix, other arguments such as lazy transposes are kept */
+py::object
+abstract_view(py::object const& a) {
+	return py::hasattr(a, "abstract") ? a.attr("abstract")() : a;
+}
+EDAMER_NAMESPACE_END(/* unnamed */)
+
 py::module &
 pydef_impl<hbrs::mpl::detail::multiply_impl_el_matrix_el_matrix>::apply(py::module & m, py::module & base) {
 	auto ring_tns = hana::concat(detail::scalars, detail::complex_scalars);
@@ -45,13 +194,108 @@ pydef_impl<hbrs::mpl::detail::multiply_impl_el_matrix_el_matrix>::apply(py::modu
 		using ring_t = typename decltype(+hana::first(ring_tn))::type;
 		auto ring_n = hana::second(ring_tn);
 		
+		/* store template function pointers in variables to work around
+		 * "unresolved overloaded function type" errors with GCC9/10
+		 */
+		constexpr auto multiply_into_ptr = &multiply_el_matrix_into<ring_t, el_matrix<ring_t>, el_matrix<ring_t>>;
+		
 		m.def("multiply",
 			[](el_matrix<ring_t> const& a, el_matrix<ring_t> const& b) {
 				return hbrs::mpl::multiply(a, b);
 			},
 			py::arg("a"),
-			py::arg("b")
+			py::arg("b"),
+			py::call_guard<py::gil_scoped_release>()
+		);
+		
+		m.def("multiply",
+			multiply_into_ptr,
+			py::arg("a"),
+			py::arg("b"),
+			py::arg("out"),
+			py::arg("alpha") = ring_t(1),
+			py::arg("beta") = ring_t(0),
+			py::return_value_policy::reference,
+			py::call_guard<py::gil_scoped_release>(),
+			"Compute out = alpha*a*b + beta*out in place and return out"
 		);
+		
+		// Lazy transposes from fn.transpose() are passed to GEMM as orientation instead of being materialized
+		using transpose_t = el_transpose_expression<el_matrix<ring_t> const&>;
+		auto operand_tss = hana::make_tuple(
+			hana::make_tuple(hana::type_c<transpose_t>, hana::type_c<el_matrix<ring_t>>),
+			hana::make_tuple(hana::type_c<el_matrix<ring_t>>, hana::type_c<transpose_t>),
+			hana::make_tuple(hana::type_c<transpose_t>, hana::type_c<transpose_t>)
+		);
+		
+		hana::for_each(operand_tss, [&m](auto operand_ts) {
+			using left_t = typename decltype(+hana::at_c<0>(operand_ts))::type;
+			using right_t = typename decltype(+hana::at_c<1>(operand_ts))::type;
+			
+			/* store template function pointers in variables to work around
+			 * "unresolved overloaded function type" errors with GCC9/10
+			 */
+			constexpr auto multiply_ptr = &multiply_el_matrix<ring_t, left_t, right_t>;
+			constexpr auto multiply_into_ptr = &multiply_el_matrix_into<ring_t, left_t, right_t>;
+			
+			m.def("multiply",
+				multiply_ptr,
+				py::arg("a"),
+				py::arg("b"),
+				py::call_guard<py::gil_scoped_release>()
+			);
+			
+			m.def("multiply",
+				multiply_into_ptr,
+				py::arg("a"),
+				py::arg("b"),
+				py::arg("out"),
+				py::arg("alpha") = ring_t(1),
+				py::arg("beta") = ring_t(0),
+				py::return_value_policy::reference,
+				py::call_guard<py::gil_scoped_release>()
+			);
+		});
+	});
+	
+	// Read-only variants only exist for real scalar types
+	hana::for_each(detail::scalars, [&m](auto ring_tn) {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		
+		auto operand_tss = hana::make_tuple(
+			hana::make_tuple(hana::type_c<el_matrix<ring_t const>>, hana::type_c<el_matrix<ring_t const>>),
+			hana::make_tuple(hana::type_c<el_matrix<ring_t const>>, hana::type_c<el_matrix<ring_t>>),
+			hana::make_tuple(hana::type_c<el_matrix<ring_t>>, hana::type_c<el_matrix<ring_t const>>)
+		);
+		
+		hana::for_each(operand_tss, [&m](auto operand_ts) {
+			using left_t = typename decltype(+hana::at_c<0>(operand_ts))::type;
+			using right_t = typename decltype(+hana::at_c<1>(operand_ts))::type;
+			
+			/* store template function pointers in variables to work around
+			 * "unresolved overloaded function type" errors with GCC9/10
+			 */
+			constexpr auto multiply_ptr = &multiply_el_matrix<ring_t, left_t, right_t>;
+			constexpr auto multiply_into_ptr = &multiply_el_matrix_into<ring_t, left_t, right_t>;
+			
+			m.def("multiply",
+				multiply_ptr,
+				py::arg("a"),
+				py::arg("b"),
+				py::call_guard<py::gil_scoped_release>()
+			);
+			
+			m.def("multiply",
+				multiply_into_ptr,
+				py::arg("a"),
+				py::arg("b"),
+				py::arg("out"),
+				py::arg("alpha") = ring_t(1),
+				py::arg("beta") = ring_t(0),
+				py::return_value_policy::reference,
+				py::call_guard<py::gil_scoped_release>()
+			);
+		});
 	});
 	return m;
 }
@@ -62,41 +306,170 @@ pydef_impl<hbrs::mpl::detail::multiply_impl_el_dist_matrix_el_dist_matrix>::appl
 	
 	using hbrs::mpl::el_dist_matrix;
 	
-	hana::for_each(ring_tns, [&m](auto ring_tn) {
+	/* Registering one overload per ring and pair of distributions results in hundreds of overloads which pybind11 would
+	 * try one after another on each call. Instead, all combinations are stored in a map with the Python types of both
+	 * arguments as key, i.e. ring and distributions of both matrices, and a single overload dispatches to them. Entries
+	 * of a ring are added on first use of the ring, together with the classes they refer to. Code specialized for a
+	 * matrix distribution is limited to viewing an argument as el_abstract_dist_matrix, El::Gemm() redistributes both
+	 * operands at runtime, hence each ring instantiates the product once instead of once per pair of distributions.
+	 * Instances of Python subclasses are looked up by their nearest registered base classes in method resolution order.
+	 */
+	using multiply_fun_t = std::function<py::object(py::handle, py::handle)>;
+	using multiply_key_t = std::tuple<PyObject*, PyObject*>;
+	auto multiply_funs = std::make_shared<
+		std::unordered_map<multiply_key_t, multiply_fun_t, boost::hash<multiply_key_t>>>();
+	
+	detail::for_each_deferred(ring_tns, [multiply_funs](auto ring_tn) {
 		using ring_t = typename decltype(+hana::first(ring_tn))::type;
-		auto ring_n = hana::second(ring_tn);
+		using view_fun_t = el_abstract_dist_matrix<ring_t>(*)(py::handle);
+		
+		std::vector<std::pair<PyObject*, view_fun_t>> views;
+		hana::for_each(el_matrix_distributions, [&views](auto distribution_tn) {
+			auto dist_ts = hana::transform(distribution_tn, hana::first);
+			
+			using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
+			using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
+			using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
+			
+			using matrix_t = el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
+			
+			views.emplace_back(py::type::of<matrix_t>().ptr(), &abstract_view_of<ring_t, matrix_t>);
+		});
 		
-		hana::for_each(
-			hana::cartesian_product(hana::make_tuple(el_matrix_distributions, el_matrix_distributions)),
-			[&](auto product) {
-				auto left_distribution_tn = hana::at_c<0>(product);
-				auto right_distribution_tn = hana::at_c<1>(product);
-				
-				auto left_dist_ts = hana::transform(left_distribution_tn, hana::first);
-				auto right_dist_ts = hana::transform(right_distribution_tn, hana::first);
-				
-				using left_columnwise_t = std::decay_t<decltype(hana::at_c<0>(left_dist_ts))>;
-				using left_rowwise_t = std::decay_t<decltype(hana::at_c<1>(left_dist_ts))>;
-				using left_wrapping_t = std::decay_t<decltype(hana::at_c<2>(left_dist_ts))>;
-				
-				using right_columnwise_t = std::decay_t<decltype(hana::at_c<0>(right_dist_ts))>;
-				using right_rowwise_t = std::decay_t<decltype(hana::at_c<1>(right_dist_ts))>;
-				using right_wrapping_t = std::decay_t<decltype(hana::at_c<2>(right_dist_ts))>;
-				
-				m.def("multiply", [](
-					el_dist_matrix<ring_t, left_columnwise_t::value, left_rowwise_t::value, left_wrapping_t::value>
-						const& a,
-					el_dist_matrix<ring_t, right_columnwise_t::value, right_rowwise_t::value, right_wrapping_t::value>
-						const& b
-					) {
-						return hbrs::mpl::multiply(a, b);
-					},
-					py::arg("a"),
-					py::arg("b")
-				);
+		for (auto const& left : views) {
+			for (auto const& right : views) {
+				multiply_funs->emplace(
+					std::make_tuple(left.first, right.first),
+					[left_view = left.second, right_view = right.second](py::handle a, py::handle b) {
+						return multiply_el_dist_matrix<ring_t>(left_view(a), right_view(b));
+					});
 			}
+		}
+	});
+	
+	// Registered before the generic overload below, which would reject any argument missing in multiply_funs
+	hana::for_each(ring_tns, [&m](auto ring_tn) {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		
+		using matrix_t = el_abstract_dist_matrix<ring_t>;
+		using transpose_t = el_transpose_expression<matrix_t>;
+		
+		/* store template function pointers in variables to work around
+		 * "unresolved overloaded function type" errors with GCC9/10
+		 */
+		constexpr auto multiply_into_ptr = &multiply_el_abstract_dist_matrix_into<ring_t, matrix_t, matrix_t>;
+		
+		m.def("multiply",
+			multiply_into_ptr,
+			py::arg("a"),
+			py::arg("b"),
+			py::arg("out"),
+			py::arg("alpha") = ring_t(1),
+			py::arg("beta") = ring_t(0),
+			py::return_value_policy::reference,
+			py::call_guard<py::gil_scoped_release>(),
+			"Compute out = alpha*a*b + beta*out in place and return out"
+		);
+		
+		// Lazy transposes from fn.transpose() are passed to GEMM as orientation, which avoids a redistribution
+		auto operand_tss = hana::make_tuple(
+			hana::make_tuple(hana::type_c<transpose_t>, hana::type_c<matrix_t>),
+			hana::make_tuple(hana::type_c<matrix_t>, hana::type_c<transpose_t>),
+			hana::make_tuple(hana::type_c<transpose_t>, hana::type_c<transpose_t>)
+		);
+		
+		hana::for_each(operand_tss, [&m](auto operand_ts) {
+			using left_t = typename decltype(+hana::at_c<0>(operand_ts))::type;
+			using right_t = typename decltype(+hana::at_c<1>(operand_ts))::type;
+			
+			constexpr auto multiply_ptr = &multiply_el_abstract_dist_matrix<ring_t, left_t, right_t>;
+			constexpr auto multiply_into_ptr = &multiply_el_abstract_dist_matrix_into<ring_t, left_t, right_t>;
+			
+			m.def("multiply",
+				multiply_ptr,
+				py::arg("a"),
+				py::arg("b"),
+				py::call_guard<py::gil_scoped_release>()
+			);
+			
+			m.def("multiply",
+				multiply_into_ptr,
+				py::arg("a"),
+				py::arg("b"),
+				py::arg("out"),
+				py::arg("alpha") = ring_t(1),
+				py::arg("beta") = ring_t(0),
+				py::return_value_policy::reference,
+				py::call_guard<py::gil_scoped_release>()
+			);
+		});
+		
+		constexpr auto multiply_ptr = &multiply_el_abstract_dist_matrix<ring_t, matrix_t, matrix_t>;
+		
+		m.def("multiply",
+			multiply_ptr,
+			py::arg("a"),
+			py::arg("b"),
+			py::call_guard<py::gil_scoped_release>()
 		);
 	});
+	
+	// m is captured as borrowed handle, because a reference from a function of m to m would never be released
+	m.def("multiply",
+		[multiply_funs, m = py::handle{m}](py::object const& a, py::object const& b) {
+			auto mro = [](py::handle x) { return py::reinterpret_borrow<py::tuple>(Py_TYPE(x.ptr())->tp_mro); };
+			
+			// the types themselves come first in their method resolution orders
+			auto it = [&]() {
+				for (py::handle a_type : mro(a)) {
+					for (py::handle b_type : mro(b)) {
+						auto it = multiply_funs->find(std::make_tuple(a_type.ptr(), b_type.ptr()));
+						if (it != multiply_funs->end()) {
+							return it;
+						}
+					}
+				}
+				return multiply_funs->end();
+			}();
+			
+			if (it == multiply_funs->end() && detail::has_el_abstract_dist_matrix_view({a, b})) {
+				// e.g. typed matrices and lazy transposes, which are multiplied as views with runtime distributions
+				return m.attr("multiply")(abstract_view(a), abstract_view(b)).attr("typed")();
+			}
+			
+			if (it == multiply_funs->end()) {
+				throw py::type_error{"multiply(): incompatible function arguments: "
+					+ py::str(py::type::handle_of(a)).cast<std::string>() + ", "
+					+ py::str(py::type::handle_of(b)).cast<std::string>()};
+			}
+			
+			return it->second(a, b);
+		},
+		py::arg("a"),
+		py::arg("b"),
+		"Multiply two el_dist_matrix instances of the same ring and any distributions"
+	);
+	
+	m.def("multiply",
+		[m = py::handle{m}](
+			py::object const& a, py::object const& b, py::object const& out, py::object alpha, py::object beta
+		) {
+			if (!detail::has_el_abstract_dist_matrix_view({a, b, out})) {
+				throw py::type_error{"multiply(): incompatible function arguments"};
+			}
+			
+			m.attr("multiply")(
+				abstract_view(a), abstract_view(b), detail::as_el_abstract_dist_matrix(out), alpha, beta);
+			return out;
+		},
+		py::arg("a"),
+		py::arg("b"),
+		py::arg("out"),
+		py::arg("alpha") = 1,
+		py::arg("beta") = 0,
+		"Compute out = alpha*a*b + beta*out in place for el_dist_matrix instances of the same ring and any "
+		"distributions and return out"
+	);
 	return m;
 }
 
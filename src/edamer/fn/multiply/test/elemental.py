@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+from edamer import detail, dt, fn
+from mpi4py import MPI
+import numpy as np
+import pytest
+
+
+@pytest.fixture
+def env():
+    class Environment():
+        comm = MPI.COMM_WORLD
+        size = comm.Get_size()
+        rank = comm.Get_rank()
+        grid = dt.ElGrid(comm)
+    return Environment()
+
+
+def test_fn_multiply_out(env):
+    rng = np.random.default_rng(0)
+    a_np = np.asarray(rng.standard_normal((30, 10)), order='F')
+    b_np = np.asarray(rng.standard_normal((10, 20)), order='F')
+    c_np = np.asarray(rng.standard_normal((30, 20)), order='F')
+
+    out_np = c_np.copy(order='F')
+    out_el = dt.ElMatrix.view_from_numpy(out_np)
+    result = fn.multiply(dt.ElMatrix.view_from_numpy(a_np), dt.ElMatrix.view_from_numpy(b_np), out=out_el)
+    assert result is out_el
+    assert np.allclose(out_np, a_np @ b_np)
+
+    # accumulate in place
+    out_np[:] = c_np
+    fn.multiply(dt.ElMatrix.view_from_numpy(a_np), dt.ElMatrix.view_from_numpy(b_np), out=out_el, alpha=2.0, beta=0.5)
+    assert np.allclose(out_np, 2*a_np @ b_np + 0.5*c_np)
+
+    with pytest.raises(dt.IncompatibleMatrixException):
+        fn.multiply(dt.ElMatrix.view_from_numpy(a_np), dt.ElMatrix.view_from_numpy(b_np),
+                    out=dt.ElMatrix.view_from_numpy(np.zeros((20, 30), order='F')))
+
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+    dist_vc_star_el = dt.MatrixDistribution.make(dt.ElDist.VC, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    a_dist = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(a_np), dist_star_star_el)
+    b_dist = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(b_np), dist_star_star_el)
+    c_dist = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(c_np), dist_star_star_el)
+
+    for dist in [dist_mc_mr_el, dist_vc_star_el]:
+        out_dist = c_dist.copy(dist)
+        assert fn.multiply(a_dist.copy(dist_mc_mr_el), b_dist, out=out_dist, alpha=2.0, beta=0.5) is out_dist
+        assert np.allclose(detail.test.to_numpy_2d(out_dist), 2*a_np @ b_np + 0.5*c_np)
+
+    out_abstract = c_dist.copy(dist_mc_mr_el).abstract()
+    assert fn.multiply(a_dist.abstract(), b_dist.abstract(), out=out_abstract) is out_abstract
+    assert np.allclose(detail.test.to_numpy_2d(out_abstract.typed()), a_np @ b_np)
+
+
+def test_fn_multiply_subclass(env):
+    rng = np.random.default_rng(0)
+    a_np = np.asarray(rng.standard_normal((30, 10)), order='F')
+    b_np = np.asarray(rng.standard_normal((10, 20)), order='F')
+
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+    a_dist = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(a_np), dist_star_star_el)
+    b_dist = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(b_np), dist_star_star_el)
+
+    # instances of Python subclasses are multiplied like instances of their base classes
+    class Subclass(type(a_dist)):
+        pass
+
+    a_sub = Subclass(env.grid, 30, 10)
+    a_sub.local().view_to_numpy()[:] = a_np
+    c = fn.multiply(a_sub, b_dist.copy(dist_mc_mr_el))
+    assert isinstance(c, dt.ElDistMatrix)
+    assert np.allclose(detail.test.to_numpy_2d(c), a_np @ b_np)
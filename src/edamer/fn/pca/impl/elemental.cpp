@@ -19,6 +19,8 @@
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 
 #include "../fwd.hpp" // Make help(edamer.fn.*) show Python type names
+#include <algorithm>
+#include <boost/assert.hpp>
 #include <boost/hana/at.hpp>
 #include <boost/hana/concat.hpp>
 #include <boost/hana/first.hpp>
@@ -26,14 +28,35 @@
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 #include <boost/hana/second.hpp>
+#include <boost/throw_exception.hpp>
+#include <cmath>
+#include <cstdint>
+#include <edamer/detail/elemental.hpp>
+#include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
+#include <edamer/dt/exception.hpp>
 #include <edamer/dt/matrix_distribution.hpp>
+#include <edamer/dt/pca_control.hpp>
+#include <edamer/dt/pca_result.hpp>
+#include <functional>
 #include <hbrs/mpl/dt/el_dist_matrix.hpp>
+#include <hbrs/mpl/dt/el_dist_vector.hpp>
 #include <hbrs/mpl/dt/el_matrix.hpp>
+#include <hbrs/mpl/dt/el_vector.hpp>
+#include <hbrs/mpl/dt/exception.hpp>
 #include <hbrs/mpl/dt/pca_control.hpp>
+#include <hbrs/mpl/dt/pca_result.hpp>
 #include <hbrs/mpl/fn/pca.hpp>
+#include <optional>
+#include <pybind11/stl.h>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace hana = boost::hana;
+namespace mpl = hbrs::mpl;
 
 EDAMER_NAMESPACE_BEGIN(/* unnamed */)
 auto scalars = hana::drop_back(hana::make_tuple(
@@ -48,6 +71,1309 @@ auto scalars = hana::drop_back(hana::make_tuple(
 	"SEQUENCE_TERMINATOR___REMOVED_BY_DROP_BACK"
 ));
 
+/* Wrap Elemental matrices into the same types which hbrs::mpl's pca returns for a, but with scalar type Result, so that
+ * all PCA algorithms are interchangeable in Python. The arguments are copied and converted to Result, hence views are
+ * allowed.
+ */
+template<typename Result, typename T, typename Ring>
+auto
+wrap_matrix(mpl::el_matrix<T> const&, El::Matrix<Ring> const& b) {
+	El::Matrix<Result> c;
+	El::Copy(b, c);
+	return mpl::el_matrix<Result>{std::move(c)};
+}
+
+template<typename Result, typename T, typename Ring>
+auto
+wrap_column_vector(mpl::el_matrix<T> const&, El::Matrix<Ring> const& b) {
+	El::Matrix<Result> c;
+	El::Copy(b, c);
+	return mpl::el_column_vector<Result>{std::move(c)};
+}
+
+template<typename Result, typename T, typename Ring>
+auto
+wrap_row_vector(mpl::el_matrix<T> const&, El::Matrix<Ring> const& b) {
+	El::Matrix<Result> c;
+	El::Copy(b, c);
+	return mpl::el_row_vector<Result>{std::move(c)};
+}
+
+template<
+	typename Result,
+	typename T,
+	El::Dist Columnwise,
+	El::Dist Rowwise,
+	El::DistWrap Wrapping,
+	typename Ring
+>
+auto
+wrap_matrix(
+	mpl::el_dist_matrix<T, Columnwise, Rowwise, Wrapping> const&,
+	El::AbstractDistMatrix<Ring> const& b
+) {
+	El::DistMatrix<Result, Columnwise, Rowwise, Wrapping> c{b.Grid()};
+	El::Copy(b, c);
+	return mpl::make_el_dist_matrix(std::move(c));
+}
+
+template<
+	typename Result,
+	typename T,
+	El::Dist Columnwise,
+	El::Dist Rowwise,
+	El::DistWrap Wrapping,
+	typename Ring
+>
+auto
+wrap_column_vector(
+	mpl::el_dist_matrix<T, Columnwise, Rowwise, Wrapping> const&,
+	El::AbstractDistMatrix<Ring> const& b
+) {
+	El::DistMatrix<Result, El::MD, El::STAR, Wrapping> c{b.Grid()};
+	El::Copy(b, c);
+	return mpl::make_el_dist_column_vector(std::move(c));
+}
+
+template<
+	typename Result,
+	typename T,
+	El::Dist Columnwise,
+	El::Dist Rowwise,
+	El::DistWrap Wrapping,
+	typename Ring
+>
+auto
+wrap_row_vector(
+	mpl::el_dist_matrix<T, Columnwise, Rowwise, Wrapping> const&,
+	El::AbstractDistMatrix<Ring> const& b
+) {
+	El::DistMatrix<Result, El::STAR, El::VC, Wrapping> c{b.Grid()};
+	El::Copy(b, c);
+	return mpl::make_el_dist_row_vector(std::move(c));
+}
+
+template<typename Result, typename Matrix, typename Coeff, typename Score, typename Latent, typename Mean>
+auto
+make_pca_result(Matrix const& a, Coeff const& coeff, Score const& score, Latent const& latent, Mean const& mean) {
+	return mpl::pca_result<
+		decltype(wrap_matrix<Result>(a, coeff)),
+		decltype(wrap_matrix<Result>(a, score)),
+		decltype(wrap_column_vector<Result>(a, latent)),
+		decltype(wrap_row_vector<Result>(a, mean))
+	>{
+		wrap_matrix<Result>(a, coeff),
+		wrap_matrix<Result>(a, score),
+		wrap_column_vector<Result>(a, latent),
+		wrap_row_vector<Result>(a, mean)
+	};
+}
+
+/* Like make_pca_result(), but score is either given or computed by make_score on first access, or never if both are
+ * empty. scale holds the standard deviations of the columns of a as a column vector if a has been normalized.
+ */
+template<typename Result, typename Matrix, typename Coeff, typename Workspace, typename Latent, typename Mean>
+auto
+make_lazy_pca_result(
+	Matrix const& a,
+	Coeff const& coeff,
+	std::optional<Workspace> const& score,
+	std::function<Workspace()> make_score,
+	Latent const& latent,
+	Mean const& mean,
+	std::optional<Workspace> const& scale
+) {
+	using score_t = decltype(wrap_matrix<Result>(a, coeff));
+	using mean_t = decltype(wrap_row_vector<Result>(a, mean));
+	
+	std::optional<score_t> wrapped_score;
+	if (score) {
+		wrapped_score.emplace(wrap_matrix<Result>(a, *score));
+	}
+	
+	std::function<score_t()> make_wrapped_score;
+	if (make_score) {
+		make_wrapped_score = [a_ptr = &a, make_score]() { return wrap_matrix<Result>(*a_ptr, make_score()); };
+	}
+	
+	std::optional<mean_t> wrapped_scale;
+	if (scale) {
+		auto scale_row = detail::make_el_workspace<detail::el_ring_t<Workspace>>(*scale);
+		El::Transpose(*scale, scale_row);
+		wrapped_scale.emplace(wrap_row_vector<Result>(a, scale_row));
+	}
+	
+	return lazy_pca_result<
+		decltype(wrap_matrix<Result>(a, coeff)),
+		score_t,
+		decltype(wrap_column_vector<Result>(a, latent)),
+		mean_t
+	>{
+		wrap_matrix<Result>(a, coeff),
+		std::move(wrapped_score),
+		std::move(make_wrapped_score),
+		wrap_column_vector<Result>(a, latent),
+		wrap_row_vector<Result>(a, mean),
+		std::move(wrapped_scale)
+	};
+}
+
+/* Number of principal components to compute for a mxn matrix, where num_components == 0 means all components */
+El::Int
+pca_rank(El::Int m, El::Int n, pca_extended_control const& ctrl) {
+	El::Int const max_rank = std::min(m, n);
+	return ctrl.num_components() == 0
+		? max_rank
+		: std::min(max_rank, static_cast<El::Int>(ctrl.num_components()));
+}
+
+/* Workspace for the preprocessed copy of a. If products with it are accumulated in another precision than its scalar
+ * type Ring, distributed copies have [VC,STAR] distribution, so that each process converts and multiplies blocks of
+ * its local rows and partial results are merged with a single allreduce instead of a distributed product per block.
+ */
+template<typename Accum, typename Ring, typename Matrix>
+auto
+make_preprocess_workspace(Matrix const& a) {
+	if constexpr (!std::is_same_v<Accum, Ring> && std::is_base_of_v<El::AbstractDistMatrix<Ring>, Matrix>) {
+		return El::DistMatrix<Ring, El::VC, El::STAR>{a.Grid()};
+	} else {
+		return detail::make_el_workspace<Ring>(a);
+	}
+}
+
+/* Copy a into a workspace, see make_preprocess_workspace(), center and normalize its columns according to ctrl and
+ * return the workspace, the column means as a row vector and the standard deviations as a column vector, both in
+ * precision Accum. Like hbrs::mpl's pca, the means are zeros if center is false. The standard deviations are ones if
+ * normalize is false. The workspace keeps the scalar type of a.
+ */
+template<typename Accum, typename Matrix>
+auto
+preprocess(Matrix const& a, pca_extended_control const& ctrl) {
+	using ring_t = detail::el_ring_t<Matrix>;
+	
+	auto x = make_preprocess_workspace<Accum, ring_t>(a);
+	El::Copy(a, x);
+	
+	auto mean = detail::make_el_workspace<Accum>(a);
+	El::Zeros(mean, 1, a.Width());
+	auto stddevs = detail::make_el_workspace<Accum>(a);
+	El::Ones(stddevs, a.Width(), 1);
+	
+	if (ctrl.center() || ctrl.normalize()) {
+		// means and standard deviations of all columns in a single pass
+		auto moments = detail::moments_along(x, 1);
+		
+		if (ctrl.center()) {
+			auto means = detail::make_el_workspace<ring_t>(a);
+			El::Zeros(means, a.Width(), 1);
+			detail::assign_moments(means, moments, [](detail::welford_moments const& o) { return o.mean; });
+			detail::center_columns(x, means);
+			detail::assign_moments(mean, moments, [](detail::welford_moments const& o) { return o.mean; });
+		}
+		
+		if (ctrl.normalize()) {
+			detail::assign_moments(stddevs, moments,
+				[](detail::welford_moments const& o) { return std::sqrt(o.variance(0)); });
+			auto divisors = detail::make_el_workspace<ring_t>(a);
+			El::Copy(stddevs, divisors);
+			El::DiagonalSolve(El::RIGHT, El::NORMAL, divisors, x);
+		}
+	}
+	
+	return std::make_tuple(std::move(x), std::move(mean), std::move(stddevs));
+}
+
+/* Rows of x which are converted to the accumulation precision at once. A converted block of a mxn matrix takes at most
+ * as much memory as a nxn Gram matrix or Elemental's algorithmic block size.
+ */
+El::Int
+conversion_blocksize(El::Int n) {
+	return std::max<El::Int>(n, El::Blocksize());
+}
+
+/* c := x*b in precision Accum, where x is converted block by block of rows if it has another scalar type */
+template<typename Accum, typename Workspace, typename Matrix>
+void
+multiply_accumulated(Workspace const& x, Matrix const& b, Matrix & c) {
+	if constexpr (std::is_same_v<detail::el_ring_t<Workspace>, Accum>) {
+		El::Gemm(El::NORMAL, El::NORMAL, Accum(1), x, b, c);
+	} else {
+		El::Int const m = x.Height();
+		El::Int const bs = conversion_blocksize(x.Width());
+		El::Zeros(c, m, b.Width());
+		
+		auto block = detail::make_el_workspace<Accum>(x);
+		for (El::Int i = 0; i < m; i += bs) {
+			El::IR const rows(i, std::min(i + bs, m));
+			El::Copy(x(rows, El::ALL), block);
+			auto c_rows = c(rows, El::ALL);
+			El::Gemm(El::NORMAL, El::NORMAL, Accum(1), block, b, Accum(0), c_rows);
+		}
+	}
+}
+
+/* Like above for distributed x with [VC,STAR] distribution, see make_preprocess_workspace(). The small nxl matrix b is
+ * replicated, each process multiplies its local rows and c is redistributed once.
+ */
+template<typename Accum, typename Ring>
+void
+multiply_accumulated(
+	El::DistMatrix<Ring, El::VC, El::STAR> const& x,
+	El::DistMatrix<Accum> const& b,
+	El::DistMatrix<Accum> & c
+) {
+	El::DistMatrix<Accum, El::STAR, El::STAR> b_all{b};
+	El::DistMatrix<Accum, El::VC, El::STAR> c_rows{x.Grid()};
+	c_rows.AlignWith(x.DistData());
+	El::Zeros(c_rows, x.Height(), b.Width());
+	
+	El::Int const m = x.LocalHeight();
+	El::Int const bs = conversion_blocksize(x.Width());
+	El::Matrix<Accum> block;
+	for (El::Int i = 0; i < m; i += bs) {
+		El::IR const rows(i, std::min(i + bs, m));
+		El::Copy(x.LockedMatrix()(rows, El::ALL), block);
+		auto c_block = c_rows.Matrix()(rows, El::ALL);
+		El::Gemm(El::NORMAL, El::NORMAL, Accum(1), block, b_all.LockedMatrix(), Accum(0), c_block);
+	}
+	
+	El::Copy(c_rows, c);
+}
+
+/* c := x'*b in precision Accum, where x is converted block by block of rows if it has another scalar type */
+template<typename Accum, typename Workspace, typename Matrix>
+void
+multiply_transposed_accumulated(Workspace const& x, Matrix const& b, Matrix & c) {
+	if constexpr (std::is_same_v<detail::el_ring_t<Workspace>, Accum>) {
+		El::Gemm(El::TRANSPOSE, El::NORMAL, Accum(1), x, b, c);
+	} else {
+		El::Int const m = x.Height();
+		El::Int const bs = conversion_blocksize(x.Width());
+		El::Zeros(c, x.Width(), b.Width());
+		
+		auto block = detail::make_el_workspace<Accum>(x);
+		for (El::Int i = 0; i < m; i += bs) {
+			El::IR const rows(i, std::min(i + bs, m));
+			El::Copy(x(rows, El::ALL), block);
+			El::Gemm(El::TRANSPOSE, El::NORMAL, Accum(1), block, b(rows, El::ALL), Accum(1), c);
+		}
+	}
+}
+
+/* Sum of the local nxl matrices of all processes of the [VC,STAR] matrix x as a [MC,MR] matrix c */
+template<typename Accum, typename Ring>
+void
+allreduce_local(El::DistMatrix<Ring, El::VC, El::STAR> const& x, El::Matrix<Accum> & local, El::DistMatrix<Accum> & c) {
+	El::AllReduce(local, x.ColComm());
+	
+	El::DistMatrix<Accum, El::STAR, El::STAR> all{x.Grid()};
+	all.Resize(local.Height(), local.Width());
+	El::Copy(local, all.Matrix());
+	El::Copy(all, c);
+}
+
+/* Like above for distributed x with [VC,STAR] distribution, see make_preprocess_workspace(). b is redistributed like x
+ * once, each process multiplies its local rows and the partial products are merged with a single allreduce.
+ */
+template<typename Accum, typename Ring>
+void
+multiply_transposed_accumulated(
+	El::DistMatrix<Ring, El::VC, El::STAR> const& x,
+	El::DistMatrix<Accum> const& b,
+	El::DistMatrix<Accum> & c
+) {
+	El::DistMatrix<Accum, El::VC, El::STAR> b_rows{x.Grid()};
+	b_rows.AlignWith(x.DistData());
+	El::Copy(b, b_rows);
+	
+	El::Matrix<Accum> local;
+	El::Zeros(local, x.Width(), b.Width());
+	
+	El::Int const m = x.LocalHeight();
+	El::Int const bs = conversion_blocksize(x.Width());
+	El::Matrix<Accum> block;
+	for (El::Int i = 0; i < m; i += bs) {
+		El::IR const rows(i, std::min(i + bs, m));
+		El::Copy(x.LockedMatrix()(rows, El::ALL), block);
+		El::Gemm(El::TRANSPOSE, El::NORMAL, Accum(1), block, b_rows.LockedMatrix()(rows, El::ALL), Accum(1), local);
+	}
+	
+	allreduce_local(x, local, c);
+}
+
+/* Lower triangle of the Gram matrix x'*x in precision Accum, where x is converted block by block of rows if it has
+ * another scalar type
+ */
+template<typename Accum, typename Workspace>
+auto
+gram_accumulated(Workspace const& x) {
+	El::Int const m = x.Height();
+	El::Int const n = x.Width();
+	
+	auto gram = detail::make_el_workspace<Accum>(x);
+	El::Zeros(gram, n, n);
+	
+	if constexpr (std::is_same_v<detail::el_ring_t<Workspace>, Accum>) {
+		El::Syrk(El::LOWER, El::TRANSPOSE, Accum(1), x, Accum(0), gram);
+	} else {
+		El::Int const bs = conversion_blocksize(n);
+		auto block = detail::make_el_workspace<Accum>(x);
+		for (El::Int i = 0; i < m; i += bs) {
+			El::Copy(x(El::IR(i, std::min(i + bs, m)), El::ALL), block);
+			El::Syrk(El::LOWER, El::TRANSPOSE, Accum(1), block, Accum(1), gram);
+		}
+	}
+	return gram;
+}
+
+/* Like above for distributed x with [VC,STAR] distribution, see make_preprocess_workspace(). Each process adds its
+ * local rows to a local Gram matrix and the local Gram matrices are merged with a single allreduce.
+ */
+template<typename Accum, typename Ring>
+auto
+gram_accumulated(El::DistMatrix<Ring, El::VC, El::STAR> const& x) {
+	El::Int const n = x.Width();
+	
+	El::Matrix<Accum> local;
+	El::Zeros(local, n, n);
+	
+	El::Int const m = x.LocalHeight();
+	El::Int const bs = conversion_blocksize(n);
+	El::Matrix<Accum> block;
+	for (El::Int i = 0; i < m; i += bs) {
+		El::Copy(x.LockedMatrix()(El::IR(i, std::min(i + bs, m)), El::ALL), block);
+		El::Syrk(El::LOWER, El::TRANSPOSE, Accum(1), block, Accum(1), local);
+	}
+	
+	El::DistMatrix<Accum> gram{x.Grid()};
+	allreduce_local(x, local, gram);
+	return gram;
+}
+
+/* Principal components coeff and variances latent of the preprocessed mxn matrix x by a thin SVD x = u*diag(s)*v' of
+ * which u is not computed. x is overwritten. All singular values and vectors are computed, because Elemental has no
+ * truncated SVD, and the result is trimmed to the leading num_components afterwards.
+ */
+template<typename Workspace>
+auto
+svd_pca_factors(Workspace & x, pca_extended_control const& ctrl) {
+	using ring_t = detail::el_ring_t<Workspace>;
+	
+	El::Int const m = x.Height();
+	El::Int const k = pca_rank(m, x.Width(), ctrl);
+	
+	auto u = detail::make_el_workspace<ring_t>(x);
+	auto s = detail::make_el_workspace<ring_t>(x);
+	auto v = detail::make_el_workspace<ring_t>(x);
+	
+	El::SVDCtrl<ring_t> svd_ctrl;
+	svd_ctrl.bidiagSVDCtrl.approach = El::THIN_SVD;
+	svd_ctrl.bidiagSVDCtrl.wantU = false;
+	El::SVD(x, u, s, v, svd_ctrl);
+	
+	auto coeff = detail::make_el_workspace<ring_t>(x);
+	El::Copy(v(El::ALL, El::IR(0, k)), coeff);
+	
+	auto latent = detail::make_el_workspace<ring_t>(x);
+	El::Copy(s(El::IR(0, k), El::ALL), latent);
+	detail::singular_values_to_variances(latent, m);
+	
+	return std::make_pair(std::move(coeff), std::move(latent));
+}
+
+/* Fill a with standard normal entries drawn from a generator with the given seed. Complex entries have standard
+ * normal real and imaginary parts.
+ */
+template<typename Ring>
+void
+seeded_gaussian(El::Matrix<Ring> & a, std::uint64_t seed) {
+	std::mt19937_64 engine{seed};
+	std::normal_distribution<El::Base<Ring>> normal;
+	for (El::Int j = 0; j < a.Width(); ++j) {
+		for (El::Int i = 0; i < a.Height(); ++i) {
+			if constexpr (El::IsComplex<Ring>::value) {
+				El::Base<Ring> const re = normal(engine);
+				a.Set(i, j, Ring(re, normal(engine)));
+			} else {
+				a.Set(i, j, normal(engine));
+			}
+		}
+	}
+}
+
+/* Standard normal nxl matrix which is equal on all processes and in all runs with the same seed. Each process draws
+ * all entries of a [STAR,STAR] matrix, which matches drawing them on a single process and broadcasting them without
+ * any communication, and keeps its local entries. Elemental's El::Gaussian() draws from per-process generators instead,
+ * whose seeds differ between runs.
+ */
+template<typename Ring>
+void
+seeded_gaussian(El::Matrix<Ring> & a, El::Int n, El::Int l, std::uint64_t seed) {
+	a.Resize(n, l);
+	seeded_gaussian(a, seed);
+}
+
+template<typename Ring>
+void
+seeded_gaussian(El::DistMatrix<Ring> & a, El::Int n, El::Int l, std::uint64_t seed) {
+	El::DistMatrix<Ring, El::STAR, El::STAR> b{a.Grid()};
+	b.Resize(n, l);
+	seeded_gaussian(b.Matrix(), seed);
+	El::Copy(b, a);
+}
+
+/* Randomized PCA which approximates the leading k principal components of the preprocessed mxn matrix x using a
+ * randomized range finder followed by a SVD of a small (k+oversampling)xn matrix. Instead of O(mn*min(m,n)), it costs
+ * O(mnk) flops and needs O(mk+nk) additional memory. Subspace (power) iterations improve the accuracy for slowly
+ * decaying spectra. All products with x are accumulated in precision Accum.
+ *
+ * Ref.: N. Halko, P. G. Martinsson, J. A. Tropp. Finding Structure with Randomness: Probabilistic Algorithms for
+ *       Constructing Approximate Matrix Decompositions. SIAM Review, 53(2), 2011. Algorithms 4.4 and 5.1.
+ */
+template<typename Accum, typename Workspace>
+auto
+randomized_pca_factors(Workspace const& x, pca_extended_control const& ctrl) {
+	El::Int const m = x.Height();
+	El::Int const n = x.Width();
+	El::Int const k = pca_rank(m, n, ctrl);
+	El::Int const l = std::min(std::min(m, n), k + static_cast<El::Int>(ctrl.oversampling()));
+	
+	auto omega = detail::make_el_workspace<Accum>(x);
+	seeded_gaussian(omega, n, l, ctrl.seed());
+	
+	// range finder, i.e. orthonormal basis q of range(x*omega)
+	auto q = detail::make_el_workspace<Accum>(x);
+	multiply_accumulated<Accum>(x, omega, q);
+	
+	auto z = detail::make_el_workspace<Accum>(x);
+	for (std::size_t i = 0; i < ctrl.power_iterations(); ++i) {
+		El::qr::ExplicitUnitary(q);
+		multiply_transposed_accumulated<Accum>(x, q, z);
+		El::qr::ExplicitUnitary(z);
+		multiply_accumulated<Accum>(x, z, q);
+	}
+	El::qr::ExplicitUnitary(q);
+	
+	// small SVD of b = q'*x = u*diag(s)*v'
+	multiply_transposed_accumulated<Accum>(x, q, z);
+	auto b = detail::make_el_workspace<Accum>(x);
+	El::Transpose(z, b);
+	
+	auto u = detail::make_el_workspace<Accum>(x);
+	auto s = detail::make_el_workspace<Accum>(x);
+	auto v = detail::make_el_workspace<Accum>(x);
+	
+	El::SVDCtrl<Accum> svd_ctrl;
+	svd_ctrl.bidiagSVDCtrl.approach = El::THIN_SVD;
+	svd_ctrl.bidiagSVDCtrl.wantU = false;
+	El::SVD(b, u, s, v, svd_ctrl);
+	
+	auto coeff = detail::make_el_workspace<Accum>(x);
+	El::Copy(v(El::ALL, El::IR(0, k)), coeff);
+	
+	auto latent = detail::make_el_workspace<Accum>(x);
+	El::Copy(s(El::IR(0, k), El::ALL), latent);
+	detail::singular_values_to_variances(latent, m);
+	
+	return std::make_pair(std::move(coeff), std::move(latent));
+}
+
+/* Principal components coeff and variances latent from the lower triangle of the nxn Gram matrix of a preprocessed mxn
+ * matrix, which is overwritten
+ */
+template<typename Accum, typename Gram>
+auto
+gram_eig_factors(Gram && gram, El::Int m, pca_extended_control const& ctrl) {
+	El::Int const n = gram.Width();
+	El::Int const k = std::min(n, pca_rank(m, n, ctrl));
+	
+	auto w = detail::make_el_workspace<Accum>(gram);
+	auto v = detail::make_el_workspace<Accum>(gram);
+	
+	El::HermitianEigCtrl<Accum> eig_ctrl;
+	eig_ctrl.tridiagEigCtrl.sort = El::DESCENDING;
+	El::HermitianEig(El::LOWER, gram, w, v, eig_ctrl);
+	
+	auto coeff = detail::make_el_workspace<Accum>(gram);
+	El::Copy(v(El::ALL, El::IR(0, k)), coeff);
+	
+	auto latent = detail::make_el_workspace<Accum>(gram);
+	El::Copy(w(El::IR(0, k), El::ALL), latent);
+	Accum const dof = Accum(std::max<El::Int>(m - 1, 1));
+	// eigenvalues of a positive semidefinite matrix might be slightly negative due to rounding errors
+	El::EntrywiseMap(latent, std::function<Accum(Accum const&)>(
+		[dof](Accum const& e) { return std::max(e, Accum(0)) / dof; }));
+	
+	return std::make_pair(std::move(coeff), std::move(latent));
+}
+
+/* PCA by the method of snapshots, i.e. the eigendecomposition x'*x = v*diag(w)*v' of the small nxn Gram matrix of
+ * the preprocessed mxn matrix x. Forming the Gram matrix with a symmetric rank-k update costs O(mn^2) flops and the
+ * eigendecomposition O(n^3), whereas the SVD of x needs several passes over all mn entries. The principal component
+ * variances are w/(m-1). The Gram matrix is accumulated in precision Accum, which matters most here because forming
+ * x'*x squares the condition number.
+ *
+ * Ref.: L. Sirovich. Turbulence and the Dynamics of Coherent Structures. Part I: Coherent Structures. Quarterly of
+ *       Applied Mathematics, 45(3), 1987.
+ */
+template<typename Accum, typename Workspace>
+auto
+gram_pca_factors(Workspace const& x, pca_extended_control const& ctrl) {
+	return gram_eig_factors<Accum>(gram_accumulated<Accum>(x), x.Height(), ctrl);
+}
+
+/* Copy the rows of a to panel in precision Accum, then center and normalize its columns */
+template<typename Matrix, typename Workspace>
+void
+load_panel(Matrix const& a, El::IR const& rows, Workspace const& means, Workspace const& stddevs, Workspace & panel) {
+	El::Copy(a(rows, El::ALL), panel);
+	detail::center_columns(panel, means);
+	El::DiagonalSolve(El::RIGHT, El::NORMAL, stddevs, panel);
+}
+
+/* Column means, standard deviations and the lower triangle of the Gram matrix of the preprocessed a for the streaming
+ * method, in precision Accum and in a single pass over a. Neither a is copied nor modified. Instead, panels of rows of
+ * a are read one after another, e.g. for matrices which are memory-mapped from files larger than the main memory.
+ * Each panel is converted to precision Accum and takes as much memory as the nxn Gram matrix or Elemental's
+ * algorithmic block size.
+ *
+ * Means and scatter matrix (x-mean)'*(x-mean) of each panel are merged with those of the rows before like Chan et
+ * al.'s pairwise update of variances, i.e. the scatter matrix grows by a rank-1 correction for the shift of the means.
+ * Both the standard deviations, which are the square roots of its scaled diagonal, and the Gram matrix of the centered
+ * and normalized a follow from the merged scatter matrix, hence a is not read beforehand to compute the moments. Like
+ * preprocess(), means are returned as a column vector and as a row vector, both zeros if a is not centered.
+ *
+ * Ref.: T. F. Chan, G. H. Golub, R. J. LeVeque. Algorithms for Computing the Sample Variance: Analysis and
+ *       Recommendations. The American Statistician, 37(3), 1983.
+ */
+template<typename Accum, typename Matrix>
+auto
+streaming_moments_and_gram(Matrix const& a, pca_extended_control const& ctrl) {
+	El::Int const m = a.Height();
+	El::Int const n = a.Width();
+	El::Int const bs = conversion_blocksize(n);
+	
+	auto means = detail::make_el_workspace<Accum>(a);
+	El::Zeros(means, n, 1);
+	auto gram = detail::make_el_workspace<Accum>(a);
+	El::Zeros(gram, n, n);
+	
+	auto panel = detail::make_el_workspace<Accum>(a);
+	auto shift = detail::make_el_workspace<Accum>(a);
+	auto shift_t = detail::make_el_workspace<Accum>(a);
+	for (El::Int i = 0; i < m; i += bs) {
+		El::Int const b = std::min(bs, m - i);
+		El::Copy(a(El::IR(i, i + b), El::ALL), panel);
+		auto panel_means = detail::column_means(panel);
+		detail::center_columns(panel, panel_means);
+		El::Syrk(El::LOWER, El::TRANSPOSE, Accum(1), panel, Accum(1), gram);
+		
+		// gram += i*b/(i+b) * shift*shift' and means += b/(i+b) * shift where shift := panel_means - means
+		El::Copy(panel_means, shift);
+		El::Axpy(Accum(-1), means, shift);
+		El::Transpose(shift, shift_t);
+		El::Syrk(El::LOWER, El::TRANSPOSE, Accum(i) * Accum(b) / Accum(i + b), shift_t, Accum(1), gram);
+		El::Axpy(Accum(b) / Accum(i + b), shift, means);
+	}
+	
+	auto stddevs = detail::make_el_workspace<Accum>(a);
+	El::Ones(stddevs, n, 1);
+	if (ctrl.normalize()) {
+		El::GetDiagonal(gram, stddevs);
+		Accum const dof = Accum(std::max<El::Int>(m - 1, 1));
+		El::EntrywiseMap(stddevs, std::function<Accum(Accum const&)>(
+			[dof](Accum const& v) { return std::sqrt(v / dof); }));
+	}
+	
+	if (!ctrl.center()) {
+		// Gram matrix of the rows of a instead of their deviations from the means, i.e. gram += m * means*means'
+		El::Transpose(means, shift_t);
+		El::Syrk(El::LOWER, El::TRANSPOSE, Accum(m), shift_t, Accum(1), gram);
+		El::Zero(means);
+	}
+	
+	if (ctrl.normalize()) {
+		El::DiagonalSolve(El::LEFT, El::NORMAL, stddevs, gram);
+		El::DiagonalSolve(El::RIGHT, El::NORMAL, stddevs, gram);
+	}
+	
+	auto mean = detail::make_el_workspace<Accum>(a);
+	El::Transpose(means, mean);
+	return std::make_tuple(std::move(means), std::move(mean), std::move(stddevs), std::move(gram));
+}
+
+/* Score of the streaming method, i.e. the preprocessed panels of rows of a times coeff */
+template<typename Accum, typename Matrix, typename Workspace>
+auto
+streaming_score(Matrix const& a, Workspace const& means, Workspace const& stddevs, Workspace const& coeff) {
+	El::Int const m = a.Height();
+	El::Int const bs = conversion_blocksize(a.Width());
+	
+	auto score = detail::make_el_workspace<Accum>(a);
+	El::Zeros(score, m, coeff.Width());
+	
+	auto panel = detail::make_el_workspace<Accum>(a);
+	for (El::Int i = 0; i < m; i += bs) {
+		El::IR const rows(i, std::min(i + bs, m));
+		load_panel(a, rows, means, stddevs, panel);
+		auto score_rows = score(rows, El::ALL);
+		El::Gemm(El::NORMAL, El::NORMAL, Accum(1), panel, coeff, Accum(0), score_rows);
+	}
+	return score;
+}
+
+/* Whether the streaming method reads a panel by panel, which pays off for local matrices only, e.g. memory-mapped
+ * files. Each panel of a distributed matrix would be redistributed and reduced collectively, i.e. O(m/bs) collectives
+ * instead of a few, hence distributed matrices are preprocessed as a whole and decomposed with the Gram method.
+ */
+template<typename Matrix>
+constexpr bool streams_panels_v = !std::is_base_of_v<El::AbstractDistMatrix<detail::el_ring_t<Matrix>>, Matrix>;
+
+/* Score of a in precision Accum from the means, standard deviations and principal components of a decomposition. Local
+ * matrices are streamed panel by panel without a copy, distributed matrices are copied, preprocessed and multiplied
+ * with coeff at once.
+ */
+template<typename Accum, typename Matrix, typename Workspace>
+auto
+score_of(Matrix const& a, Workspace const& means, Workspace const& stddevs, Workspace const& coeff) {
+	if constexpr (streams_panels_v<Matrix>) {
+		return streaming_score<Accum>(a, means, stddevs, coeff);
+	} else {
+		using ring_t = detail::el_ring_t<Matrix>;
+		
+		auto x = make_preprocess_workspace<Accum, ring_t>(a);
+		El::Copy(a, x);
+		
+		auto x_means = detail::make_el_workspace<ring_t>(a);
+		El::Copy(means, x_means);
+		detail::center_columns(x, x_means);
+		
+		auto divisors = detail::make_el_workspace<ring_t>(a);
+		El::Copy(stddevs, divisors);
+		El::DiagonalSolve(El::RIGHT, El::NORMAL, divisors, x);
+		
+		auto score = detail::make_el_workspace<Accum>(a);
+		multiply_accumulated<Accum>(x, coeff, score);
+		return score;
+	}
+}
+
+/* Principal components and variances of the preprocessed matrix x in precision Accum with the algorithm chosen in
+ * ctrl. The svd method overwrites x if it already has scalar type Accum and decomposes a converted copy else.
+ */
+template<typename Accum, typename Workspace>
+auto
+pca_factors(Workspace & x, pca_extended_control const& ctrl) {
+	switch (ctrl.method()) {
+		case pca_method::randomized:
+			return randomized_pca_factors<Accum>(x, ctrl);
+		case pca_method::gram:
+		case pca_method::streaming:
+			return gram_pca_factors<Accum>(x, ctrl);
+		case pca_method::svd:
+		default:
+			if constexpr (std::is_same_v<detail::el_ring_t<Workspace>, Accum>) {
+				return svd_pca_factors(x, ctrl);
+			} else {
+				auto y = detail::make_el_workspace<Accum>(x);
+				El::Copy(x, y);
+				return svd_pca_factors(y, ctrl);
+			}
+	}
+}
+
+/* Column sums of a [VC,STAR] matrix as a nx1 [STAR,STAR] vector. Each process sums up its local rows and a single
+ * allreduce combines the partial sums, i.e. no redistribution of x is required.
+ */
+template<typename Ring>
+El::DistMatrix<Ring, El::STAR, El::STAR>
+tall_skinny_column_sums(El::DistMatrix<Ring, El::VC, El::STAR> const& x) {
+	El::DistMatrix<Ring, El::STAR, El::STAR> sums{x.Grid()};
+	El::Zeros(sums, x.Width(), 1);
+	
+	El::Matrix<Ring> ones;
+	El::Ones(ones, x.LocalHeight(), 1);
+	El::Gemv(El::TRANSPOSE, Ring(1), x.LockedMatrix(), ones, Ring(0), sums.Matrix());
+	El::AllReduce(sums.Matrix(), x.ColComm());
+	return sums;
+}
+
+/* Elemental's TSQR requires a power-of-two number of processes and at least as many rows as columns on each process */
+template<typename Ring, El::Dist Columnwise, El::Dist Rowwise, El::DistWrap Wrapping>
+bool
+tsqr_applicable(El::DistMatrix<Ring, Columnwise, Rowwise, Wrapping> const& a) {
+	El::Int const p = a.Grid().Size();
+	El::Int const m = a.Height();
+	El::Int const n = a.Width();
+	return ((p & (p - 1)) == 0) && (m > n) && (m / p >= n);
+}
+
+/* Whether svd_pca() decomposes a with TSQR, i.e. whether a is a tall-skinny matrix whose rows are distributed and whose
+ * columns are not and tsqr_applicable() holds
+ */
+template<
+	typename Ring,
+	El::Dist Columnwise,
+	El::Dist Rowwise,
+	El::DistWrap Wrapping
+>
+bool
+uses_tsqr(mpl::el_dist_matrix<Ring, Columnwise, Rowwise, Wrapping> const& a) {
+	if constexpr ((Columnwise == El::VC || Columnwise == El::MC) && Rowwise == El::STAR) {
+		return tsqr_applicable(a.data());
+	} else {
+		return false;
+	}
+}
+
+/* PCA of tall-skinny matrices whose rows are distributed and whose columns are not, i.e. [VC,STAR] and [MC,STAR]. The
+ * communication-avoiding TSQR x = q*r needs a single reduction tree, the small nxn SVD r = u*diag(s)*v' is computed
+ * redundantly on each process and score = q*u*diag(s) is a local matrix product. [MC,STAR] matrices are copied to
+ * [VC,STAR], which is a one-dimensional redistribution, but no matrix is redistributed to [MC,MR].
+ *
+ * Economy-sized results keep min(m-1,n) principal components, like MATLAB's pca, and full-sized results keep n. Both
+ * coincide here because tsqr_applicable() requires m > n, hence ctrl.economy() needs no extra handling.
+ *
+ * Ref.: J. Demmel, L. Grigori, M. Hoemmen, J. Langou. Communication-optimal Parallel and Sequential QR and LU
+ *       Factorizations. SIAM Journal on Scientific Computing, 34(1), 2012.
+ */
+template<
+	typename Ring,
+	El::Dist Columnwise,
+	El::Dist Rowwise,
+	El::DistWrap Wrapping
+>
+auto
+tsqr_pca(
+	mpl::el_dist_matrix<Ring, Columnwise, Rowwise, Wrapping> const& a,
+	mpl::pca_control<bool,bool,bool> const& ctrl
+) {
+	El::Grid const& grid = a.data().Grid();
+	El::DistMatrix<Ring, El::VC, El::STAR> x{a.data()};
+	El::Int const m = x.Height();
+	El::Int const n = x.Width();
+	bool const center = ctrl.center();
+	bool const normalize = ctrl.normalize();
+	// economy-sized and full-sized results coincide, see above
+	BOOST_ASSERT(std::min(m - 1, n) == n);
+	
+	El::DistMatrix<Ring, El::STAR, El::STAR> means{grid};
+	El::Zeros(means, n, 1);
+	
+	El::Matrix<Ring> ones;
+	El::Ones(ones, x.LocalHeight(), 1);
+	
+	if (center || normalize) {
+		means = tall_skinny_column_sums(x);
+		El::Scale(Ring(1) / Ring(m), means);
+		El::Geru(Ring(-1), ones, means.LockedMatrix(), x.Matrix());
+	}
+	
+	El::DistMatrix<Ring, El::STAR, El::STAR> stddevs{grid};
+	El::Ones(stddevs, n, 1);
+	
+	if (normalize) {
+		El::DistMatrix<Ring, El::VC, El::STAR> squares{grid};
+		El::Hadamard(x, x, squares);
+		stddevs = tall_skinny_column_sums(squares);
+		Ring const dof = Ring(std::max<El::Int>(m - 1, 1));
+		El::EntrywiseMap(stddevs, std::function<Ring(Ring const&)>(
+			[dof](Ring const& v) { return std::sqrt(v / dof); }));
+		
+		if (!center) {
+			El::Geru(Ring(1), ones, means.LockedMatrix(), x.Matrix());
+		}
+		El::DiagonalSolve(El::RIGHT, El::NORMAL, stddevs.LockedMatrix(), x.Matrix());
+	}
+	
+	if (!center) {
+		El::Zero(means);
+	}
+	
+	El::DistMatrix<Ring, El::STAR, El::STAR> r{grid};
+	El::qr::ExplicitTS(x, r);
+	
+	El::Matrix<Ring> u, s, v;
+	El::SVDCtrl<Ring> svd_ctrl;
+	svd_ctrl.bidiagSVDCtrl.approach = El::THIN_SVD;
+	El::SVD(r.Matrix(), u, s, v, svd_ctrl);
+	
+	El::DiagonalScale(El::RIGHT, El::NORMAL, s, u);
+	El::DistMatrix<Ring, El::VC, El::STAR> score{grid};
+	score.AlignWith(x.DistData());
+	El::Zeros(score, m, u.Width());
+	El::Gemm(El::NORMAL, El::NORMAL, Ring(1), x.LockedMatrix(), u, Ring(0), score.Matrix());
+	
+	El::DistMatrix<Ring, El::STAR, El::STAR> coeff{grid}, latent{grid}, mean{grid};
+	coeff.Resize(v.Height(), v.Width());
+	El::Copy(v, coeff.Matrix());
+	// like hbrs::mpl's pca, principal components of normalized data are scaled by the standard deviations
+	El::DiagonalScale(El::LEFT, El::NORMAL, stddevs.LockedMatrix(), coeff.Matrix());
+	latent.Resize(s.Height(), s.Width());
+	El::Copy(s, latent.Matrix());
+	detail::singular_values_to_variances(latent, m);
+	El::Transpose(means, mean);
+	
+	return make_pca_result<Ring>(a, coeff, score, latent, mean);
+}
+
+/* hbrs::mpl's SVD-based PCA, except for tall-skinny matrices with [VC,STAR] or [MC,STAR] distribution which are
+ * decomposed with TSQR instead
+ */
+template<typename Ring>
+auto
+svd_pca(mpl::el_matrix<Ring> const& a, mpl::pca_control<bool,bool,bool> const& ctrl) {
+	return hbrs::mpl::pca(a, ctrl);
+}
+
+template<
+	typename Ring,
+	El::Dist Columnwise,
+	El::Dist Rowwise,
+	El::DistWrap Wrapping
+>
+auto
+svd_pca(
+	mpl::el_dist_matrix<Ring, Columnwise, Rowwise, Wrapping> const& a,
+	mpl::pca_control<bool,bool,bool> const& ctrl
+) {
+	if constexpr ((Columnwise == El::VC || Columnwise == El::MC) && Rowwise == El::STAR) {
+		if (uses_tsqr(a)) {
+			return tsqr_pca(a, ctrl);
+		}
+	}
+	return hbrs::mpl::pca(a, ctrl);
+}
+
+/* Decomposition by the extended, i.e. not hbrs::mpl's, algorithms in precision Accum: principal components and
+ * variances, column means as a row vector, standard deviations as a column vector and, if want_score, the score. The
+ * principal components are orthonormal, see scale_coeff().
+ */
+template<typename Accum, typename Matrix>
+auto
+decompose(Matrix const& a, pca_extended_control const& ctrl, bool want_score) {
+	using workspace_t = decltype(detail::make_el_workspace<Accum>(a));
+	std::optional<workspace_t> score;
+	
+	if constexpr (streams_panels_v<Matrix>) {
+		if (ctrl.method() == pca_method::streaming) {
+			auto [means, mean, stddevs, gram] = streaming_moments_and_gram<Accum>(a, ctrl);
+			auto factors = gram_eig_factors<Accum>(gram, a.Height(), ctrl);
+			if (want_score) {
+				score = streaming_score<Accum>(a, means, stddevs, factors.first);
+			}
+			return std::make_tuple(std::move(factors), std::move(mean), std::move(stddevs), std::move(score));
+		}
+	}
+	
+	auto preprocessed = preprocess<Accum>(a, ctrl);
+	auto & x = std::get<0>(preprocessed);
+	using x_t = std::decay_t<decltype(x)>;
+	
+	std::optional<x_t> copy;
+	if constexpr (std::is_same_v<detail::el_ring_t<x_t>, Accum>) {
+		if (want_score && ctrl.method() == pca_method::svd) {
+			// the svd method would overwrite x, from which the score is computed
+			copy.emplace(detail::make_el_workspace<Accum>(x));
+			El::Copy(x, *copy);
+		}
+	}
+	auto factors = pca_factors<Accum>(copy ? *copy : x, ctrl);
+	copy.reset();
+	
+	if (want_score) {
+		score.emplace(detail::make_el_workspace<Accum>(x));
+		multiply_accumulated<Accum>(x, factors.first, *score);
+	}
+	
+	return std::make_tuple(
+		std::move(factors), std::move(std::get<1>(preprocessed)), std::move(std::get<2>(preprocessed)),
+		std::move(score));
+}
+
+/* Like MATLAB's pca with variable weights, principal components of normalized data are scaled by the standard
+ * deviations stddevs of the columns of the input, i.e. they are not orthonormal, so that score*coeff' + mean
+ * reconstructs the input just as it does for hbrs::mpl's pca
+ */
+template<typename Workspace>
+void
+scale_coeff(Workspace & coeff, Workspace const& stddevs, pca_extended_control const& ctrl) {
+	if (ctrl.normalize()) {
+		El::DiagonalScale(El::LEFT, El::NORMAL, stddevs, coeff);
+	}
+}
+
+/* PCA with the algorithm chosen in ctrl, whose products are accumulated in precision Accum and whose results have
+ * scalar type Result. Normalized PCAs are computed by lazy_pca() instead, because pca_transform requires the scaling
+ * which hbrs::mpl's pca_result does not record.
+ */
+template<typename Accum, typename Result, typename Matrix>
+auto
+extended_pca(Matrix const& a, pca_extended_control const& ctrl) {
+	using ring_t = detail::el_ring_t<std::decay_t<decltype(a.data())>>;
+	
+	// hbrs::mpl's pca does not accept read-only matrices
+	if constexpr (std::is_same_v<Accum, ring_t> && !std::is_same_v<Matrix, mpl::el_matrix<ring_t const>>) {
+		if (ctrl.method() == pca_method::svd) {
+			auto result = svd_pca(
+				a, mpl::pca_control<bool,bool,bool>{ctrl.economy(), ctrl.center(), ctrl.normalize()});
+			
+			// the full decomposition has been computed, num_components only trims it, see pca_extended_control
+			El::Int k = static_cast<El::Int>(ctrl.num_components());
+			if (k == 0 || k >= result.coeff().data().Width()) {
+				if constexpr (std::is_same_v<Result, ring_t>) {
+					return result;
+				}
+				k = result.coeff().data().Width();
+			}
+			
+			return make_pca_result<Result>(a,
+				result.coeff().data()(El::ALL, El::IR(0, k)),
+				result.score().data()(El::ALL, El::IR(0, k)),
+				result.latent().data()(El::IR(0, k), El::ALL),
+				result.mean().data());
+		}
+	}
+	
+	auto [factors, mean, stddevs, score] = decompose<Accum>(a.data(), ctrl, true);
+	scale_coeff(factors.first, stddevs, ctrl);
+	return make_pca_result<Result>(a, factors.first, *score, factors.second, mean);
+}
+
+/* Python object which holds a, or an empty object if a is not held by any Python object, e.g. because pybind11
+ * converted it from an argument of another type and destroys it right after the call
+ */
+template<typename Matrix>
+py::object
+python_object_of(Matrix const& a) {
+	py::detail::type_info const* type = py::detail::get_type_info(typeid(Matrix));
+	py::handle obj = type ? py::detail::get_object_handle(&a, type) : py::handle{};
+	return py::reinterpret_borrow<py::object>(obj);
+}
+
+/* Like extended_pca(), but the score is computed eagerly, on first access or not at all as requested by ctrl and the
+ * standard deviations of normalized inputs are recorded. The preprocessed copy of a is released right after the
+ * decomposition, hence a lazy score is computed from a again, with the means and standard deviations of the
+ * decomposition, see score_of(). It keeps the Python object which holds a alive, but a lazy score reflects changes
+ * made to a in between, e.g. through a NumPy array a views. If no Python object holds a, the score is computed
+ * eagerly instead. Results of the svd method are always economy-sized here, because hbrs::mpl's pca always computes
+ * the score.
+ */
+template<typename Accum, typename Result, typename Matrix>
+auto
+lazy_pca(Matrix const& a, pca_extended_control const& ctrl) {
+	using workspace_t = decltype(detail::make_el_workspace<Accum>(a.data()));
+	
+	py::object a_obj;
+	if (ctrl.score() == pca_score::lazy) {
+		a_obj = python_object_of(a);
+	}
+	bool const lazy = static_cast<bool>(a_obj);
+	bool const eager = ctrl.score() == pca_score::eager || (ctrl.score() == pca_score::lazy && !lazy);
+	
+	// the decomposition does not touch Python objects, but make_score below does
+	auto decomposition = detail::without_gil([&]() { return decompose<Accum>(a.data(), ctrl, eager); });
+	auto & [factors, mean, stddevs, score] = decomposition;
+	
+	std::function<workspace_t()> make_score;
+	if (lazy) {
+		auto means = detail::make_el_workspace<Accum>(a.data());
+		El::Transpose(mean, means);
+		
+		// keep the Python object which holds a alive as long as the score has not been computed
+		make_score = [
+			a_obj = std::move(a_obj),
+			a_ptr = &a,
+			means = std::move(means),
+			stddevs = stddevs,
+			coeff = factors.first
+		]() {
+			// the moments of the decomposition are reused, i.e. a is read once more
+			return score_of<Accum>(a_ptr->data(), means, stddevs, coeff);
+		};
+	}
+	
+	std::optional<workspace_t> scale;
+	if (ctrl.normalize()) {
+		scale = stddevs;
+	}
+	scale_coeff(factors.first, stddevs, ctrl);
+	
+	return make_lazy_pca_result<Result>(
+		a, factors.first, score, std::move(make_score), factors.second, mean, scale);
+}
+
+/* Call f with the scalar type selected by precision p, which has to be Input, i.e. the scalar type of the input matrix,
+ * or Wide. Other precisions, e.g. accumulating double matrices in float, would instantiate all algorithms once more but
+ * gain nothing and hence are rejected.
+ */
+template<typename Input, typename Wide, typename F>
+decltype(auto)
+with_precision(pca_precision p, F && f) {
+	auto call = [&f](auto ring_tc, char const* name) -> decltype(f(hana::type_c<Input>)) {
+		using ring_t = typename decltype(ring_tc)::type;
+		if constexpr (std::is_same_v<ring_t, Input> || std::is_same_v<ring_t, Wide>) {
+			return f(ring_tc);
+		} else {
+			BOOST_THROW_EXCEPTION((pca_precision_not_supported_exception{} << errinfo_pca_precision{name}));
+		}
+	};
+	
+	switch (p) {
+		case pca_precision::float32:
+			return call(hana::type_c<float>, "float32");
+		case pca_precision::float64:
+			return call(hana::type_c<double>, "float64");
+		case pca_precision::input:
+		default:
+			return f(hana::type_c<Input>);
+	}
+}
+
+/* fn.pca with a pca_extended_control, dispatching on the requested precisions and the score mode */
+template<typename Matrix>
+py::object
+dispatch_pca(Matrix const& a, pca_extended_control const& ctrl) {
+	using ring_t = detail::el_ring_t<std::decay_t<decltype(a.data())>>;
+	
+	// products are accumulated in the precision of a or in double, results have the precision of a or of the products
+	return with_precision<ring_t, double>(ctrl.accumulation(), [&](auto accum_tc) {
+		using accum_t = typename decltype(accum_tc)::type;
+		return with_precision<ring_t, accum_t>(ctrl.result_precision(), [&](auto result_tc) {
+			using result_t = typename decltype(result_tc)::type;
+			
+			// results of another precision than the input may refer to classes which are not registered yet
+			detail::require_pydefs<result_t>();
+			
+			// only lazy_pca_result records the scaling of normalized inputs
+			if (ctrl.score() == pca_score::eager && !ctrl.normalize()) {
+				return py::cast(detail::without_gil([&]() { return extended_pca<accum_t, result_t>(a, ctrl); }));
+			}
+			return py::cast(lazy_pca<accum_t, result_t>(a, ctrl));
+		});
+	});
+}
+
+/* Number of leading components of a fitted PCA to use, where an empty k means all available components */
+El::Int
+transform_rank(El::Int available, std::optional<std::size_t> const& k) {
+	return k ? std::min(available, static_cast<El::Int>(*k)) : available;
+}
+
+/* Project the mxn matrix a onto the first k principal components of a fitted PCA, i.e. (a - ones(m,1)*mean)*coeff_k
+ * for orthonormal principal components. Blocks of rows of local matrices are copied, centered and multiplied with
+ * coeff_k one after another, hence besides the mxk result only a block is allocated and a is neither copied as a whole
+ * nor modified. Centering before the product avoids the cancellation of a*coeff_k - ones(m,1)*(mean*coeff_k) for large
+ * means.
+ *
+ * Principal components of normalized data are scaled by the standard deviations, see scale_coeff(), hence the
+ * projection is (a - ones(m,1)*mean)*diag(scale)^-2*coeff_k if scale is not null.
+ */
+template<typename Matrix, typename Coeff, typename Mean>
+auto
+project(Matrix const& a, Coeff const& coeff_k, Mean const& mean, Mean const* scale) {
+	using ring_t = detail::el_ring_t<std::decay_t<decltype(a.data())>>;
+	
+	El::Int const m = a.data().Height();
+	El::Int const bs = conversion_blocksize(a.data().Width());
+	
+	auto means = detail::make_el_workspace<ring_t>(a.data());
+	El::Transpose(mean, means);
+	
+	auto variances = detail::make_el_workspace<ring_t>(a.data());
+	if (scale) {
+		El::Transpose(*scale, variances);
+		El::EntrywiseMap(variances, std::function<ring_t(ring_t const&)>([](ring_t const& s) { return s * s; }));
+	}
+	
+	auto score = detail::make_el_workspace<ring_t>(a.data());
+	El::Zeros(score, m, coeff_k.Width());
+	
+	auto panel = detail::make_el_workspace<ring_t>(a.data());
+	for (El::Int i = 0; i < m; i += bs) {
+		El::IR const rows(i, std::min(i + bs, m));
+		El::Copy(a.data()(rows, El::ALL), panel);
+		detail::center_columns(panel, means);
+		if (scale) {
+			El::DiagonalSolve(El::RIGHT, El::NORMAL, variances, panel);
+		}
+		auto score_rows = score(rows, El::ALL);
+		El::Gemm(El::NORMAL, El::NORMAL, ring_t(1), panel, coeff_k, ring_t(0), score_rows);
+	}
+	
+	return wrap_matrix<ring_t>(a, score);
+}
+
+/* Like above for distributed matrices, but instead of a distributed product per block of rows, a is redistributed once
+ * to [VC,STAR], i.e. each process holds whole rows, while the small matrices coeff_k, mean and scale are replicated.
+ * Each process then centers its local rows and multiplies them with coeff_k in a single local product.
+ */
+template<
+	typename Ring,
+	El::Dist Columnwise,
+	El::Dist Rowwise,
+	El::DistWrap Wrapping,
+	typename Coeff,
+	typename Mean
+>
+auto
+project(
+	mpl::el_dist_matrix<Ring, Columnwise, Rowwise, Wrapping> const& a,
+	Coeff const& coeff_k,
+	Mean const& mean,
+	Mean const* scale
+) {
+	El::Grid const& grid = a.data().Grid();
+	El::DistMatrix<Ring, El::VC, El::STAR> x{a.data()};
+	El::DistMatrix<Ring, El::STAR, El::STAR> coeff_all{coeff_k};
+	El::DistMatrix<Ring, El::STAR, El::STAR> mean_all{mean};
+	
+	El::Matrix<Ring> means;
+	El::Transpose(mean_all.LockedMatrix(), means);
+	detail::center_columns(x.Matrix(), means);
+	
+	if (scale) {
+		El::DistMatrix<Ring, El::STAR, El::STAR> scale_all{*scale};
+		El::Matrix<Ring> variances;
+		El::Transpose(scale_all.LockedMatrix(), variances);
+		El::EntrywiseMap(variances, std::function<Ring(Ring const&)>([](Ring const& s) { return s * s; }));
+		El::DiagonalSolve(El::RIGHT, El::NORMAL, variances, x.Matrix());
+	}
+	
+	El::DistMatrix<Ring, El::VC, El::STAR> score{grid};
+	score.AlignWith(x.DistData());
+	El::Zeros(score, x.Height(), coeff_all.Width());
+	El::Gemm(El::NORMAL, El::NORMAL, Ring(1), x.LockedMatrix(), coeff_all.LockedMatrix(), Ring(0), score.Matrix());
+	
+	return wrap_matrix<Ring>(a, score);
+}
+
+/* Principal components of hbrs::mpl's pca_result are orthonormal unless the PCA normalized its input, whose standard
+ * deviations it does not record. Such results cannot be used to project other data and are rejected with the maximum
+ * deviation of coeff_k'*coeff_k from the identity.
+ */
+template<typename Coeff>
+void
+check_orthonormal(Coeff const& coeff_k) {
+	using ring_t = detail::el_ring_t<Coeff>;
+	using real_t = El::Base<ring_t>;
+	
+	auto gram = detail::make_el_workspace<ring_t>(coeff_k);
+	El::Zeros(gram, coeff_k.Width(), coeff_k.Width());
+	El::Gemm(El::ADJOINT, El::NORMAL, ring_t(1), coeff_k, coeff_k, ring_t(0), gram);
+	El::ShiftDiagonal(gram, ring_t(-1));
+	
+	real_t const deviation = El::MaxNorm(gram);
+	if (!(deviation <= std::sqrt(El::limits::Epsilon<real_t>()))) {
+		BOOST_THROW_EXCEPTION((components_not_orthonormal_exception{}
+			<< errinfo_orthonormality_deviation{static_cast<double>(deviation)}));
+	}
+}
+
+template<typename Matrix, typename Coeff, typename Score, typename Latent, typename Mean>
+auto
+pca_transform(
+	mpl::pca_result<Coeff, Score, Latent, Mean> const& result,
+	Matrix const& a,
+	std::optional<std::size_t> const& k
+) {
+	auto const& coeff = result.coeff().data();
+	
+	if (a.data().Width() != coeff.Height()) {
+		BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{}
+			<< mpl::errinfo_el_matrix_size{{a.data().Height(), a.data().Width()}}));
+	}
+	
+	auto const coeff_k = coeff(El::ALL, El::IR(0, transform_rank(coeff.Width(), k)));
+	check_orthonormal(coeff_k);
+	return project(a, coeff_k, result.mean().data(), nullptr);
+}
+
+template<typename Matrix, typename Coeff, typename Score, typename Latent, typename Mean>
+auto
+pca_transform(
+	lazy_pca_result<Coeff, Score, Latent, Mean> const& result,
+	Matrix const& a,
+	std::optional<std::size_t> const& k
+) {
+	auto const& coeff = result.coeff().data();
+	
+	if (a.data().Width() != coeff.Height()) {
+		BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{}
+			<< mpl::errinfo_el_matrix_size{{a.data().Height(), a.data().Width()}}));
+	}
+	
+	auto const coeff_k = coeff(El::ALL, El::IR(0, transform_rank(coeff.Width(), k)));
+	return project(a, coeff_k, result.mean().data(), result.scale() ? &result.scale()->data() : nullptr);
+}
+
+/* Map the first k columns of score back to the original space of a fitted PCA, i.e. score_k*coeff_k' + ones(m,1)*mean.
+ * Like in MATLAB, principal components of normalized data are scaled by the standard deviations, see scale_coeff(),
+ * hence the normalization is undone as well.
+ */
+template<typename Matrix, typename Result>
+auto
+pca_inverse_transform(Result const& result, Matrix const& score, std::optional<std::size_t> const& k) {
+	using ring_t = detail::el_ring_t<std::decay_t<decltype(score.data())>>;
+	
+	auto const& coeff = result.coeff().data();
+	auto const& mean = result.mean().data();
+	
+	if (score.data().Width() > coeff.Width()) {
+		BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{}
+			<< mpl::errinfo_el_matrix_size{{score.data().Height(), score.data().Width()}}));
+	}
+	
+	El::Int const l = transform_rank(score.data().Width(), k);
+	
+	auto x = detail::make_el_workspace<ring_t>(score.data());
+	El::Gemm(El::NORMAL, El::TRANSPOSE, ring_t(1),
+		score.data()(El::ALL, El::IR(0, l)), coeff(El::ALL, El::IR(0, l)), x);
+	
+	auto means = detail::make_el_workspace<ring_t>(score.data());
+	El::Transpose(mean, means);
+	auto ones = detail::make_el_workspace<ring_t>(score.data());
+	El::Ones(ones, x.Height(), 1);
+	El::Geru(ring_t(1), ones, means, x);
+	
+	return wrap_matrix<ring_t>(score, x);
+}
+
+/* Register fn.pca_transform and fn.pca_inverse_transform for both eager and lazy PCA results */
+template<typename Matrix, typename Coeff, typename Score, typename Latent, typename Mean>
+void
+def_pca_transforms(py::module & m) {
+	hana::for_each(
+		hana::make_tuple(
+			hana::type_c<mpl::pca_result<Coeff, Score, Latent, Mean>>,
+			hana::type_c<lazy_pca_result<Coeff, Score, Latent, Mean>>
+		),
+		[&m](auto result_tn) {
+			using result_t = typename decltype(result_tn)::type;
+			
+			m.def("pca_transform",
+				[](result_t const& result, Matrix const& x, std::optional<std::size_t> const& k) {
+					return pca_transform(result, x, k);
+				},
+				py::arg("result"),
+				py::arg("x"),
+				py::arg("k") = py::none(),
+				py::call_guard<py::gil_scoped_release>()
+			);
+			
+			m.def("pca_inverse_transform",
+				[](result_t const& result, Matrix const& score, std::optional<std::size_t> const& k) {
+					return pca_inverse_transform(result, score, k);
+				},
+				py::arg("result"),
+				py::arg("score"),
+				py::arg("k") = py::none(),
+				py::call_guard<py::gil_scoped_release>()
+			);
+		}
+	);
+}
+
 EDAMER_NAMESPACE_END(/* unnamed */)
 
 py::module &
@@ -55,6 +1381,8 @@ pydef_impl<hbrs::mpl::detail::pca_impl_el_matrix>::apply(py::module & m, py::mod
 	auto ring_tns = scalars;
 	
 	using hbrs::mpl::el_matrix;
+	using hbrs::mpl::el_column_vector;
+	using hbrs::mpl::el_row_vector;
 	using hbrs::mpl::pca_control;
 	
 	hana::for_each(ring_tns, [&m](auto ring_tn) {
@@ -66,8 +1394,34 @@ pydef_impl<hbrs::mpl::detail::pca_impl_el_matrix>::apply(py::module & m, py::mod
 				return hbrs::mpl::pca(a, ctrl);
 			},
 			py::arg("a"),
+			py::arg("ctrl"),
+			py::call_guard<py::gil_scoped_release>()
+		);
+		
+		m.def("pca",
+			[](el_matrix<ring_t> const& a, pca_extended_control const& ctrl) -> py::object {
+				return dispatch_pca(a, ctrl);
+			},
+			py::arg("a"),
 			py::arg("ctrl")
 		);
+		
+		// e.g. for memory-mapped files, which are read-only
+		m.def("pca",
+			[](el_matrix<ring_t const> const& a, pca_extended_control const& ctrl) -> py::object {
+				return dispatch_pca(a, ctrl);
+			},
+			py::arg("a"),
+			py::arg("ctrl")
+		);
+		
+		def_pca_transforms<
+			el_matrix<ring_t>,
+			el_matrix<ring_t>,
+			el_matrix<ring_t>,
+			el_column_vector<ring_t>,
+			el_row_vector<ring_t>
+		>(m);
 	});
 	return m;
 }
@@ -77,9 +1431,11 @@ pydef_impl<hbrs::mpl::detail::pca_impl_el_dist_matrix>::apply(py::module & m, py
 	auto ring_tns = scalars;
 	
 	using hbrs::mpl::el_dist_matrix;
+	using hbrs::mpl::el_dist_column_vector;
+	using hbrs::mpl::el_dist_row_vector;
 	using hbrs::mpl::pca_control;
 	
-	hana::for_each(ring_tns, [&m](auto ring_tn) {
+	detail::for_each_deferred(ring_tns, [m](auto ring_tn) mutable {
 		using ring_t = typename decltype(+hana::first(ring_tn))::type;
 		auto ring_n = hana::second(ring_tn);
 		
@@ -93,11 +1449,39 @@ pydef_impl<hbrs::mpl::detail::pca_impl_el_dist_matrix>::apply(py::module & m, py
 				[](el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value> const& a,
 				   pca_control<bool,bool,bool> const& ctrl
 				) {
-					return hbrs::mpl::pca(a, ctrl);
+					return svd_pca(a, ctrl);
+				},
+				py::arg("a"),
+				py::arg("ctrl"),
+				py::call_guard<py::gil_scoped_release>()
+			);
+			
+			m.def("pca",
+				[](el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value> const& a,
+				   pca_extended_control const& ctrl
+				) -> py::object {
+					return dispatch_pca(a, ctrl);
 				},
 				py::arg("a"),
 				py::arg("ctrl")
 			);
+			
+			m.def("pca_uses_tsqr",
+				[](el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value> const& a) {
+					return uses_tsqr(a);
+				},
+				py::arg("a"),
+				"Whether pca() with method svd decomposes a with TSQR instead of hbrs::mpl's pca"
+			);
+			
+			using dist_matrix_t = el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>;
+			def_pca_transforms<
+				dist_matrix_t,
+				dist_matrix_t,
+				dist_matrix_t,
+				el_dist_column_vector<ring_t, El::MD, El::STAR, wrapping_t::value>,
+				el_dist_row_vector<ring_t, El::STAR, El::VC, wrapping_t::value>
+			>(m);
 		});
 	});
 	return m;
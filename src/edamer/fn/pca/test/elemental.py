@@ -6,10 +6,15 @@
 # Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
 
 from edamer import detail, dt, fn
+import gc
 import logging
 from mpi4py import MPI
 import numpy as np  # noqa F401
+import os
 import pytest
+import shutil
+import tempfile
+import weakref
 
 TestArguments = dict(
     dataset=[
@@ -142,3 +147,361 @@ def test_fn_pca_compare_results(env, dataset, economy, center, normalize):
         logging.info("comparing mean of impl %s and %s" % (factory_n_i, factory_n_j))
         assert detail.test.vector_vector_allclose(factory_result_i.mean, factory_result_j.mean)
         logging.info("comparing impl %s and %s done." % (factory_n_i, factory_n_j))
+
+
+def make_low_rank_dataset(m, n, rank):
+    rng = np.random.RandomState(1337)
+    u, _ = np.linalg.qr(rng.standard_normal((m, rank)))
+    v, _ = np.linalg.qr(rng.standard_normal((n, rank)))
+    s = np.logspace(2, 0, rank)
+    return np.asarray(u @ np.diag(s) @ v.T + 1e-6 * rng.standard_normal((m, n)) + 3, order='F')
+
+
+@pytest.mark.parametrize("factory", TestArguments["factory"])
+@pytest.mark.parametrize("method", ["randomized", dt.PcaMethod.RANDOMIZED, "svd", "gram", "streaming"])
+@pytest.mark.parametrize("center", TestArguments["center"])
+def test_fn_pca_num_components(env, factory, method, center):
+    factory_n = factory[0]
+    factory_f = factory[1]
+    logging.debug('factory:    %r' % factory_n)
+    logging.debug('method:     %r' % method)
+    logging.debug('center:     %r' % center)
+
+    m, n, k = 200, 30, 3
+    dataset = make_low_rank_dataset(m, n, 5)
+    ctrl = dt.PcaControl.make(True, center, False, method=method, num_components=k, oversampling=10,
+                              power_iterations=2)
+    assert isinstance(ctrl, dt.PcaControl)
+
+    testcase = factory_f(dataset, True, center, False)
+    result = testcase[0](testcase[1], ctrl)
+
+    mean_np = dataset.mean(axis=0) if center else np.zeros(n)
+    _, s_np, vt_np = np.linalg.svd(dataset - mean_np, full_matrices=False)
+
+    coeff = detail.test.to_numpy_2d(result.coeff)
+    score = detail.test.to_numpy_2d(result.score)
+    latent = detail.test.to_numpy_1d(result.latent)
+    mean = detail.test.to_numpy_1d(result.mean)
+
+    assert coeff.shape == (n, k)
+    assert score.shape == (m, k)
+    assert np.allclose(latent, s_np[:k]**2 / (m - 1))
+    assert np.allclose(mean, mean_np)
+    # principal components are unique up to their sign
+    assert np.allclose(np.abs(coeff), np.abs(vt_np[:k, :].T), atol=1e-6)
+    assert np.allclose(score, (dataset - mean_np) @ coeff, atol=1e-6)
+
+
+def test_pca_control_make_method(env):
+    ctrl = dt.PcaControl.make(economy=True, center=True, normalize=False, method="randomized", num_components=5)
+    assert ctrl.method == dt.PcaMethod.RANDOMIZED
+    assert ctrl.num_components == 5
+
+    with pytest.raises(dt.PcaMethodNotSupportedException):
+        dt.PcaControl.make(economy=True, center=True, normalize=False, method="unknown")
+
+
+@pytest.mark.parametrize("factory", TestArguments["factory"])
+def test_fn_pca_randomized_seed(env, factory):
+    factory_n = factory[0]
+    factory_f = factory[1]
+    logging.debug('factory:    %r' % factory_n)
+
+    m, n, k = 200, 30, 3
+    # slowly decaying spectrum without power iterations, hence results depend on the random test matrix
+    dataset = make_low_rank_dataset(m, n, n)
+    testcase = factory_f(dataset, True, True, False)
+
+    def coeff(seed):
+        ctrl = dt.PcaControl.make(True, True, False, method="randomized", num_components=k, power_iterations=0,
+                                  seed=seed)
+        return detail.test.to_numpy_2d(testcase[0](testcase[1], ctrl).coeff)
+
+    assert dt.PcaControl.make(True, True, False, seed=7).seed == 7
+    coeff_7 = coeff(7)
+    assert np.array_equal(coeff_7, coeff(7))
+    assert not np.array_equal(coeff_7, coeff(8))
+    # all processes draw the same test matrix
+    assert all(np.array_equal(coeff_7, c) for c in env.comm.allgather(coeff_7))
+
+
+@pytest.mark.parametrize("factory", TestArguments["factory"])
+@pytest.mark.parametrize("method", ["randomized", "svd", "gram", "streaming"])
+def test_fn_pca_lazy_score(env, factory, method):
+    factory_n = factory[0]
+    factory_f = factory[1]
+    logging.debug('factory:    %r' % factory_n)
+    logging.debug('method:     %r' % method)
+
+    m, n, k = 200, 30, 3
+    dataset = make_low_rank_dataset(m, n, 5)
+    testcase = factory_f(dataset, True, True, False)
+
+    eager = testcase[0](testcase[1], dt.PcaControl.make(True, True, False, method=method, num_components=k))
+    lazy = testcase[0](testcase[1], dt.PcaControl.make(True, True, False, method=method, num_components=k,
+                                                       score=dt.PcaScore.LAZY))
+    assert lazy.has_score()
+
+    coeff_eager = detail.test.to_numpy_2d(eager.coeff)
+    coeff_lazy = detail.test.to_numpy_2d(lazy.coeff)
+    assert np.allclose(coeff_lazy, coeff_eager, atol=1e-6)
+    assert np.allclose(detail.test.to_numpy_1d(lazy.latent), detail.test.to_numpy_1d(eager.latent))
+    assert np.allclose(detail.test.to_numpy_1d(lazy.mean), detail.test.to_numpy_1d(eager.mean))
+
+    score = detail.test.to_numpy_2d(lazy.score)
+    assert score.shape == (m, k)
+    assert np.allclose(score, (dataset - dataset.mean(axis=0)) @ coeff_lazy, atol=1e-6)
+
+
+def test_fn_pca_lazy_score_owns_input(env):
+    m, n, k = 200, 30, 3
+    dataset = make_low_rank_dataset(m, n, 5)
+    expected = (dataset - dataset.mean(axis=0))
+
+    # the lazy result keeps the matrix and the NumPy array it views alive, even if no other reference remains
+    a_np = np.asarray(dataset.copy(), order='F')
+    a = dt.ElMatrix.view_from_numpy(a_np)
+    a_ref = weakref.ref(a)
+    lazy = fn.pca(a, dt.PcaControl.make(True, True, False, method="gram", num_components=k, score="lazy"))
+    del a, a_np
+    gc.collect()
+    assert a_ref() is not None
+
+    score = detail.test.to_numpy_2d(lazy.score)
+    assert np.allclose(score, expected @ detail.test.to_numpy_2d(lazy.coeff), atol=1e-6)
+
+    # the reference is released once the score has been computed
+    gc.collect()
+    assert a_ref() is None
+
+
+@pytest.mark.parametrize("factory", TestArguments["factory"])
+def test_fn_pca_skip_score(env, factory):
+    factory_f = factory[1]
+
+    m, n, k = 200, 30, 3
+    dataset = make_low_rank_dataset(m, n, 5)
+    testcase = factory_f(dataset, True, True, False)
+
+    result = testcase[0](testcase[1], dt.PcaControl.make(True, True, False, num_components=k, score="none"))
+    assert not result.has_score()
+    assert result.score is None
+    assert detail.test.to_numpy_2d(result.coeff).shape == (n, k)
+
+
+def test_pca_control_make_score(env):
+    ctrl = dt.PcaControl.make(economy=True, center=True, normalize=False, score="lazy")
+    assert ctrl.score == dt.PcaScore.LAZY
+
+    with pytest.raises(dt.PcaScoreNotSupportedException):
+        dt.PcaControl.make(economy=True, center=True, normalize=False, score="unknown")
+
+
+def test_pca_control_make_precision(env):
+    ctrl = dt.PcaControl.make(economy=True, center=True, normalize=False, accumulation="float64")
+    assert ctrl.accumulation == dt.PcaPrecision.FLOAT64
+    assert ctrl.result_precision == dt.PcaPrecision.INPUT
+
+    with pytest.raises(dt.PcaPrecisionNotSupportedException):
+        dt.PcaControl.make(economy=True, center=True, normalize=False, result_precision="unknown")
+
+
+@pytest.mark.parametrize("dist", [(dt.ElDist.VC, dt.ElDist.STAR), (dt.ElDist.MC, dt.ElDist.STAR)])
+@pytest.mark.parametrize("economy", TestArguments["economy"])
+@pytest.mark.parametrize("center", TestArguments["center"])
+def test_fn_pca_tall_skinny(env, dist, economy, center):
+    logging.debug('dist:       %r' % (dist,))
+    logging.debug('economy:    %r' % economy)
+    logging.debug('center:     %r' % center)
+
+    m, n = 64 * 20, 20
+    dataset = make_low_rank_dataset(m, n, n)
+
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_el = dt.MatrixDistribution.make(dist[0], dist[1], dt.ElDistWrap.ELEMENT)
+    a = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(dataset), dist_star_star_el).copy(dist_el)
+
+    # Elemental's TSQR requires a power-of-two number of processes
+    assert fn.pca_uses_tsqr(a) == (env.size & (env.size - 1) == 0)
+    assert not fn.pca_uses_tsqr(a.copy(dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)))
+
+    result = fn.pca(a, dt.PcaControl.make(economy, center, False))
+
+    mean_np = dataset.mean(axis=0) if center else np.zeros(n)
+    x_np = dataset - mean_np
+    _, s_np, vt_np = np.linalg.svd(x_np, full_matrices=False)
+
+    coeff = detail.test.to_numpy_2d(result.coeff)
+    score = detail.test.to_numpy_2d(result.score)
+    latent = detail.test.to_numpy_1d(result.latent)
+    mean = detail.test.to_numpy_1d(result.mean)
+
+    # economy-sized and full-sized results coincide for m > n
+    assert coeff.shape == (n, n)
+    assert score.shape == (m, n)
+    assert latent.shape == (n,)
+    assert np.allclose(latent, s_np**2 / (m - 1))
+    assert np.allclose(mean, mean_np)
+    # principal components are unique up to their sign
+    assert np.allclose(np.abs(coeff), np.abs(vt_np.T), atol=1e-6)
+    assert np.allclose(score, x_np @ coeff, atol=1e-6)
+
+
+@pytest.mark.parametrize("factory", TestArguments["factory"])
+@pytest.mark.parametrize("score", ["eager", "none"])
+def test_fn_pca_transform(env, factory, score):
+    factory_n = factory[0]
+    factory_f = factory[1]
+    logging.debug('factory:    %r' % factory_n)
+    logging.debug('score:      %r' % score)
+
+    m, n, k = 200, 30, 5
+    dataset = make_low_rank_dataset(m, n, k)
+    testcase = factory_f(dataset, True, True, False)
+    result = testcase[0](testcase[1], dt.PcaControl.make(True, True, False, num_components=k, score=score))
+
+    coeff = detail.test.to_numpy_2d(result.coeff)
+    mean = detail.test.to_numpy_1d(result.mean)
+
+    projected = fn.pca_transform(result, testcase[1])
+    projected_np = detail.test.to_numpy_2d(projected)
+    assert projected_np.shape == (m, k)
+    assert np.allclose(projected_np, (dataset - mean) @ coeff, atol=1e-6)
+
+    projected_2 = detail.test.to_numpy_2d(fn.pca_transform(result, testcase[1], k=2))
+    assert np.allclose(projected_2, projected_np[:, :2], atol=1e-6)
+
+    # dataset has rank k, hence it is reconstructed from all k components
+    reconstructed = detail.test.to_numpy_2d(fn.pca_inverse_transform(result, projected))
+    assert np.allclose(reconstructed, dataset, atol=1e-4)
+
+    reconstructed_2 = detail.test.to_numpy_2d(fn.pca_inverse_transform(result, projected, k=2))
+    assert np.allclose(reconstructed_2, projected_2 @ coeff[:, :2].T + mean, atol=1e-6)
+
+
+@pytest.mark.parametrize("factory", TestArguments["factory"])
+@pytest.mark.parametrize("method", ["svd", "gram", "streaming"])
+@pytest.mark.parametrize("score", ["eager", "lazy"])
+def test_fn_pca_transform_normalized(env, factory, method, score):
+    factory_n = factory[0]
+    factory_f = factory[1]
+    logging.debug('factory:    %r' % factory_n)
+    logging.debug('method:     %r' % method)
+    logging.debug('score:      %r' % score)
+
+    m, n, k = 200, 30, 5
+    dataset = make_low_rank_dataset(m, n, k)
+    testcase = factory_f(dataset, True, True, True)
+    result = testcase[0](testcase[1], dt.PcaControl.make(True, True, True, method=method, num_components=k,
+                                                         score=score))
+
+    coeff = detail.test.to_numpy_2d(result.coeff)
+    mean = detail.test.to_numpy_1d(result.mean)
+    scale = detail.test.to_numpy_1d(result.scale)
+    assert np.allclose(scale, dataset.std(axis=0, ddof=1))
+
+    # like MATLAB's, principal components of normalized data are scaled by the standard deviations
+    projected = detail.test.to_numpy_2d(fn.pca_transform(result, testcase[1]))
+    assert np.allclose(projected, detail.test.to_numpy_2d(result.score), atol=1e-6)
+    assert np.allclose(projected, ((dataset - mean) / scale**2) @ coeff, atol=1e-6)
+
+    reconstructed = detail.test.to_numpy_2d(fn.pca_inverse_transform(result, fn.pca_transform(result, testcase[1])))
+    assert np.allclose(reconstructed, dataset, atol=1e-4)
+
+    # hbrs::mpl's pca_result does not record the scaling of its principal components, hence normalized results
+    # cannot be projected and are rejected
+    plain = testcase[0](testcase[1], dt.PcaControl.make(True, True, True))
+    assert not hasattr(plain, 'scale')
+    with pytest.raises(dt.ComponentsNotOrthonormalException):
+        fn.pca_transform(plain, testcase[1])
+
+
+@pytest.mark.parametrize("method", ["randomized", "gram", "streaming"])
+@pytest.mark.parametrize("normalize", TestArguments["normalize"])
+@pytest.mark.parametrize("score", ["eager", "lazy"])
+def test_fn_pca_from_mmap(env, method, normalize, score):
+    logging.debug('method:     %r' % method)
+    logging.debug('normalize:  %r' % normalize)
+    logging.debug('score:      %r' % score)
+
+    # more rows than Elemental's default block size, hence the streaming method merges several panels
+    m, n, k = 1000, 20, 4
+    dataset = make_low_rank_dataset(m, n, k)
+
+    tmpdir = tempfile.mkdtemp()
+    try:
+        path = os.path.join(tmpdir, 'dataset.bin')
+        # raw files store entries in column-major order
+        dataset.T.tofile(path)
+        a = dt.ElMatrix.from_mmap(path, (m, n), np.float64)
+
+        ctrl = dt.PcaControl.make(True, True, normalize, method=method, num_components=k, score=score)
+        result = fn.pca(a, ctrl)
+        expected = fn.pca(dt.ElMatrix.view_from_numpy(dataset), ctrl)
+
+        coeff = detail.test.to_numpy_2d(result.coeff)
+        assert np.allclose(detail.test.to_numpy_1d(result.mean), dataset.mean(axis=0))
+        assert np.allclose(detail.test.to_numpy_1d(result.latent), detail.test.to_numpy_1d(expected.latent))
+        # principal components are unique up to their sign
+        assert np.allclose(np.abs(coeff), np.abs(detail.test.to_numpy_2d(expected.coeff)), atol=1e-6)
+
+        divisors = dataset.std(axis=0, ddof=1)**2 if normalize else 1
+        score_np = detail.test.to_numpy_2d(result.score)
+        assert np.allclose(score_np, ((dataset - dataset.mean(axis=0)) / divisors) @ coeff, atol=1e-6)
+
+        # the memory-mapped file has not been modified
+        assert np.array_equal(a.view_to_numpy(), dataset)
+        del result, a
+    finally:
+        shutil.rmtree(tmpdir)
+
+
+@pytest.mark.parametrize("method", ["svd", "randomized", "gram", "streaming"])
+@pytest.mark.parametrize("result_precision", ["input", "float64"])
+def test_fn_pca_mixed_precision(env, method, result_precision):
+    logging.debug('method:     %r' % method)
+    logging.debug('precision:  %r' % result_precision)
+
+    m, n, k = 300, 20, 4
+    dataset = make_low_rank_dataset(m, n, k)
+    dataset_f32 = np.asarray(dataset, dtype=np.float32, order='F')
+
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+    a_el = dt.ElMatrix.view_from_numpy(dataset_f32)
+    a_dist = dt.ElDistMatrix.make_view(env.grid, a_el, dist_star_star_el).copy(dist_mc_mr_el)
+
+    # reference computed from the float32 data in float64
+    x_np = np.asarray(dataset_f32, dtype=np.float64)
+    mean_np = x_np.mean(axis=0)
+    _, s_np, vt_np = np.linalg.svd(x_np - mean_np, full_matrices=False)
+
+    for a in [a_el, a_dist]:
+        ctrl = dt.PcaControl.make(True, True, False, method=method, num_components=k, accumulation="float64",
+                                  result_precision=result_precision)
+        result = fn.pca(a, ctrl)
+
+        coeff = detail.test.to_numpy_2d(result.coeff)
+        latent = detail.test.to_numpy_1d(result.latent)
+        mean = detail.test.to_numpy_1d(result.mean)
+
+        expected_dtype = np.float32 if result_precision == "input" else np.float64
+        assert coeff.dtype == expected_dtype
+        assert latent.dtype == expected_dtype
+
+        assert np.allclose(latent, s_np[:k]**2 / (m - 1), rtol=1e-5)
+        assert np.allclose(mean, mean_np, rtol=1e-6)
+        # principal components are unique up to their sign
+        assert np.allclose(np.abs(coeff), np.abs(vt_np[:k, :].T), atol=1e-4)
+
+
+def test_fn_pca_narrow_precision(env):
+    dataset = make_low_rank_dataset(100, 10, 3)
+    a = dt.ElMatrix.view_from_numpy(dataset)
+
+    # accumulating or returning float64 data in float32 is not supported
+    for ctrl in [dt.PcaControl.make(True, True, False, method="gram", accumulation="float32"),
+                 dt.PcaControl.make(True, True, False, method="gram", result_precision="float32")]:
+        with pytest.raises(dt.PcaPrecisionNotSupportedException):
+            fn.pca(a, ctrl)
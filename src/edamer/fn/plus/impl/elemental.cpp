@@ -19,28 +19,96 @@
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 
 #include "../fwd.hpp" // Make help(edamer.fn.*) show Python type names
-#include <boost/hana/at.hpp>
 #include <boost/hana/concat.hpp>
-#include <boost/hana/cartesian_product.hpp>
 #include <boost/hana/first.hpp>
 #include <boost/hana/for_each.hpp>
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 #include <boost/hana/second.hpp>
+#include <boost/throw_exception.hpp>
+#include <edamer/detail/elementwise.hpp>
+#include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
-#include <edamer/dt/expression.hpp>
-#include <edamer/dt/matrix_distribution.hpp>
-#include <edamer/fn/expand.hpp> // Make help(edamer.fn.plus) show Python type names
-#include <hbrs/mpl/dt/el_dist_matrix.hpp>
+#include <edamer/detail/simd.hpp>
 #include <hbrs/mpl/dt/el_matrix.hpp>
-#include <hbrs/mpl/dt/expression.hpp>
-#include <hbrs/mpl/fn/expand.hpp>
+#include <hbrs/mpl/dt/exception.hpp>
 #include <hbrs/mpl/fn/plus.hpp>
+#include <type_traits>
+#include <utility>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 namespace hana = boost::hana;
 namespace mpl = hbrs::mpl;
 
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+void
+check_plus_sizes(El::Int height, El::Int width, El::Int other_height, El::Int other_width) {
+	if (height != other_height || width != other_width) {
+		BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{}
+			<< mpl::errinfo_el_matrix_size{{other_height, other_width}}));
+	}
+}
+
+/* Entrywise out = a + b of local matrices, which may be the same or views of the same memory. Integers saturate like
+ * in detail::elementwise(), see detail::elementwise_plus.
+ */
+template<typename Ring>
+void
+plus_local(El::Matrix<Ring> const& a, El::Matrix<Ring> const& b, El::Matrix<Ring> & out) {
+	if (out.Height() == 0) {
+		return;
+	}
+	
+	for (El::Int j = 0; j < out.Width(); ++j) {
+		Ring const* a_j = a.LockedBuffer(0, j);
+		Ring const* b_j = b.LockedBuffer(0, j);
+		Ring * out_j = out.Buffer(0, j);
+		if constexpr (detail::is_simd_ring_v<Ring>) {
+			detail::simd_binary(detail::simd_op::plus, out.Height(), a_j, 1, b_j, 1, out_j);
+		} else {
+			for (El::Int i = 0; i < out.Height(); ++i) {
+				out_j[i] = detail::elementwise_plus{}(a_j[i], b_j[i]);
+			}
+		}
+	}
+}
+
+/* Compute a + b like hbrs::mpl::plus(), but integers saturate instead of overflowing */
+template<typename Ring>
+mpl::el_matrix<Ring>
+plus_el_matrix(mpl::el_matrix<Ring> const& a, mpl::el_matrix<Ring> const& b) {
+	check_plus_sizes(a.data().Height(), a.data().Width(), b.data().Height(), b.data().Width());
+	El::Matrix<Ring> c{a.data().Height(), a.data().Width()};
+	plus_local(a.data(), b.data(), c);
+	return mpl::el_matrix<Ring>{std::move(c)};
+}
+
+template<typename Ring>
+mpl::el_matrix<Ring>
+plus_el_matrix(mpl::el_matrix<Ring> const& a, Ring const& b) {
+	El::Matrix<Ring> c{a.data().Height(), a.data().Width()};
+	for (El::Int j = 0; j < c.Width(); ++j) {
+		Ring const* a_j = a.data().LockedBuffer(0, j);
+		Ring * c_j = c.Buffer(0, j);
+		for (El::Int i = 0; i < c.Height(); ++i) {
+			c_j[i] = detail::elementwise_plus{}(a_j[i], b);
+		}
+	}
+	return mpl::el_matrix<Ring>{std::move(c)};
+}
+
+/* Compute out = a + b in place, like numpy.add(a, b, out=out) */
+template<typename Ring>
+mpl::el_matrix<Ring> &
+plus_el_matrix_into(mpl::el_matrix<Ring> const& a, mpl::el_matrix<Ring> const& b, mpl::el_matrix<Ring> & out) {
+	check_plus_sizes(a.data().Height(), a.data().Width(), b.data().Height(), b.data().Width());
+	check_plus_sizes(a.data().Height(), a.data().Width(), out.data().Height(), out.data().Width());
+	plus_local(a.data(), b.data(), out.data());
+	return out;
+}
+
+EDAMER_NAMESPACE_END(/* unnamed */)
+
 py::module &
 pydef_impl<hbrs::mpl::detail::plus_impl_el_matrix_el_matrix>::apply(py::module & m, py::module & base) {
 	auto ring_tns = hana::concat(detail::scalars, detail::complex_scalars);
@@ -53,18 +121,43 @@ pydef_impl<hbrs::mpl::detail::plus_impl_el_matrix_el_matrix>::apply(py::module &
 		
 		m.def("plus",
 			[](el_matrix<ring_t> const& a, el_matrix<ring_t> const& b) {
-				return hbrs::mpl::plus(a, b);
+				if constexpr (std::is_integral_v<ring_t>) {
+					return plus_el_matrix(a, b);
+				} else {
+					return hbrs::mpl::plus(a, b);
+				}
 			},
 			py::arg("a"),
-			py::arg("b")
+			py::arg("b"),
+			py::call_guard<py::gil_scoped_release>()
 		);
 		
 		m.def("plus",
 			[](el_matrix<ring_t> const& a, ring_t const& b) {
-				return hbrs::mpl::plus(a, b);
+				if constexpr (std::is_integral_v<ring_t>) {
+					return plus_el_matrix(a, b);
+				} else {
+					return hbrs::mpl::plus(a, b);
+				}
 			},
 			py::arg("a"),
-			py::arg("b")
+			py::arg("b"),
+			py::call_guard<py::gil_scoped_release>()
+		);
+		
+		/* store template function pointers in variables to work around
+		 * "unresolved overloaded function type" errors with GCC9/10
+		 */
+		constexpr auto plus_into_ptr = &plus_el_matrix_into<ring_t>;
+		
+		m.def("plus",
+			plus_into_ptr,
+			py::arg("a"),
+			py::arg("b"),
+			py::arg("out"),
+			py::return_value_policy::reference,
+			py::call_guard<py::gil_scoped_release>(),
+			"Compute out = a + b in place and return out"
 		);
 	});
 	return m;
@@ -73,53 +166,21 @@ pydef_impl<hbrs::mpl::detail::plus_impl_el_matrix_el_matrix>::apply(py::module &
 py::module &
 pydef_impl<hbrs::mpl::detail::plus_impl_el_dist_matrix_expand_expr_el_dist_matrix>::\
 apply(py::module & m, py::module & base) {
-	auto ring_tns = hana::concat(detail::scalars, detail::complex_scalars);
-	
-	using namespace mpl;
-	namespace hana = boost::hana;
-	
-	hana::for_each(ring_tns, [&m](auto ring_tn) {
-		using ring_t = typename decltype(+hana::first(ring_tn))::type;
-		auto ring_n = hana::second(ring_tn);
-		
-		hana::for_each(
-			hana::cartesian_product(hana::make_tuple(el_matrix_distributions, el_matrix_distributions)),
-			[&](auto product) {
-				auto left_distribution_tn = hana::at_c<0>(product);
-				auto right_distribution_tn = hana::at_c<1>(product);
-				
-				auto left_dist_ts = hana::transform(left_distribution_tn, hana::first);
-				auto right_dist_ts = hana::transform(right_distribution_tn, hana::first);
-				
-				using left_columnwise_t = std::decay_t<decltype(hana::at_c<0>(left_dist_ts))>;
-				using left_rowwise_t = std::decay_t<decltype(hana::at_c<1>(left_dist_ts))>;
-				using left_wrapping_t = std::decay_t<decltype(hana::at_c<2>(left_dist_ts))>;
-				
-				using right_columnwise_t = std::decay_t<decltype(hana::at_c<0>(right_dist_ts))>;
-				using right_rowwise_t = std::decay_t<decltype(hana::at_c<1>(right_dist_ts))>;
-				using right_wrapping_t = std::decay_t<decltype(hana::at_c<2>(right_dist_ts))>;
-				
-				m.def("plus", [](
-					el_dist_matrix<ring_t, left_columnwise_t::value, left_rowwise_t::value, left_wrapping_t::value>
-						const& lhs,
-					mpl::expression<
-						expand_t,
-						hana::tuple<
-							el_dist_row_vector<
-								ring_t, right_columnwise_t::value, right_rowwise_t::value, right_wrapping_t::value
-							> const&,
-							matrix_size<El::Int, El::Int> const&
-						>
-					> rhs
-					) {
-						return mpl::plus(lhs, rhs);
-					},
-					py::arg("lhs"),
-					py::arg("rhs")
-				);
-			}
-		);
-	});
+	/* Distributed matrices, scalars, vectors and expand() expressions are handled by the generic elementwise engine,
+	 * e.g. plus(el_dist_matrix, expand(el_dist_row_vector, size)) is computed in a single pass over local matrices
+	 * without materializing the expanded vector. Operands which are not aligned with out are redistributed before out
+	 * is written, hence out may be one of the operands, e.g. plus(a, b, out=b).
+	 */
+	m.def("plus",
+		[](py::object const& a, py::object const& b, py::object const& out) {
+			return detail::elementwise(a, b, out, detail::elementwise_op::plus, "plus");
+		},
+		py::arg("a"),
+		py::arg("b"),
+		py::arg("out") = py::none(),
+		"Compute a + b entrywise with implicit expansion of scalars, vectors and expand() expressions, in place if out "
+		"is not None"
+	);
 	return m;
 }
 
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+from edamer import detail, dt, fn
+from mpi4py import MPI
+import numpy as np
+import pytest
+
+
+@pytest.fixture
+def env():
+    class Environment():
+        comm = MPI.COMM_WORLD
+        size = comm.Get_size()
+        rank = comm.Get_rank()
+        grid = dt.ElGrid(comm)
+    return Environment()
+
+
+def test_fn_plus_out(env):
+    rng = np.random.default_rng(0)
+    a_np = np.asarray(rng.standard_normal((30, 20)), order='F')
+    b_np = np.asarray(rng.standard_normal((30, 20)), order='F')
+
+    out_np = np.zeros((30, 20), order='F')
+    out_el = dt.ElMatrix.view_from_numpy(out_np)
+    assert fn.plus(dt.ElMatrix.view_from_numpy(a_np), dt.ElMatrix.view_from_numpy(b_np), out=out_el) is out_el
+    assert np.allclose(out_np, a_np + b_np)
+
+    # out may be one of the summands
+    acc_np = a_np.copy(order='F')
+    acc_el = dt.ElMatrix.view_from_numpy(acc_np)
+    fn.plus(acc_el, dt.ElMatrix.view_from_numpy(b_np), out=acc_el)
+    assert np.allclose(acc_np, a_np + b_np)
+
+    with pytest.raises(dt.IncompatibleMatrixException):
+        fn.plus(dt.ElMatrix.view_from_numpy(a_np), dt.ElMatrix.view_from_numpy(b_np),
+                out=dt.ElMatrix.view_from_numpy(np.zeros((20, 30), order='F')))
+
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+    a_dist = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(a_np), dist_star_star_el)
+    b_dist = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(b_np), dist_star_star_el)
+
+    # aligned matrices are added without communication, others are redistributed
+    for b in [b_dist, b_dist.copy(dist_mc_mr_el)]:
+        out_dist = a_dist.copy(dist_mc_mr_el)
+        assert fn.plus(a_dist.copy(dist_mc_mr_el), b, out=out_dist) is out_dist
+        assert np.allclose(detail.test.to_numpy_2d(out_dist), a_np + b_np)
+
+    # out may be a summand which is read after the other summand has been redistributed
+    for a in [a_dist, a_dist.copy(dist_mc_mr_el)]:
+        out_dist = b_dist.copy(dist_mc_mr_el)
+        assert fn.plus(a, out_dist, out=out_dist) is out_dist
+        assert np.allclose(detail.test.to_numpy_2d(out_dist), a_np + b_np)
+        out_dist = b_dist.copy(dist_mc_mr_el)
+        assert fn.plus(out_dist, a, out=out_dist) is out_dist
+        assert np.allclose(detail.test.to_numpy_2d(out_dist), a_np + b_np)
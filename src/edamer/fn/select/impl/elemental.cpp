@@ -27,11 +27,14 @@
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 #include <boost/hana/second.hpp>
+#include <boost/throw_exception.hpp>
+#include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
 #include <edamer/dt/expression.hpp>
 #include <edamer/dt/matrix_distribution.hpp>
 #include <hbrs/mpl/dt/el_dist_matrix.hpp>
 #include <hbrs/mpl/dt/el_matrix.hpp>
+#include <hbrs/mpl/dt/exception.hpp>
 #include <hbrs/mpl/dt/expression.hpp>
 #include <hbrs/mpl/dt/matrix_index.hpp>
 #include <hbrs/mpl/dt/matrix_size.hpp>
@@ -39,6 +42,7 @@
 #include <hbrs/mpl/fn/expand.hpp>
 #include <hbrs/mpl/fn/select.hpp>
 #include <pybind11/stl.h>
+#include <utility>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 namespace hana = boost::hana;
@@ -81,7 +85,38 @@ pydef_impl<hbrs::mpl::detail::select_impl_el_matrix>::apply(py::module & m, py::
 		);
 	});
 	
-	hana::for_each(ring_tns, [&m](auto ring_tn) {
+	// Read-only matrices, e.g. memory-mapped files, are selected as read-only views instead of being copied
+	hana::for_each(detail::scalars, [&m](auto ring_tn) {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		
+		m.def("select",
+			[](
+				mpl::el_matrix<ring_t const> const& a,
+				std::pair<
+					mpl::matrix_index<El::Int, El::Int>,
+					mpl::matrix_size<El::Int, El::Int>
+				>  const& rng
+			) {
+				auto const& [index, size] = rng;
+				// El::LockedView checks its ranges in debug builds of Elemental only
+				if (index.m() < 0 || index.n() < 0 || size.m() < 0 || size.n() < 0 ||
+					index.m() + size.m() > a.data().Height() || index.n() + size.n() > a.data().Width()) {
+					BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{}
+						<< mpl::errinfo_el_matrix_size{{a.data().Height(), a.data().Width()}}));
+				}
+				
+				El::Matrix<ring_t> view;
+				El::LockedView(view, a.data(),
+					El::IR(index.m(), index.m() + size.m()), El::IR(index.n(), index.n() + size.n()));
+				return mpl::el_matrix<ring_t const>{std::move(view)};
+			},
+			py::arg("a"),
+			py::arg("rng"),
+			py::keep_alive<0, 1>()
+		);
+	});
+	
+	detail::for_each_deferred(ring_tns, [m](auto ring_tn) mutable {
 		using ring_t = typename decltype(+hana::first(ring_tn))::type;
 		auto ring_n = hana::second(ring_tn);
 		
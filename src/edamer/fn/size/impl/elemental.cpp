@@ -26,12 +26,15 @@
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 #include <boost/hana/second.hpp>
+#include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
+#include <edamer/dt/el_abstract_dist_matrix.hpp>
 #include <edamer/dt/matrix_distribution.hpp>
 #include <hbrs/mpl/dt/el_dist_matrix.hpp>
 #include <hbrs/mpl/dt/el_matrix.hpp>
 #include <hbrs/mpl/dt/el_dist_vector.hpp>
 #include <hbrs/mpl/dt/el_vector.hpp>
+#include <hbrs/mpl/dt/matrix_size.hpp>
 #include <hbrs/mpl/fn/size.hpp>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
@@ -60,26 +63,24 @@ py::module &
 pydef_impl<hbrs::mpl::detail::size_impl_el_dist_matrix>::apply(py::module & m, py::module & base) {
 	auto ring_tns = hana::concat(detail::scalars, detail::complex_scalars);
 	
-	using hbrs::mpl::el_dist_matrix;
-	
 	hana::for_each(ring_tns, [&m](auto ring_tn) {
 		using ring_t = typename decltype(+hana::first(ring_tn))::type;
-		auto ring_n = hana::second(ring_tn);
 		
-		hana::for_each(el_matrix_distributions, [&](auto distribution_tn) {
-			auto dist_ts = hana::transform(distribution_tn, hana::first);
-			using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
-			using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
-			using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
-			
-			m.def("size",
-				[](el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value> const& a) {
-					return hbrs::mpl::size(a);
-				},
-				py::arg("a")
-			);
-		});
+		m.def("size",
+			[](el_abstract_dist_matrix<ring_t> const& a) {
+				return hbrs::mpl::matrix_size<El::Int, El::Int>{a.data().Height(), a.data().Width()};
+			},
+			py::arg("a")
+		);
 	});
+	
+	// Typed matrices are viewed as el_abstract_dist_matrix, hence overloads are not required per matrix distribution
+	m.def("size",
+		[m = py::handle{m}](detail::el_dist_matrix_object const& a) {
+			return m.attr("size")(detail::as_el_abstract_dist_matrix(a));
+		},
+		py::arg("a")
+	);
 	return m;
 }
 
@@ -117,7 +118,7 @@ _EL_VECTOR(row)
 		                                                                                                               \
 		using hbrs::mpl::el_dist_ ## vector_kind ## _vector;                                                           \
 		                                                                                                               \
-		hana::for_each(ring_tns, [&m](auto ring_tn) {                                                                  \
+		detail::for_each_deferred(ring_tns, [m](auto ring_tn) mutable {                                                \
 			using ring_t = typename decltype(+hana::first(ring_tn))::type;                                             \
 			auto ring_n = hana::second(ring_tn);                                                                       \
 			                                                                                                           \
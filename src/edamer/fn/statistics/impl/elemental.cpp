@@ -0,0 +1,186 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "elemental.hpp"
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <boost/hana/at.hpp>
+#include <boost/hana/drop_back.hpp>
+#include <boost/hana/first.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/transform.hpp>
+#include <boost/hana/tuple.hpp>
+#include <boost/hana/type.hpp>
+#include <boost/hana/second.hpp>
+#include <boost/throw_exception.hpp>
+#include <cmath>
+#include <edamer/detail/elemental.hpp>
+#include <edamer/detail/pybind11.hpp>
+#include <edamer/detail/scalar.hpp>
+#include <edamer/dt/exception.hpp>
+#include <edamer/dt/matrix_distribution.hpp>
+#include <hbrs/mpl/dt/el_dist_matrix.hpp>
+#include <hbrs/mpl/dt/el_dist_vector.hpp>
+#include <hbrs/mpl/dt/el_matrix.hpp>
+#include <hbrs/mpl/dt/el_vector.hpp>
+#include <type_traits>
+#include <utility>
+
+EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace hana = boost::hana;
+namespace mpl = hbrs::mpl;
+
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+/* Like fn.pca we support real floating-point types only */
+auto scalars = hana::drop_back(hana::make_tuple(
+	#ifdef EDAMER_ENABLE_SCALAR_FLOAT
+		EDAMER_TYPE_NAME_PAIR(float),
+	#endif // EDAMER_ENABLE_SCALAR_FLOAT
+
+	#ifdef EDAMER_ENABLE_SCALAR_DOUBLE
+		EDAMER_TYPE_NAME_PAIR(double),
+	#endif // EDAMER_ENABLE_SCALAR_DOUBLE
+
+	"SEQUENCE_TERMINATOR___REMOVED_BY_DROP_BACK"
+));
+
+void
+check_dimension(int dim) {
+	if (dim != 1 && dim != 2) {
+		BOOST_THROW_EXCEPTION((dimension_not_supported_exception{} << errinfo_dimension{dim}));
+	}
+}
+
+void
+check_normalization(int w) {
+	if (w != 0 && w != 1) {
+		BOOST_THROW_EXCEPTION((normalization_not_supported_exception{} << errinfo_normalization{w}));
+	}
+}
+
+/* Statistic f of each column (dim == 1) as row vector or of each row (dim == 2) as column vector, like MATLAB */
+template<typename Ring, typename F>
+py::object
+statistic(mpl::el_matrix<Ring> const& a, int dim, F && f) {
+	check_dimension(dim);
+	auto moments = detail::without_gil([&]() { return detail::moments_along(a.data(), dim); });
+	
+	El::Matrix<Ring> v;
+	if (dim == 1) {
+		El::Zeros(v, 1, a.data().Width());
+		detail::assign_moments(v, moments, f);
+		return py::cast(mpl::el_row_vector<Ring>{std::move(v)});
+	} else {
+		El::Zeros(v, a.data().Height(), 1);
+		detail::assign_moments(v, moments, f);
+		return py::cast(mpl::el_column_vector<Ring>{std::move(v)});
+	}
+}
+
+/* Like fn.pca's mean and latent, results are [STAR,VC] row vectors and [MD,STAR] column vectors */
+template<
+	typename Ring,
+	El::Dist Columnwise,
+	El::Dist Rowwise,
+	El::DistWrap Wrapping,
+	typename F
+>
+py::object
+statistic(mpl::el_dist_matrix<Ring, Columnwise, Rowwise, Wrapping> const& a, int dim, F && f) {
+	check_dimension(dim);
+	auto moments = detail::without_gil([&]() { return detail::moments_along(a.data(), dim); });
+	
+	if (dim == 1) {
+		El::DistMatrix<Ring, El::STAR, El::VC, Wrapping> v{a.data().Grid()};
+		El::Zeros(v, 1, a.data().Width());
+		detail::assign_moments(v, moments, f);
+		return py::cast(mpl::make_el_dist_row_vector(std::move(v)));
+	} else {
+		El::DistMatrix<Ring, El::MD, El::STAR, Wrapping> v{a.data().Grid()};
+		El::Zeros(v, a.data().Height(), 1);
+		detail::assign_moments(v, moments, f);
+		return py::cast(mpl::make_el_dist_column_vector(std::move(v)));
+	}
+}
+
+/* Register fn.mean, fn.var and fn.std for matrix type Matrix */
+template<typename Matrix>
+void
+def_statistics(py::module & m) {
+	m.def("mean",
+		[](Matrix const& a, int dim) {
+			return statistic(a, dim, [](detail::welford_moments const& o) { return o.mean; });
+		},
+		py::arg("a"),
+		py::arg("dim") = 1
+	);
+	
+	m.def("var",
+		[](Matrix const& a, int w, int dim) {
+			check_normalization(w);
+			return statistic(a, dim, [w](detail::welford_moments const& o) { return o.variance(w); });
+		},
+		py::arg("a"),
+		py::arg("w") = 0,
+		py::arg("dim") = 1
+	);
+	
+	m.def("std",
+		[](Matrix const& a, int w, int dim) {
+			check_normalization(w);
+			return statistic(a, dim, [w](detail::welford_moments const& o) { return std::sqrt(o.variance(w)); });
+		},
+		py::arg("a"),
+		py::arg("w") = 0,
+		py::arg("dim") = 1
+	);
+}
+
+EDAMER_NAMESPACE_END(/* unnamed */)
+
+py::module &
+pydef_impl<detail::statistics_impl_el_matrix>::apply(py::module & m, py::module & base) {
+	hana::for_each(scalars, [&m](auto ring_tn) {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		def_statistics<mpl::el_matrix<ring_t>>(m);
+	});
+	return m;
+}
+
+py::module &
+pydef_impl<detail::statistics_impl_el_dist_matrix>::apply(py::module & m, py::module & base) {
+	detail::for_each_deferred(scalars, [m](auto ring_tn) mutable {
+		using ring_t = typename decltype(+hana::first(ring_tn))::type;
+		
+		hana::for_each(el_matrix_distributions, [&m](auto distribution_tn) {
+			auto dist_ts = hana::transform(distribution_tn, hana::first);
+			using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
+			using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
+			using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
+			
+			def_statistics<
+				mpl::el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value>
+			>(m);
+		});
+	});
+	return m;
+}
+
+EDAMER_NAMESPACE_END(EDAMER_NAMESPACE)
+
+#endif // HBRS_MPL_ENABLE_ELEMENTAL
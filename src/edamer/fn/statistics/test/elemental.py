@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# vim:set fileformat=unix shiftwidth=4 softtabstop=4 expandtab:
+# kate: end-of-line unix; space-indent on; indent-width 4; remove-trailing-spaces modified;
+#
+# Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+
+from edamer import detail, dt, fn
+import logging
+from mpi4py import MPI
+import numpy as np  # noqa F401
+import pytest
+
+TestArguments = dict(
+    dist=[
+        (dt.ElDist.STAR, dt.ElDist.STAR),
+        (dt.ElDist.MC, dt.ElDist.MR),
+        (dt.ElDist.VC, dt.ElDist.STAR),
+        (dt.ElDist.CIRC, dt.ElDist.CIRC)
+    ],
+    dim=[1, 2],
+    w=[0, 1]
+)
+
+
+@pytest.fixture
+def env():
+    class Environment():
+        comm = MPI.COMM_WORLD
+        size = comm.Get_size()
+        rank = comm.Get_rank()
+        grid = dt.ElGrid(comm)
+    return Environment()
+
+
+def make_dataset(m, n):
+    rng = np.random.RandomState(1337)
+    # large offset to provoke cancellation in the textbook formula of the variance
+    return np.asarray(rng.standard_normal((m, n)) + 1e6, order='F')
+
+
+def make_matrices(env, dataset, dist):
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_el = dt.MatrixDistribution.make(dist[0], dist[1], dt.ElDistWrap.ELEMENT)
+    a = dt.ElMatrix.view_from_numpy(dataset)
+    return [
+        ("ElMatrix", a),
+        ("ElDistMatrix", dt.ElDistMatrix.make_view(env.grid, a, dist_star_star_el).copy(dist_el))
+    ]
+
+
+@pytest.mark.parametrize("dist", TestArguments["dist"])
+@pytest.mark.parametrize("dim", TestArguments["dim"])
+@pytest.mark.parametrize("w", TestArguments["w"])
+def test_fn_statistics(env, dist, dim, w):
+    logging.debug('dist:       %r' % (dist,))
+    logging.debug('dim:        %r' % dim)
+    logging.debug('w:          %r' % w)
+
+    m, n = 101, 7
+    dataset = make_dataset(m, n)
+
+    for name, a in make_matrices(env, dataset, dist):
+        logging.debug('matrix:     %r' % name)
+        mean = detail.test.to_numpy_1d(fn.mean(a, dim=dim))
+        var = detail.test.to_numpy_1d(fn.var(a, w, dim))
+        std = detail.test.to_numpy_1d(fn.std(a, w=w, dim=dim))
+
+        assert np.allclose(mean, dataset.mean(axis=dim - 1), rtol=0, atol=1e-8)
+        assert np.allclose(var, dataset.var(axis=dim - 1, ddof=1 - w), rtol=1e-9)
+        assert np.allclose(std, dataset.std(axis=dim - 1, ddof=1 - w), rtol=1e-9)
+
+
+def test_fn_statistics_arguments(env):
+    a = dt.ElMatrix.view_from_numpy(make_dataset(5, 3))
+
+    with pytest.raises(dt.DimensionNotSupportedException):
+        fn.mean(a, dim=3)
+
+    with pytest.raises(dt.NormalizationNotSupportedException):
+        fn.var(a, w=2)
@@ -21,12 +21,22 @@
 #include <edamer/config.hpp>
 #include <edamer/detail/pybind11.hpp>
 #include <hbrs/mpl/config.hpp>
+#include <hbrs/mpl/dt/expression/fwd.hpp>
 #include <hbrs/mpl/fn/transpose/fwd.hpp>
 
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 
+/* Lazy transpose of a matrix as returned by fn.transpose(). It is evaluated only on demand, e.g. fn.multiply() passes
+ * its operand to GEMM with TRANSPOSE orientation instead of materializing the transposed matrix.
+ */
+template<typename Matrix>
+using el_transpose_expression = hbrs::mpl::expression<hbrs::mpl::transpose_t, boost::hana::tuple<Matrix>>;
+
+template<typename Ring>
+struct el_typed_dist_matrix_view;
+
 template <>
 struct pydef_impl<hbrs::mpl::detail::transpose_impl_el_matrix>;
 
@@ -19,6 +19,7 @@
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 
 #include "../fwd.hpp" // Make help(edamer.fn.*) show Python type names
+#include <boost/format.hpp>
 #include <boost/hana/at.hpp>
 #include <boost/hana/concat.hpp>
 #include <boost/hana/first.hpp>
@@ -26,13 +27,72 @@
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/type.hpp>
 #include <boost/hana/second.hpp>
+#include <boost/throw_exception.hpp>
+#include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
+#include <edamer/dt/el_abstract_dist_matrix.hpp>
 #include <edamer/dt/matrix_distribution.hpp>
-#include <hbrs/mpl/dt/el_dist_matrix.hpp>
 #include <hbrs/mpl/dt/el_matrix.hpp>
+#include <hbrs/mpl/dt/exception.hpp>
+#include <hbrs/mpl/dt/expression.hpp>
+#include <hbrs/mpl/dt/matrix_size.hpp>
 #include <hbrs/mpl/fn/transpose.hpp>
+#include <memory>
+#include <string>
+#include <type_traits>
 
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
+namespace mpl = hbrs::mpl;
+
+EDAMER_NAMESPACE_BEGIN(/* unnamed */)
+/* Write the transpose of a into out, like numpy.transpose(a).copy() but without allocating. out must not overlap a. */
+template<typename Matrix>
+Matrix &
+transpose_into(Matrix const& a, Matrix & out) {
+	if (out.data().Height() != a.data().Width() || out.data().Width() != a.data().Height()) {
+		BOOST_THROW_EXCEPTION((hbrs::mpl::incompatible_matrix_exception{}
+			<< hbrs::mpl::errinfo_el_matrix_size{{out.data().Height(), out.data().Width()}}));
+	}
+	
+	El::Transpose(a.data(), out.data());
+	return out;
+}
+
+/* Like hbrs::mpl::transpose(), e.g. [MC,MR] is transposed to [MR,MC] which requires no communication */
+template<typename Ring>
+el_abstract_dist_matrix<Ring>
+transpose_el_abstract_dist_matrix(el_abstract_dist_matrix<Ring> const& a) {
+	auto const& a_data = a.data();
+	auto b = detail::make_el_abstract_dist_matrix<Ring>(
+		a_data.Grid(), a_data.RowDist(), a_data.ColDist(), a_data.Wrap());
+	El::Transpose(a_data, *b);
+	return el_abstract_dist_matrix<Ring>{b};
+}
+
+/* Register the lazy transpose of Operand in module dt, similar to pydef_expression(). eval(a) has to compute the
+ * transpose of the operand a. It is called with the GIL held, hence it has to release the GIL while computing.
+ */
+template<typename Operand, typename Eval>
+py::class_<el_transpose_expression<Operand>>
+pydef_transpose_expression(py::module & base, std::string const& operand_n, Eval eval) {
+	using type_t = el_transpose_expression<Operand>;
+	
+	auto m_dt = base.attr("dt").cast<py::module_>();
+	auto name = boost::format("transpose_expression<%s>") % operand_n;
+	
+	return py::class_<type_t>{m_dt, pystrip(name.str()).c_str()}
+		.def("size",
+			[](type_t & e) {
+				auto const& a = hana::at_c<0>(e.operands()).data();
+				return mpl::matrix_size<El::Int, El::Int>{a.Width(), a.Height()};
+			}
+		)
+		.def("eval",
+			[eval](type_t & e) { return eval(hana::at_c<0>(e.operands())); },
+			"Materialize the transposed matrix"
+		);
+}
+EDAMER_NAMESPACE_END(/* unnamed */)
 
 py::module &
 pydef_impl<hbrs::mpl::detail::transpose_impl_el_matrix>::apply(py::module & m, py::module & base) {
@@ -40,15 +100,39 @@ pydef_impl<hbrs::mpl::detail::transpose_impl_el_matrix>::apply(py::module & m, p
 	
 	using hbrs::mpl::el_matrix;
 	
-	hana::for_each(ring_tns, [&m](auto ring_tn) {
+	hana::for_each(ring_tns, [&m, &base](auto ring_tn) {
 		using ring_t = typename decltype(+hana::first(ring_tn))::type;
 		auto ring_n = hana::second(ring_tn);
 		
+		/* store template function pointers in variables to work around
+		 * "unresolved overloaded function type" errors with GCC9/10
+		 */
+		constexpr auto transpose_into_ptr = &transpose_into<el_matrix<ring_t>>;
+		
+		using expression_t = el_transpose_expression<el_matrix<ring_t> const&>;
+		pydef_transpose_expression<el_matrix<ring_t> const&>(
+			base,
+			(boost::format("el_matrix<%s>") % ring_n).str(),
+			[](el_matrix<ring_t> const& a) { return detail::without_gil([&a]() { return hbrs::mpl::transpose(a); }); });
+		
 		m.def("transpose",
 			[](el_matrix<ring_t> const& a) {
-				return hbrs::mpl::transpose(a);
+				return expression_t{hbrs::mpl::transpose, hana::tuple<el_matrix<ring_t> const&>{a}};
 			},
-			py::arg("a")
+			py::arg("a"),
+			py::return_value_policy::move,
+			// the expression references its operand
+			py::keep_alive<0, 1>(),
+			"Return the lazy transpose of a, call eval() on it to materialize it"
+		);
+		
+		m.def("transpose",
+			transpose_into_ptr,
+			py::arg("a"),
+			py::arg("out"),
+			py::return_value_policy::reference,
+			py::call_guard<py::gil_scoped_release>(),
+			"Write the transpose of a into out and return out"
 		);
 	});
 	return m;
@@ -58,26 +142,90 @@ py::module &
 pydef_impl<hbrs::mpl::detail::transpose_impl_el_dist_matrix>::apply(py::module & m, py::module & base) {
 	auto ring_tns = hana::concat(detail::scalars, detail::complex_scalars);
 	
-	using hbrs::mpl::el_dist_matrix;
-	
-	hana::for_each(ring_tns, [&m](auto ring_tn) {
+	hana::for_each(ring_tns, [&m, &base](auto ring_tn) {
 		using ring_t = typename decltype(+hana::first(ring_tn))::type;
 		auto ring_n = hana::second(ring_tn);
 		
-		hana::for_each(el_matrix_distributions, [&](auto distribution_tn) {
-			auto dist_ts = hana::transform(distribution_tn, hana::first);
-			using columnwise_t = std::decay_t<decltype(hana::at_c<0>(dist_ts))>;
-			using rowwise_t = std::decay_t<decltype(hana::at_c<1>(dist_ts))>;
-			using wrapping_t = std::decay_t<decltype(hana::at_c<2>(dist_ts))>;
-			
-			m.def("transpose",
-				[](el_dist_matrix<ring_t, columnwise_t::value, rowwise_t::value, wrapping_t::value> const& a) {
-					return hbrs::mpl::transpose(a);
+		/* store template function pointers in variables to work around
+		 * "unresolved overloaded function type" errors with GCC9/10
+		 */
+		constexpr auto transpose_into_ptr = &transpose_into<el_abstract_dist_matrix<ring_t>>;
+		
+		// Copies of el_abstract_dist_matrix share their matrix, hence the expressions store their operand by value
+		using expression_t = el_transpose_expression<el_abstract_dist_matrix<ring_t>>;
+		using typed_expression_t = el_transpose_expression<el_typed_dist_matrix_view<ring_t>>;
+		
+		pydef_transpose_expression<el_typed_dist_matrix_view<ring_t>>(
+			base,
+			(boost::format("el_typed_dist_matrix_view<%s>") % ring_n).str(),
+			[](el_typed_dist_matrix_view<ring_t> const& a) {
+				auto b = detail::without_gil([&a]() { return transpose_el_abstract_dist_matrix<ring_t>(a); });
+				return py::cast(std::move(b)).attr("typed")();
+			})
+			.def("abstract",
+				[](typed_expression_t const& e) {
+					el_abstract_dist_matrix<ring_t> const& a = hana::at_c<0>(e.operands());
+					return expression_t{hbrs::mpl::transpose, hana::tuple<el_abstract_dist_matrix<ring_t>>{a}};
+				},
+				"View as lazy transpose of an el_abstract_dist_matrix, whose eval() returns an el_abstract_dist_matrix"
+			);
+		
+		pydef_transpose_expression<el_abstract_dist_matrix<ring_t>>(
+			base,
+			(boost::format("el_abstract_dist_matrix<%s>") % ring_n).str(),
+			[](el_abstract_dist_matrix<ring_t> const& a) {
+				return detail::without_gil([&a]() { return transpose_el_abstract_dist_matrix<ring_t>(a); });
+			})
+			.def("typed",
+				[](expression_t const& e) {
+					el_typed_dist_matrix_view<ring_t> a{hana::at_c<0>(e.operands())};
+					return typed_expression_t{hbrs::mpl::transpose, hana::tuple<el_typed_dist_matrix_view<ring_t>>{a}};
 				},
-				py::arg("a")
+				"View as lazy transpose of a typed matrix, whose eval() returns a typed matrix of the transposed "
+				"distribution"
 			);
-		});
+		
+		m.def("transpose",
+			[](el_abstract_dist_matrix<ring_t> const& a) {
+				return expression_t{hbrs::mpl::transpose, hana::tuple<el_abstract_dist_matrix<ring_t>>{a}};
+			},
+			py::arg("a"),
+			py::keep_alive<0, 1>(),
+			"Return the lazy transpose of a, call eval() on it to materialize it"
+		);
+		
+		m.def("transpose",
+			transpose_into_ptr,
+			py::arg("a"),
+			py::arg("out"),
+			py::return_value_policy::reference,
+			py::call_guard<py::gil_scoped_release>(),
+			"Write the transpose of a into out and return out"
+		);
 	});
+	
+	/* Typed matrices are viewed as el_abstract_dist_matrix, hence overloads are not required per matrix distribution.
+	 * Their lazy transposes evaluate to typed matrices, like those of el_matrix evaluate to el_matrix.
+	 */
+	m.def("transpose",
+		[m = py::handle{m}](detail::el_dist_matrix_object const& a) {
+			py::object expression = m.attr("transpose")(detail::as_el_abstract_dist_matrix(a));
+			return py::isinstance<el_abstract_dist_matrix_tag>(a) ? expression : expression.attr("typed")();
+		},
+		py::arg("a"),
+		"Return the lazy transpose of an el_dist_matrix instance of any distribution, call eval() on it to materialize "
+		"it as el_dist_matrix of the transposed distribution, e.g. [MR,MC] for [MC,MR]"
+	);
+	
+	m.def("transpose",
+		[m = py::handle{m}](detail::el_dist_matrix_object const& a, detail::el_dist_matrix_object const& out) {
+			m.attr("transpose")(detail::as_el_abstract_dist_matrix(a), detail::as_el_abstract_dist_matrix(out));
+			return out;
+		},
+		py::arg("a"),
+		py::arg("out"),
+		"Write the transpose of an el_dist_matrix instance of any distribution into out and return out"
+	);
 	return m;
 }
 
@@ -21,8 +21,20 @@
 
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 
+#include <edamer/dt/el_abstract_dist_matrix.hpp>
+
 EDAMER_NAMESPACE_BEGIN(EDAMER_NAMESPACE)
 
+/* Typed distributed matrix of any distribution, e.g. el_dist_matrix<double,MC,MR,ELEMENT>, viewed as
+ * el_abstract_dist_matrix. Lazy transposes of it are computed like those of el_abstract_dist_matrix, but eval() returns
+ * a typed matrix again.
+ */
+template<typename Ring>
+struct el_typed_dist_matrix_view : el_abstract_dist_matrix<Ring> {
+	explicit
+	el_typed_dist_matrix_view(el_abstract_dist_matrix<Ring> const& a) : el_abstract_dist_matrix<Ring>{a} {}
+};
+
 template <>
 struct EDAMER_API pydef_impl<hbrs::mpl::detail::transpose_impl_el_matrix> {
 	static py::module &
@@ -32,12 +32,12 @@ TestArguments = dict(
             )),
         ("ElMatrix", lambda dataset:
             (
-                fn.transpose,
+                lambda a: fn.transpose(a).eval(),
                 dt.ElMatrix.view_from_numpy(np.asarray(dataset, order='F'))
             )),
         ("ElDistMatrix", lambda dataset:
             (
-                fn.transpose,
+                lambda a: fn.transpose(a).eval(),
                 dt.ElDistMatrix.make_view(
                     dt.ElGrid(MPI.COMM_WORLD),
                     dt.ElMatrix.view_from_numpy(np.asarray(dataset, order='F')),
@@ -46,6 +46,15 @@ TestArguments = dict(
                         dt.ElDist.STAR,
                         dt.ElDistWrap.ELEMENT)
                 )
+            )),
+        ("ElAbstractDistMatrix", lambda dataset:
+            (
+                lambda a: fn.transpose(a).eval().typed(),
+                dt.ElAbstractDistMatrix.make_view(
+                    dt.ElGrid(MPI.COMM_WORLD),
+                    dt.ElMatrix.view_from_numpy(np.asarray(dataset, order='F')),
+                    dt.ElDist.STAR,
+                    dt.ElDist.STAR)
             ))
     ]
 )
@@ -89,3 +98,77 @@ def test_fn_transpose_compare_results(env, dataset):
         logging.debug("comparing results for impl %s and %s" % (factory_n_i, factory_n_j))
         assert detail.test.matrix_matrix_allclose(factory_result_i,  factory_result_j)
         logging.info("comparing impl %s and %s done." % (factory_n_i, factory_n_j))
+
+
+def test_fn_transpose_out(env):
+    m, n = 30, 20
+    a_np = np.asarray(np.arange(m*n).reshape(m, n), order='F', dtype=np.float64)
+    out_np = np.zeros((n, m), order='F')
+
+    out_el = dt.ElMatrix.view_from_numpy(out_np)
+    assert fn.transpose(dt.ElMatrix.view_from_numpy(a_np), out=out_el) is out_el
+    assert np.array_equal(out_np, a_np.T)
+
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+    a_dist = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(a_np), dist_star_star_el)
+    out_dist = dt.ElDistMatrix.make_view(env.grid, dt.ElMatrix.view_from_numpy(np.zeros((n, m), order='F')),
+                                         dist_star_star_el).copy(dist_mc_mr_el)
+    assert fn.transpose(a_dist, out=out_dist) is out_dist
+    assert np.array_equal(detail.test.to_numpy_2d(out_dist), a_np.T)
+
+    with pytest.raises(dt.IncompatibleMatrixException):
+        fn.transpose(dt.ElMatrix.view_from_numpy(a_np), out=dt.ElMatrix.view_from_numpy(np.zeros((m, n), order='F')))
+
+
+def test_fn_transpose_lazy_multiply(env):
+    m, n = 30, 20
+    rng = np.random.default_rng(0)
+    a_np = np.asarray(rng.standard_normal((m, n)), order='F')
+    b_np = np.asarray(rng.standard_normal((m, n)), order='F')
+
+    a_el = dt.ElMatrix.view_from_numpy(a_np)
+    b_el = dt.ElMatrix.view_from_numpy(b_np)
+    assert fn.transpose(b_el).size().m == n
+    assert np.allclose(fn.multiply(a_el, fn.transpose(b_el)).view_to_numpy(), a_np @ b_np.T)
+    assert np.allclose(fn.multiply(fn.transpose(a_el), b_el).view_to_numpy(), a_np.T @ b_np)
+
+    out_np = np.ones((n, n), order='F')
+    fn.multiply(fn.transpose(a_el), b_el, out=dt.ElMatrix.view_from_numpy(out_np), beta=1.0)
+    assert np.allclose(out_np, a_np.T @ b_np + 1)
+
+    dist_star_star_el = dt.MatrixDistribution.make(dt.ElDist.STAR, dt.ElDist.STAR, dt.ElDistWrap.ELEMENT)
+    dist_mc_mr_el = dt.MatrixDistribution.make(dt.ElDist.MC, dt.ElDist.MR, dt.ElDistWrap.ELEMENT)
+    a_dist = dt.ElDistMatrix.make_view(env.grid, a_el, dist_star_star_el).copy(dist_mc_mr_el)
+    b_dist = dt.ElDistMatrix.make_view(env.grid, b_el, dist_star_star_el).copy(dist_mc_mr_el)
+
+    # typed matrices yield typed products, like with materialized transposes
+    product = fn.multiply(a_dist, fn.transpose(b_dist))
+    assert isinstance(product, dt.ElDistMatrix)
+    assert np.allclose(detail.test.to_numpy_2d(product), a_np @ b_np.T)
+
+    # typed matrices are transposed to typed matrices of the transposed distribution, e.g. [MC,MR] to [MR,MC]
+    a_t = fn.transpose(a_dist).eval()
+    assert isinstance(a_t, dt.ElDistMatrix)
+    assert (a_t.abstract().columnwise, a_t.abstract().rowwise) == (dt.ElDist.MR, dt.ElDist.MC)
+    assert np.array_equal(detail.test.to_numpy_2d(a_t), a_np.T)
+    assert fn.size(a_dist).m == m
+
+    # abstract matrices stay abstract, also when typed matrices are transposed as views of them
+    a_t = fn.transpose(a_dist).abstract().eval()
+    assert isinstance(a_t, dt.ElAbstractDistMatrix)
+    assert (a_t.columnwise, a_t.rowwise) == (dt.ElDist.MR, dt.ElDist.MC)
+    assert isinstance(fn.transpose(a_dist.abstract()).eval(), dt.ElAbstractDistMatrix)
+    assert isinstance(fn.transpose(a_dist.abstract()).typed().eval(), dt.ElDistMatrix)
+
+    b_t = fn.transpose(b_dist).eval()
+    product = fn.multiply(fn.transpose(a_dist), fn.transpose(b_t))
+    assert isinstance(product, dt.ElDistMatrix)
+    assert np.allclose(detail.test.to_numpy_2d(product), a_np.T @ b_np)
+
+    product = fn.multiply(fn.transpose(a_dist.abstract()), b_dist.abstract())
+    assert isinstance(product, dt.ElAbstractDistMatrix)
+    assert np.allclose(detail.test.to_numpy_2d(product.typed()), a_np.T @ b_np)
+
+    with pytest.raises(dt.IncompatibleMatrixException):
+        fn.multiply(a_el, fn.transpose(dt.ElMatrix.view_from_numpy(np.zeros((m, n+1), order='F'))))
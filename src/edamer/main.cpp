@@ -19,30 +19,37 @@
 #include <boost/hana/for_each.hpp>
 #include <boost/hana/pair.hpp>
 #include <boost/hana/second.hpp>
+#include <cstdlib>
 #include <edamer/config.hpp>
 #include <edamer/detail/log.hpp>
 #include <edamer/detail/pybind11.hpp>
 #include <edamer/detail/scalar.hpp>
 #include <edamer/detail/test.hpp>
+#include <edamer/detail/worker.hpp>
+#include <edamer/dt/el_abstract_dist_matrix.hpp>
 #include <edamer/dt/el_dist_matrix.hpp>
 #include <edamer/dt/el_dist_vector.hpp>
 #include <edamer/dt/el_grid.hpp>
 #include <edamer/dt/el_matrix.hpp>
+#include <edamer/dt/el_redistributor.hpp>
 #include <edamer/dt/el_vector.hpp>
 #include <edamer/dt/exception.hpp>
 #include <edamer/dt/expression.hpp>
+#include <edamer/dt/incremental_pca.hpp>
 #include <edamer/dt/matrix_distribution.hpp>
 #include <edamer/dt/matrix_index.hpp>
 #include <edamer/dt/matrix_size.hpp>
 #include <edamer/dt/pca_control.hpp>
 #include <edamer/dt/pca_result.hpp>
 #include <edamer/dt/range.hpp>
+#include <edamer/fn/elementwise.hpp>
 #include <edamer/fn/expand.hpp>
 #include <edamer/fn/multiply.hpp>
 #include <edamer/fn/pca.hpp>
 #include <edamer/fn/plus.hpp>
 #include <edamer/fn/select.hpp>
 #include <edamer/fn/size.hpp>
+#include <edamer/fn/statistics.hpp>
 #include <edamer/fn/transpose.hpp>
 #include <hbrs/mpl/detail/environment.hpp>
 
@@ -73,7 +80,8 @@ PYBIND11_MODULE(cpp, m) {
 				EDAMER_DETAIL_PYBIND11_PYDEFS,
 				EDAMER_DETAIL_LOG_PYDEFS,
 				EDAMER_DETAIL_SCALAR_PYDEFS,
-                EDAMER_DETAIL_TEST_PYDEFS /*, ...*/
+                EDAMER_DETAIL_TEST_PYDEFS,
+				EDAMER_DETAIL_WORKER_PYDEFS /*, ...*/
 			))),
 			hana::pair(m_dt, hana::flatten(hana::make_tuple(
 				EDAMER_DT_MATRIX_INDEX_PYDEFS,
@@ -84,19 +92,24 @@ PYBIND11_MODULE(cpp, m) {
 				EDAMER_DT_EL_MATRIX_PYDEFS,
 				EDAMER_DT_EL_VECTOR_PYDEFS,
 				EDAMER_DT_EL_GRID_PYDEFS,
+				EDAMER_DT_EL_ABSTRACT_DIST_MATRIX_PYDEFS,
+				EDAMER_DT_EL_REDISTRIBUTOR_PYDEFS,
 				EDAMER_DT_EL_DIST_MATRIX_PYDEFS,
 				EDAMER_DT_EL_DIST_VECTOR_PYDEFS,
 				EDAMER_DT_EXPRESSION_PYDEFS,
 				EDAMER_DT_PCA_CONTROL_PYDEFS,
-				EDAMER_DT_PCA_RESULT_PYDEFS /*, ...*/
+				EDAMER_DT_PCA_RESULT_PYDEFS,
+				EDAMER_DT_INCREMENTAL_PCA_PYDEFS /*, ...*/
 			))),
 			hana::pair(m_fn, hana::flatten(hana::make_tuple(
+				EDAMER_FN_ELEMENTWISE_PYDEFS,
 				EDAMER_FN_EXPAND_PYDEFS,
 				EDAMER_FN_MULTIPLY_PYDEFS,
 				EDAMER_FN_PCA_PYDEFS,
 				EDAMER_FN_PLUS_PYDEFS,
 				EDAMER_FN_SELECT_PYDEFS,
 				EDAMER_FN_SIZE_PYDEFS,
+				EDAMER_FN_STATISTICS_PYDEFS,
 				EDAMER_FN_TRANSPOSE_PYDEFS /*, ...*/
 			)))
 		),
@@ -111,4 +124,14 @@ PYBIND11_MODULE(cpp, m) {
 			);
 		}
 	);
+	
+	/* Classes and overloads for distributed matrices are registered on first use of their scalar type, see
+	 * edamer::detail::defer_pydef(). Set EDAMER_EAGER_PYDEFS to register everything at import time instead.
+	 */
+	edamer::detail::def_lazy_getattr(m_dt);
+	edamer::detail::def_lazy_getattr(m_fn);
+	
+	if (std::getenv("EDAMER_EAGER_PYDEFS") != nullptr) {
+		edamer::detail::require_all_pydefs();
+	}
 }